@@ -0,0 +1,193 @@
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "../src/utils/FileReader.h"
+
+/**
+ * Benchmark of the FileReader against the stringstream per line reader
+ * that it replaced. It writes an OBJ like file with "v x y z" and
+ * "f a b c" lines, reads it with both readers and reports their
+ * throughput. Each reader is run NUM_REPETITIONS times and the best time
+ * is reported, so the file is in the page cache for both of them.
+ *
+ * Usage: FileReaderBench [millionVertices] [path]
+ */
+namespace {
+
+	typedef std::chrono::steady_clock Clock;
+
+	/** The number of times that each reader is run */
+	const unsigned int NUM_REPETITIONS = 3;
+
+
+	/**
+	 * Class OldFileReader, the FileReader before it was memory mapped: it
+	 * reads the file line by line with a new stringstream per line
+	 */
+	class OldFileReader
+	{
+	private:	// Attributes
+		/** The file that we are currently reading */
+		std::ifstream mInputFStream;
+
+		/** The current stream line */
+		std::stringstream mCurLineStream;
+
+		/** The number of lines readed in the current file */
+		unsigned int mNumLines;
+
+	public:
+		/** Creates a new OldFileReader
+		 *
+		 * @param	path the path of the file that we are going to read */
+		OldFileReader(const std::string& path) :
+			mInputFStream(path), mNumLines(0) {};
+
+		/** @return	the number of readed lines in the current file */
+		inline unsigned int getNumLines() const { return mNumLines; };
+
+		/** Reads the next value and stores it in the given parameter
+		 *
+		 * @param	token the variables where we are going to store the
+		 *			readed value
+		 * @return	true if the value was readed and loaded succesfully,
+		 *			false otherwise */
+		template<typename T> bool getParam(T& token)
+		{
+			bool ret = true;
+
+			if (mCurLineStream.rdbuf()->in_avail() > 0) {
+				// If the current line isn't empty we parse the token
+				try {
+					mCurLineStream >> token;
+				}
+				catch (std::exception&) {
+					ret = false;
+				}
+			}
+			else if (!mInputFStream.eof()) {
+				// Read the next lines recursively until we find a not
+				// empty line
+				std::string stringLine;
+				std::getline(mInputFStream, stringLine);
+				mCurLineStream = std::stringstream(stringLine);
+				++mNumLines;
+
+				ret = getParam(token);
+			}
+			else {
+				ret = false;
+			}
+
+			return ret;
+		};
+	};
+
+
+	/** Writes the OBJ like file that is read by the readers: a grid
+	 * of vertices with random heights and two faces per vertex
+	 *
+	 * @return	the size of the file in bytes */
+	std::size_t writeFile(const std::string& path, unsigned int numVertices)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		const unsigned int gridSize = 1024;
+
+		char line[128];
+		for (unsigned int i = 0; i < numVertices; ++i) {
+			int length = std::snprintf(
+				line, sizeof(line), "v %.6f %.6f %.6f\n",
+				(i % gridSize) * 0.01f, std::rand() / static_cast<float>(RAND_MAX), (i / gridSize) * -0.01f
+			);
+			file.write(line, length);
+		}
+		for (unsigned int i = 0; i < 2 * numVertices; ++i) {
+			unsigned int v = 1 + i / 2 % (numVertices - gridSize - 1);
+			int length = (i % 2 == 0)?
+				std::snprintf(line, sizeof(line), "f %u %u %u\n", v, v + gridSize, v + 1) :
+				std::snprintf(line, sizeof(line), "f %u %u %u\n", v + 1, v + gridSize, v + gridSize + 1);
+			file.write(line, length);
+		}
+
+		return static_cast<std::size_t>(file.tellp());
+	}
+
+
+	/** Reads all the lines of the file with the given Reader, adding the
+	 * values of the vertices and faces
+	 *
+	 * @return	the sum of all the values */
+	template <typename Reader>
+	double readFile(Reader& reader)
+	{
+		double sum = 0.0;
+		std::string keyword;
+		while (reader.getParam(keyword)) {
+			if (keyword == "v") {
+				float x, y, z;
+				reader.getParam(x);	reader.getParam(y);	reader.getParam(z);
+				sum += x + y + z;
+			}
+			else if (keyword == "f") {
+				unsigned int a, b, c;
+				reader.getParam(a);	reader.getParam(b);	reader.getParam(c);
+				sum += a + b + c;
+			}
+		}
+
+		return sum;
+	}
+
+
+	/** Reads the file NUM_REPETITIONS times with the given Reader
+	 *
+	 * @param	sum where the sum of the values of the file will be
+	 *			stored
+	 * @return	the best time in seconds */
+	template <typename Reader>
+	double bench(const std::string& path, double& sum)
+	{
+		double best = 1e30;
+		for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+			auto start = Clock::now();
+			Reader reader(path);
+			sum = readFile(reader);
+			best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+		}
+
+		return best;
+	}
+
+}
+
+
+int main(int argc, char** argv)
+{
+	double millionVertices = (argc > 1)? std::atof(argv[1]) : 1.0;
+	std::string path = (argc > 2)? argv[2] : "FileReaderBench.obj";
+
+	unsigned int numVertices = std::max(static_cast<unsigned int>(millionVertices * 1e6), 4096u);
+	std::size_t size = writeFile(path, numVertices);
+	std::printf(
+		"%u vertices and %u faces, %.1f MB, best of %u repetitions\n\n",
+		numVertices, 2 * numVertices, size / 1e6, NUM_REPETITIONS
+	);
+
+	double oldSum, newSum;
+	double oldTime = bench<OldFileReader>(path, oldSum);
+	double newTime = bench<FileReader>(path, newSum);
+	std::remove(path.c_str());
+
+	std::printf("stringstream reader  %8.3f s %8.3f GB/s\n", oldTime, size / (1e9 * oldTime));
+	std::printf("FileReader           %8.3f s %8.3f GB/s %8.2fx\n", newTime, size / (1e9 * newTime), oldTime / newTime);
+
+	double difference = std::abs(oldSum - newSum) / std::max(std::abs(oldSum), 1.0);
+	std::printf("\nrelative difference between the sums of the values: %g\n", difference);
+
+	return (difference < 1e-9)? 0 : 1;
+}
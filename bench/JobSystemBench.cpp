@@ -0,0 +1,175 @@
+#include <chrono>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include "../src/utils/JobSystem.h"
+
+/**
+ * Micro-benchmark of the scheduling overhead of the JobSystem. The Jobs
+ * are empty or almost empty, so the measured times are the cost of
+ * submitting, queueing, stealing and completing them. Each case is
+ * repeated NUM_REPETITIONS times and the best time is reported.
+ *
+ * Usage: JobSystemBench [numWorkers]
+ */
+namespace {
+
+	typedef std::chrono::steady_clock Clock;
+
+	/** The number of times that each case is repeated */
+	const unsigned int NUM_REPETITIONS = 5;
+
+	/** Accumulates the results of the Jobs so their work isn't
+	 * optimized away */
+	std::atomic<unsigned long long> gSink(0);
+
+
+	/** @return	the nanoseconds elapsed since the given time */
+	double getElapsedNs(Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	}
+
+
+	/** Submits numJobs empty Jobs from the current thread and waits for
+	 * all of them
+	 *
+	 * @return	the best time per Job in nanoseconds */
+	double benchRunWait(JobSystem& jobSystem, unsigned int numJobs)
+	{
+		double best = 1e30;
+		for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+			auto start = Clock::now();
+
+			JobSystem::Counter counter;
+			for (unsigned int i = 0; i < numJobs; ++i) {
+				jobSystem.run([]() {}, &counter);
+			}
+			jobSystem.wait(counter);
+
+			best = std::min(best, getElapsedNs(start) / numJobs);
+		}
+
+		return best;
+	}
+
+
+	/** Submits a single empty Job and waits for it, numIterations
+	 * times, so there is never more than one Job in flight
+	 *
+	 * @return	the best time per round trip in nanoseconds */
+	double benchRoundTrip(JobSystem& jobSystem, unsigned int numIterations)
+	{
+		double best = 1e30;
+		for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+			auto start = Clock::now();
+
+			for (unsigned int i = 0; i < numIterations; ++i) {
+				JobSystem::Counter counter;
+				jobSystem.run([]() {}, &counter);
+				jobSystem.wait(counter);
+			}
+
+			best = std::min(best, getElapsedNs(start) / numIterations);
+		}
+
+		return best;
+	}
+
+
+	/** Submits a Job that submits numJobs empty Jobs to the queue of the
+	 * worker that runs it, so the rest of the workers have to steal them
+	 *
+	 * @param	numSteals where the number of steals of the best
+	 *			repetition will be stored
+	 * @return	the best time per Job in nanoseconds */
+	double benchSteals(JobSystem& jobSystem, unsigned int numJobs, unsigned int& numSteals)
+	{
+		double best = 1e30;
+		for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+			unsigned int initialSteals = jobSystem.getNumSteals();
+			auto start = Clock::now();
+
+			JobSystem::Counter rootCounter;
+			jobSystem.run([&jobSystem, numJobs]() {
+				JobSystem::Counter counter;
+				for (unsigned int i = 0; i < numJobs; ++i) {
+					jobSystem.run([]() {}, &counter);
+				}
+				jobSystem.wait(counter);
+			}, &rootCounter);
+			jobSystem.wait(rootCounter);
+
+			double time = getElapsedNs(start) / numJobs;
+			if (time < best) {
+				best = time;
+				numSteals = jobSystem.getNumSteals() - initialSteals;
+			}
+		}
+
+		return best;
+	}
+
+
+	/** Calls parallelFor over numIndices indices with the given grain
+	 * size, adding the indices of each range
+	 *
+	 * @return	the best time per range in nanoseconds */
+	double benchParallelFor(JobSystem& jobSystem, unsigned int numIndices, unsigned int grainSize)
+	{
+		const unsigned int numRanges = (numIndices + grainSize - 1) / grainSize;
+
+		double best = 1e30;
+		for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+			auto start = Clock::now();
+
+			jobSystem.parallelFor(0, numIndices, grainSize, [](unsigned int first, unsigned int last) {
+				unsigned long long sum = 0;
+				for (unsigned int i = first; i < last; ++i) {
+					sum += i;
+				}
+				gSink.fetch_add(sum, std::memory_order_relaxed);
+			});
+
+			best = std::min(best, getElapsedNs(start) / numRanges);
+		}
+
+		return best;
+	}
+
+}
+
+
+int main(int argc, char** argv)
+{
+	unsigned int numWorkers = (argc > 1)? std::atoi(argv[1]) : 0;
+	JobSystem jobSystem(numWorkers);
+	std::printf("JobSystem with %u workers, best of %u repetitions\n\n", jobSystem.getNumWorkers(), NUM_REPETITIONS);
+
+	const unsigned int numJobs = 200000;
+	std::printf("run+wait       %8u jobs    %10.1f ns/job\n", numJobs, benchRunWait(jobSystem, numJobs));
+
+	const unsigned int numIterations = 20000;
+	std::printf("round trip     %8u jobs    %10.1f ns/job\n", numIterations, benchRoundTrip(jobSystem, numIterations));
+
+	unsigned int numSteals = 0;
+	double stealTime = benchSteals(jobSystem, numJobs, numSteals);
+	std::printf(
+		"steals         %8u jobs    %10.1f ns/job    %u steals (%.1f%%)\n",
+		numJobs, stealTime, numSteals, 100.0 * numSteals / numJobs
+	);
+
+	std::printf("\n");
+	const unsigned int numIndices = 1 << 22;
+	const unsigned int grainSizes[] = { 64, 256, 1024, 4096, 16384, 65536 };
+	for (unsigned int grainSize : grainSizes) {
+		double rangeTime = benchParallelFor(jobSystem, numIndices, grainSize);
+		std::printf(
+			"parallelFor    grain %6u    %10.1f ns/range  %8.3f ns/index\n",
+			grainSize, rangeTime, rangeTime / grainSize
+		);
+	}
+
+	return (gSink > 0)? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#include <cmath>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "../src/utils/JobSystem.h"
+#include "../src/loaders/NormalGenerator.h"
+
+using namespace graphics;
+
+/**
+ * Benchmark of the NormalGenerator against the scalar loop that the
+ * MeshLoader used before. The Mesh is a wavy grid of GRID_SIZE x
+ * GRID_SIZE vertices, the most that can be indexed with GLushort, whose
+ * indices are repeated until the Mesh has the given number of millions
+ * of triangles. Each case is repeated NUM_REPETITIONS times and the best
+ * time is reported.
+ *
+ * Usage: NormalsBench [millionTriangles] [numWorkers]
+ */
+namespace {
+
+	typedef std::chrono::steady_clock Clock;
+
+	/** The number of vertices of each side of the grid */
+	const unsigned int GRID_SIZE = 256;
+
+	/** The number of times that each case is repeated */
+	const unsigned int NUM_REPETITIONS = 5;
+
+
+	/** Creates the positions and uvs of the vertices of the grid */
+	void createGrid(std::vector<GLfloat>& positions, std::vector<GLfloat>& uvs)
+	{
+		for (unsigned int z = 0; z < GRID_SIZE; ++z) {
+			for (unsigned int x = 0; x < GRID_SIZE; ++x) {
+				positions.push_back(static_cast<float>(x));
+				positions.push_back(std::sin(0.1f * x) * std::cos(0.13f * z));
+				positions.push_back(static_cast<float>(z));
+				uvs.push_back(x / (GRID_SIZE - 1.0f));
+				uvs.push_back(z / (GRID_SIZE - 1.0f));
+			}
+		}
+	}
+
+
+	/** Creates the indices of the grid repeated until there are at
+	 * least numTriangles triangles */
+	std::vector<GLushort> createIndices(unsigned int numTriangles)
+	{
+		std::vector<GLushort> grid;
+		for (unsigned int z = 0; z + 1 < GRID_SIZE; ++z) {
+			for (unsigned int x = 0; x + 1 < GRID_SIZE; ++x) {
+				GLushort i0 = z * GRID_SIZE + x, i1 = i0 + 1, i2 = i0 + GRID_SIZE, i3 = i2 + 1;
+				grid.insert(grid.end(), { i0, i2, i1, i1, i2, i3 });
+			}
+		}
+
+		std::vector<GLushort> indices;
+		indices.reserve(3 * numTriangles + grid.size());
+		while (indices.size() < 3 * numTriangles) {
+			indices.insert(indices.end(), grid.begin(), grid.end());
+		}
+
+		return indices;
+	}
+
+
+	/** The normal calculation of the MeshLoader before the
+	 * NormalGenerator, with the second edge reading v2_z instead of
+	 * v1_z */
+	std::vector<GLfloat> calculateNormalsScalar(
+		const std::vector<GLfloat>& positions,
+		const std::vector<GLushort>& faceIndices
+	) {
+		std::vector<GLfloat> normals(positions.size(), 0);
+
+		// Sum to the normal of every vertex, the normal of the faces
+		// which it belongs
+		for (unsigned int i = 0; i < faceIndices.size(); i+=3) {
+			// Get the normal of triangle
+			GLfloat v1_x = positions[3 * faceIndices[i]]		- positions[3 * faceIndices[i+1]];
+			GLfloat v1_y = positions[3 * faceIndices[i] + 1]	- positions[3 * faceIndices[i+1] + 1];
+			GLfloat v1_z = positions[3 * faceIndices[i] + 2]	- positions[3 * faceIndices[i+1] + 2];
+			glm::vec3 v1(v1_x, v1_y, v1_z);
+
+			GLfloat v2_x = positions[3 * faceIndices[i]]		- positions[3 * faceIndices[i+2]];
+			GLfloat v2_y = positions[3 * faceIndices[i] + 1]	- positions[3 * faceIndices[i+2] + 1];
+			GLfloat v2_z = positions[3 * faceIndices[i] + 2]	- positions[3 * faceIndices[i+2] + 2];
+			glm::vec3 v2(v2_x, v2_y, v2_z);
+
+			glm::vec3 normal = glm::cross(v1, v2);
+
+			normals[3 * faceIndices[i]]			+= normal.x;
+			normals[3 * faceIndices[i] + 1]		+= normal.y;
+			normals[3 * faceIndices[i] + 2]		+= normal.z;
+
+			normals[3 * faceIndices[i+1]]		+= normal.x;
+			normals[3 * faceIndices[i+1] + 1]	+= normal.y;
+			normals[3 * faceIndices[i+1] + 2]	+= normal.z;
+
+			normals[3 * faceIndices[i+2]]		+= normal.x;
+			normals[3 * faceIndices[i+2] + 1]	+= normal.y;
+			normals[3 * faceIndices[i+2] + 2]	+= normal.z;
+		}
+
+		// Normalize the normal vector of every vertex
+		for (unsigned int i = 0; i < normals.size(); i+=3) {
+			GLfloat length	= sqrt( pow(normals[i], 2) + pow(normals[i+1], 2) + pow(normals[i+2], 2) );
+			normals[i]		/= length;
+			normals[i+1]	/= length;
+			normals[i+2]	/= length;
+		}
+
+		return normals;
+	}
+
+
+	/** Calls the given function NUM_REPETITIONS times
+	 *
+	 * @param	result where the result of the last call will be stored
+	 * @return	the best time in milliseconds */
+	template <typename F>
+	double bench(F function, std::vector<GLfloat>& result)
+	{
+		double best = 1e30;
+		for (unsigned int r = 0; r < NUM_REPETITIONS; ++r) {
+			auto start = Clock::now();
+			result = function();
+			best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		}
+
+		return best;
+	}
+
+
+	/** @return	the maximum difference between the components of a and
+	 *			b */
+	float getMaxDifference(const std::vector<GLfloat>& a, const std::vector<GLfloat>& b)
+	{
+		float difference = 0.0f;
+		for (unsigned int i = 0; i < a.size(); ++i) {
+			difference = std::max(difference, std::fabs(a[i] - b[i]));
+		}
+
+		return difference;
+	}
+
+}
+
+
+int main(int argc, char** argv)
+{
+	double millionTriangles = (argc > 1)? std::atof(argv[1]) : 4.0;
+	unsigned int numWorkers = (argc > 2)? std::atoi(argv[2]) : 0;
+
+	std::vector<GLfloat> positions, uvs;
+	createGrid(positions, uvs);
+	std::vector<GLushort> indices = createIndices(static_cast<unsigned int>(millionTriangles * 1e6));
+	const unsigned int numTriangles = indices.size() / 3;
+
+	JobSystem jobSystem(numWorkers);
+	NormalGenerator generator(jobSystem);
+	std::printf(
+		"%u triangles, %u vertices, %u workers, best of %u repetitions\n\n",
+		numTriangles, GRID_SIZE * GRID_SIZE, jobSystem.getNumWorkers(), NUM_REPETITIONS
+	);
+
+	std::vector<GLfloat> scalarNormals, areaNormals, angleNormals, tangents;
+	double scalarTime = bench([&]() { return calculateNormalsScalar(positions, indices); }, scalarNormals);
+	double areaTime = bench([&]() {
+		return generator.calculateNormals(positions, indices, NormalGenerator::AREA_WEIGHT);
+	}, areaNormals);
+	double angleTime = bench([&]() {
+		return generator.calculateNormals(positions, indices, NormalGenerator::ANGLE_WEIGHT);
+	}, angleNormals);
+	double tangentTime = bench([&]() {
+		return generator.calculateTangents(positions, areaNormals, uvs, indices);
+	}, tangents);
+
+	auto print = [numTriangles, scalarTime](const char* name, double time) {
+		std::printf(
+			"%-24s %10.2f ms %10.1f Mtris/s %8.2fx\n",
+			name, time, numTriangles / (1e3 * time), scalarTime / time
+		);
+	};
+	print("scalar normals", scalarTime);
+	print("area weighted normals", areaTime);
+	print("angle weighted normals", angleTime);
+	print("tangents", tangentTime);
+
+	float difference = getMaxDifference(scalarNormals, areaNormals);
+	std::printf("\nmax difference between the scalar and area weighted normals: %g\n", difference);
+
+	return (difference < 1e-3f)? 0 : 1;
+}
@@ -0,0 +1,198 @@
+#version 330 core
+
+// ____ CONSTANTS ____
+// MAX_POINT_LIGHTS, MAX_SPOT_LIGHTS and MAX_MATERIALS are defined by the
+// DeferredRenderer
+
+const int NO_LIGHT = 0;
+const int POINT_LIGHT = 1;
+const int SPOT_LIGHT = 2;
+
+
+// ____ DATATYPES ____
+struct Material
+{
+	vec3	mAmbientColor;
+	vec3	mDiffuseColor;
+	vec3	mSpecularColor;
+	float	mShininess;
+};
+
+struct PointLight
+{
+	vec3	mPosition;
+	float	mAmbientIntensity;
+	float	mIntensity;
+	float	mConstant;
+	float	mLinear;
+	float	mExponential;
+};
+
+struct SpotLight
+{
+	vec3	mPosition;
+	float	mAmbientIntensity;
+	vec3	mDirection;
+	float	mCosCutoff;
+	float	mIntensity;
+	float	mConstant;
+	float	mLinear;
+	float	mExponential;
+};
+
+struct SurfaceData
+{
+	vec3		mPosition;
+	vec3		mNormal;
+	vec3		mDiffuseColor;
+	Material	mMaterial;
+};
+
+
+// ____ GLOBAL VARIABLES ____
+// Uniform variables
+layout (std140) uniform MaterialBlock
+{
+	Material u_Materials[MAX_MATERIALS];
+};
+
+layout (std140) uniform LightBlock
+{
+	PointLight u_PointLights[MAX_POINT_LIGHTS];			// PointLights in world space
+	SpotLight u_SpotLights[MAX_SPOT_LIGHTS];			// SpotLights in world space
+};
+
+uniform mat4		u_ViewMatrix;						// World space to View space Matrix
+uniform int			u_LightType;						// Type of the light to draw
+uniform int			u_LightIndex;						// Index of the light in its array
+uniform sampler2D	u_PositionTexture;					// GBuffer position in view space
+uniform sampler2D	u_DiffuseTexture;					// GBuffer diffuse color
+uniform sampler2D	u_NormalTexture;					// GBuffer normal in view space
+uniform sampler2D	u_TexCoordTexture;					// GBuffer UV Coords and Material index
+uniform sampler2D	u_DepthTexture;						// GBuffer depth
+
+// Output data
+out vec4 gl_FragColor;
+
+
+// ____ FUNCTION DEFINITIONS ____
+vec3 calcPhongReflection(SurfaceData surface, float ambientIntensity, float intensity, vec3 lightDirection, vec3 viewDirection)
+{
+	// Calculate the ambient color
+	vec3 ambientColor	= surface.mMaterial.mAmbientColor * ambientIntensity;
+
+	// Calculate the diffuse color
+	vec3 diffuseColor	= vec3(0.0f);
+	float diffuseAngle	= dot(lightDirection, surface.mNormal);
+	if (diffuseAngle > 0) {
+		diffuseColor	= surface.mDiffuseColor * diffuseAngle;
+	}
+
+	// Calculate the specular color
+	vec3 specularColor	= vec3(0.0f);
+	vec3 lightReflect	= normalize(reflect(lightDirection, surface.mNormal));
+	float specularAngle	= dot(viewDirection, lightReflect);
+	if (specularAngle > 0) {
+		specularColor	= surface.mMaterial.mSpecularColor * pow(specularAngle, surface.mMaterial.mShininess);
+	}
+
+	// Add all the light colors and return
+	return ambientColor + intensity * (diffuseColor + specularColor);
+}
+
+
+vec3 calcAttenuatedLight(
+	SurfaceData surface, vec3 lightPosition,
+	float ambientIntensity, float intensity,
+	float constant, float linear, float exponential
+) {
+	// Calculate the view direction (the eye is in the center of the scene)
+	vec3 viewDirection	= normalize(-surface.mPosition);
+
+	// Calculate the light direction and distance from the current point
+	vec3 lightDirection	= lightPosition - surface.mPosition;
+	float distance		= length(lightDirection);
+	lightDirection		= normalize(lightDirection);
+
+	// Calculate the direct lighting of the current light with the Phong
+	// reflection model
+	vec3 lightColor		= calcPhongReflection(surface, ambientIntensity, intensity, lightDirection, viewDirection);
+
+	// Calculate the attenuation of the light
+	float attenuation	= constant + linear * distance + exponential * pow(distance, 2);
+
+	// Apply the attenuation to the light color and return it
+	return lightColor / attenuation;
+}
+
+
+vec3 calcPointLight(SurfaceData surface, PointLight pointLight)
+{
+	// Calculate the light position in view space
+	vec3 lightPosition	= (u_ViewMatrix * vec4(pointLight.mPosition, 1.0f)).xyz;
+
+	return calcAttenuatedLight(
+		surface, lightPosition,
+		pointLight.mAmbientIntensity, pointLight.mIntensity,
+		pointLight.mConstant, pointLight.mLinear, pointLight.mExponential
+	);
+}
+
+
+vec3 calcSpotLight(SurfaceData surface, SpotLight spotLight)
+{
+	// Calculate the light position and direction in view space
+	vec3 lightPosition	= (u_ViewMatrix * vec4(spotLight.mPosition, 1.0f)).xyz;
+	vec3 spotDirection	= normalize(mat3(u_ViewMatrix) * spotLight.mDirection);
+
+	// Discard the points outside the cone of the light
+	float spotFactor	= dot(normalize(surface.mPosition - lightPosition), spotDirection);
+	if (spotFactor <= spotLight.mCosCutoff) {
+		return vec3(0.0f);
+	}
+
+	vec3 lightColor		= calcAttenuatedLight(
+		surface, lightPosition,
+		spotLight.mAmbientIntensity, spotLight.mIntensity,
+		spotLight.mConstant, spotLight.mLinear, spotLight.mExponential
+	);
+
+	// Fade the light towards the border of the cone
+	return lightColor * (1.0f - (1.0f - spotFactor) / (1.0f - spotLight.mCosCutoff));
+}
+
+
+// ____ MAIN PROGRAM ____
+void main()
+{
+	ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+	// Skip the pixels without geometry
+	vec3 normal = texelFetch(u_NormalTexture, pixel, 0).xyz;
+	if (normal == vec3(0.0f)) {
+		discard;
+	}
+
+	if (u_LightType == NO_LIGHT) {
+		// Copy the depth and clear the color of the pixel
+		gl_FragDepth = texelFetch(u_DepthTexture, pixel, 0).r;
+		gl_FragColor = vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		return;
+	}
+
+	SurfaceData surface;
+	surface.mPosition		= texelFetch(u_PositionTexture, pixel, 0).xyz;
+	surface.mNormal			= normal;
+	surface.mDiffuseColor	= texelFetch(u_DiffuseTexture, pixel, 0).rgb;
+	surface.mMaterial		= u_Materials[int(texelFetch(u_TexCoordTexture, pixel, 0).z)];
+
+	vec3 lightColor;
+	if (u_LightType == POINT_LIGHT) {
+		lightColor = calcPointLight(surface, u_PointLights[u_LightIndex]);
+	}
+	else {
+		lightColor = calcSpotLight(surface, u_SpotLights[u_LightIndex]);
+	}
+
+	gl_FragColor = vec4(lightColor, 1.0f);
+}
@@ -0,0 +1,10 @@
+#version 330 core
+
+// Input data
+layout (location = 0) in vec2 a_VertexPosition;		// Position attribute
+
+// Functions
+void main()
+{
+	gl_Position = vec4(a_VertexPosition, 0.0f, 1.0f);
+}
@@ -0,0 +1,55 @@
+#version 330 core
+
+// ____ CONSTANTS ____
+// MAX_MATERIALS is defined by the DeferredRenderer, and TEXTURED in the
+// variant used for the Renderable3Ds with a Texture
+
+
+// ____ DATATYPES ____
+struct Material
+{
+	vec3	mAmbientColor;
+	vec3	mDiffuseColor;
+	vec3	mSpecularColor;
+	float	mShininess;
+};
+
+
+// ____ GLOBAL VARIABLES ____
+// Input data in view space from the vertex shader
+in VertexData {
+	vec3 mPosition;
+	vec3 mNormal;
+	vec2 mUV;
+} vs_Vertex;
+
+flat in int vs_MaterialIndex;
+
+// Uniform variables
+layout (std140) uniform MaterialBlock
+{
+	Material u_Materials[MAX_MATERIALS];
+};
+
+uniform sampler2D u_DiffuseTexture;						// Texture of the Renderable3D
+
+// Output data, the alpha is 1 so the transparent Renderable3Ds are drawn
+// as opaque ones
+layout (location = 0) out vec4 gb_Position;				// Position in view space
+layout (location = 1) out vec4 gb_Diffuse;				// Diffuse color
+layout (location = 2) out vec4 gb_Normal;				// Normal in view space
+layout (location = 3) out vec4 gb_TexCoord;				// UV Coords and Material index
+
+
+// ____ MAIN PROGRAM ____
+void main()
+{
+	gb_Position	= vec4(vs_Vertex.mPosition, 1.0f);
+#ifdef TEXTURED
+	gb_Diffuse	= vec4(texture(u_DiffuseTexture, vs_Vertex.mUV).rgb * u_Materials[vs_MaterialIndex].mDiffuseColor, 1.0f);
+#else
+	gb_Diffuse	= vec4(u_Materials[vs_MaterialIndex].mDiffuseColor, 1.0f);
+#endif
+	gb_Normal	= vec4(normalize(vs_Vertex.mNormal), 1.0f);
+	gb_TexCoord	= vec4(vs_Vertex.mUV, float(vs_MaterialIndex), 1.0f);
+}
@@ -0,0 +1,54 @@
+#version 330 core
+
+// ____ CONSTANTS ____
+// MAX_OBJECTS is defined by the DeferredRenderer
+
+
+// ____ DATATYPES ____
+struct ObjectData
+{
+	mat4	mModelViewMatrix;
+	mat3	mNormalMatrix;
+	int		mMaterialIndex;
+};
+
+
+// ____ GLOBAL VARIABLES ____
+// Input data
+layout (location = 0) in vec3 a_VertexPosition;			// Position attribute
+layout (location = 1) in vec3 a_VertexNormal;			// Normal attribute
+layout (location = 2) in vec2 a_VertexUV;				// Vertex UV Coords attribute
+layout (location = 5) in uint a_ObjectIndex;			// Instance index plus base instance
+
+// Uniform variables
+layout (std140) uniform ObjectBlock
+{
+	ObjectData u_Objects[MAX_OBJECTS];					// Per instance data
+};
+
+uniform mat4 u_ProjectionMatrix;						// View space to Perspective space Matrix
+
+// Output data in view space
+out VertexData {
+	vec3 mPosition;
+	vec3 mNormal;
+	vec2 mUV;
+} vs_Vertex;
+
+flat out int vs_MaterialIndex;
+
+
+// Functions
+void main()
+{
+	int objectIndex			= int(a_ObjectIndex);
+	mat4 modelViewMatrix	= u_Objects[objectIndex].mModelViewMatrix;
+	vec4 vertexView			= modelViewMatrix * vec4(a_VertexPosition, 1.0f);
+	gl_Position				= u_ProjectionMatrix * vertexView;
+
+	// Calculate the Vertex data for the fragment shader in view space
+	vs_Vertex.mPosition		= vertexView.xyz;
+	vs_Vertex.mNormal		= normalize(u_Objects[objectIndex].mNormalMatrix * a_VertexNormal);
+	vs_Vertex.mUV			= a_VertexUV;
+	vs_MaterialIndex		= u_Objects[objectIndex].mMaterialIndex;
+}
@@ -1,7 +1,9 @@
 #version 330 core
 
 // ____ CONSTANTS ____
-const int MAX_POINT_LIGHTS = 4;
+// MAX_POINT_LIGHTS, MAX_SPOT_LIGHTS, CLUSTER_GRID_SIZE and MAX_MATERIALS
+// are defined by the SceneProgram, with the features of the variant:
+// TEXTURED, POINT_LIGHTS and SPOT_LIGHTS
 
 
 // ____ DATATYPES ____
@@ -11,26 +13,28 @@ struct Material
 	vec3	mDiffuseColor;
 	vec3	mSpecularColor;
 	float	mShininess;
-	float	mTransparency;
 };
 
-struct BaseLight
+struct PointLight
 {
+	vec3	mPosition;
 	float	mAmbientIntensity;
 	float	mIntensity;
-};
-
-struct Attenuation
-{
 	float	mConstant;
 	float	mLinear;
 	float	mExponential;
 };
 
-struct PointLight
+struct SpotLight
 {
-	BaseLight	mBaseLight;
-	Attenuation mAttenuation;
+	vec3	mPosition;
+	float	mAmbientIntensity;
+	vec3	mDirection;
+	float	mCosCutoff;
+	float	mIntensity;
+	float	mConstant;
+	float	mLinear;
+	float	mExponential;
 };
 
 
@@ -42,13 +46,26 @@ in VertexData {
 	vec2 mUV;
 } vs_Vertex;
 
-flat in int vs_NumPointLights;
-in vec3 vs_PointLightsPositions[MAX_POINT_LIGHTS];
+flat in int vs_MaterialIndex;
 
 // Uniform variables
-uniform Material	u_Material;
+layout (std140) uniform MaterialBlock
+{
+	Material u_Materials[MAX_MATERIALS];
+};
+
+layout (std140) uniform LightBlock
+{
+	PointLight u_PointLights[MAX_POINT_LIGHTS];			// PointLights in world space
+	SpotLight u_SpotLights[MAX_SPOT_LIGHTS];			// SpotLights in world space
+};
+
+uniform mat4		u_ViewMatrix;						// World space to View space Matrix
+uniform mat4		u_ProjectionMatrix;					// View space to Perspective space Matrix
+uniform vec2		u_ClusterZParams;					// Scale and bias of the log depth of the slices
+uniform usamplerBuffer	u_ClusterGrid;					// Offset and counts of the light lists of each cluster
+uniform usamplerBuffer	u_LightIndices;					// Light lists of all the clusters
 uniform sampler2D	u_ColorTexture;
-uniform PointLight	u_PointLights[MAX_POINT_LIGHTS];
 uniform sampler3D	u_VoxelTexture;
 
 // Output data
@@ -56,16 +73,16 @@ out vec4 gl_FragColor;
 
 
 // ____ FUNCTION DEFINITIONS ____
-vec3 calcPhongReflection(BaseLight light, vec3 lightDirection, vec3 viewDirection)
+vec3 calcPhongReflection(Material material, float ambientIntensity, float intensity, vec3 lightDirection, vec3 viewDirection)
 {
 	// Calculate the ambient color
-	vec3 ambientColor	= u_Material.mAmbientColor * light.mAmbientIntensity;
+	vec3 ambientColor	= material.mAmbientColor * ambientIntensity;
 
 	// Calculate the diffuse color
 	vec3 diffuseColor;
 	float diffuseAngle	= dot(lightDirection, vs_Vertex.mNormal);
 	if (diffuseAngle > 0) {
-		diffuseColor	= u_Material.mDiffuseColor * diffuseAngle;
+		diffuseColor	= material.mDiffuseColor * diffuseAngle;
 	}
 
 	// Calculate the specular color
@@ -73,44 +90,123 @@ vec3 calcPhongReflection(BaseLight light, vec3 lightDirection, vec3 viewDirectio
 	vec3 lightReflect	= normalize(reflect(lightDirection, vs_Vertex.mNormal));
 	float specularAngle	= dot(viewDirection, lightReflect);
 	if (specularAngle > 0) {
-		specularColor	= u_Material.mSpecularColor * pow(specularAngle, u_Material.mShininess);
+		specularColor	= material.mSpecularColor * pow(specularAngle, material.mShininess);
 	}
 
 	// Add all the light colors and return
-	return ambientColor + light.mIntensity * (diffuseColor + specularColor);
+	return ambientColor + intensity * (diffuseColor + specularColor);
 }
 
 
-vec3 calcPointLight(PointLight pointLight, vec3 pointLightPosition)
-{
+vec3 calcAttenuatedLight(
+	Material material, vec3 lightPosition,
+	float ambientIntensity, float intensity,
+	float constant, float linear, float exponential
+) {
 	// Calculate the view direction (the eye is in the center of the scene)
 	vec3 viewDirection	= normalize(-vs_Vertex.mPosition);
 	
 	// Calculate the light direction and distance from the current point
-	vec3 lightDirection	= pointLightPosition - vs_Vertex.mPosition;
+	vec3 lightDirection	= lightPosition - vs_Vertex.mPosition;
 	float distance		= length(lightDirection);
 	lightDirection		= normalize(lightDirection);
 
 	// Calculate the direct lighting of the current light with the Phong
 	// reflection model
-	vec3 lightColor		= calcPhongReflection(pointLight.mBaseLight, lightDirection, viewDirection);
+	vec3 lightColor		= calcPhongReflection(material, ambientIntensity, intensity, lightDirection, viewDirection);
 
-	// Calculate the attenuation of the point light
-	float attenuation	= pointLight.mAttenuation.mConstant
-						+ pointLight.mAttenuation.mLinear * distance
-						+ pointLight.mAttenuation.mExponential * pow(distance, 2);
+	// Calculate the attenuation of the light
+	float attenuation	= constant + linear * distance + exponential * pow(distance, 2);
 
 	// Apply the attenuation to the light color and return it
 	return lightColor / attenuation;
 }
 
 
+vec3 calcPointLight(Material material, PointLight pointLight)
+{
+	// Calculate the light position in view space
+	vec3 lightPosition	= (u_ViewMatrix * vec4(pointLight.mPosition, 1.0f)).xyz;
+
+	return calcAttenuatedLight(
+		material, lightPosition,
+		pointLight.mAmbientIntensity, pointLight.mIntensity,
+		pointLight.mConstant, pointLight.mLinear, pointLight.mExponential
+	);
+}
+
+
+vec3 calcSpotLight(Material material, SpotLight spotLight)
+{
+	// Calculate the light position and direction in view space
+	vec3 lightPosition	= (u_ViewMatrix * vec4(spotLight.mPosition, 1.0f)).xyz;
+	vec3 spotDirection	= normalize(mat3(u_ViewMatrix) * spotLight.mDirection);
+
+	// Discard the points outside the cone of the light
+	float spotFactor	= dot(normalize(vs_Vertex.mPosition - lightPosition), spotDirection);
+	if (spotFactor <= spotLight.mCosCutoff) {
+		return vec3(0.0f);
+	}
+
+	vec3 lightColor		= calcAttenuatedLight(
+		material, lightPosition,
+		spotLight.mAmbientIntensity, spotLight.mIntensity,
+		spotLight.mConstant, spotLight.mLinear, spotLight.mExponential
+	);
+
+	// Fade the light towards the border of the cone
+	return lightColor * (1.0f - (1.0f - spotFactor) / (1.0f - spotLight.mCosCutoff));
+}
+
+
+int calcClusterIndex()
+{
+	// Calculate the tile of the fragment with its NDC coordinates
+	vec4 clipPosition	= u_ProjectionMatrix * vec4(vs_Vertex.mPosition, 1.0f);
+	vec2 ndcPosition	= clipPosition.xy / clipPosition.w;
+	ivec2 tile			= clamp(
+		ivec2((0.5f * ndcPosition + 0.5f) * vec2(CLUSTER_GRID_SIZE.xy)),
+		ivec2(0), CLUSTER_GRID_SIZE.xy - 1
+	);
+
+	// Calculate the slice of the fragment with its depth
+	int slice			= clamp(
+		int(log(-vs_Vertex.mPosition.z) * u_ClusterZParams.x + u_ClusterZParams.y),
+		0, CLUSTER_GRID_SIZE.z - 1
+	);
+
+	return tile.x + CLUSTER_GRID_SIZE.x * (tile.y + CLUSTER_GRID_SIZE.y * slice);
+}
+
+
 vec3 calcDirectLight()
 {
-	vec3 totalLight;
-	for (int i = 0; i < vs_NumPointLights; ++i) {
-		totalLight += calcPointLight(u_PointLights[i], vs_PointLightsPositions[i]);
+	vec3 totalLight = vec3(0.0f);
+
+#if defined(POINT_LIGHTS) || defined(SPOT_LIGHTS)
+	Material material = u_Materials[vs_MaterialIndex];
+
+	// Get the light lists of the cluster of the fragment
+	uvec2 cluster		= texelFetch(u_ClusterGrid, calcClusterIndex()).xy;
+	int offset			= int(cluster.x);
+	int numPointLights	= int(cluster.y & 0xFFFFu);
+	int numSpotLights	= int(cluster.y >> 16u);
+
+#ifdef POINT_LIGHTS
+	for (int i = 0; i < numPointLights; ++i) {
+		int lightIndex = int(texelFetch(u_LightIndices, offset + i).x);
+		totalLight += calcPointLight(material, u_PointLights[lightIndex]);
+	}
+#endif
+
+#ifdef SPOT_LIGHTS
+	offset += numPointLights;
+	for (int i = 0; i < numSpotLights; ++i) {
+		int lightIndex = int(texelFetch(u_LightIndices, offset + i).x);
+		totalLight += calcSpotLight(material, u_SpotLights[lightIndex]);
 	}
+#endif
+#endif
 
 	return totalLight;
 }
@@ -120,5 +216,9 @@ vec3 calcDirectLight()
 void main()
 {
 	vec3 lightColor = calcDirectLight();
-	gl_FragColor = /*texture2D(u_ColorTexture, vs_Vertex.mUV) */ vec4(lightColor, 1.0f);
+#ifdef TEXTURED
+	gl_FragColor = texture(u_ColorTexture, vs_Vertex.mUV) * vec4(lightColor, 1.0f);
+#else
+	gl_FragColor = vec4(lightColor, 1.0f);
+#endif
 }
@@ -1,7 +1,16 @@
 #version 330 core
 
 // ____ CONSTANTS ____
-const int MAX_POINT_LIGHTS = 4;
+// MAX_OBJECTS is defined by the SceneProgram
+
+
+// ____ DATATYPES ____
+struct ObjectData
+{
+	mat4	mModelViewMatrix;
+	mat3	mNormalMatrix;
+	int		mMaterialIndex;
+};
 
 
 // ____ GLOBAL VARIABLES ____
@@ -9,13 +18,15 @@ const int MAX_POINT_LIGHTS = 4;
 layout (location = 0) in vec3 a_VertexPosition;			// Position attribute
 layout (location = 1) in vec3 a_VertexNormal;			// Normal attribute
 layout (location = 2) in vec2 a_VertexUV;				// Vertex UV Coords attribute
+layout (location = 5) in uint a_ObjectIndex;			// Instance index plus base instance
 
 // Uniform variables
-uniform mat4 u_ModelViewMatrix;							// Model space to View space Matrix
-uniform mat4 u_ProjectionMatrix;						// View space to Perspective space Matrix
+layout (std140) uniform ObjectBlock
+{
+	ObjectData u_Objects[MAX_OBJECTS];					// Per instance data
+};
 
-uniform int u_NumPointLights;							// Number of lights to process
-uniform vec3 u_PointLightsPositions[MAX_POINT_LIGHTS];	// PointLigths positions in world space
+uniform mat4 u_ProjectionMatrix;						// View space to Perspective space Matrix
 
 // Output data in view space
 out VertexData {
@@ -24,25 +35,20 @@ out VertexData {
 	vec2 mUV;
 } vs_Vertex;
 
-flat out int vs_NumPointLights;
-out vec3 vs_PointLightsPositions[MAX_POINT_LIGHTS];
+flat out int vs_MaterialIndex;
 
 
 // Functions
 void main()
 {
-	vec4 vertexView			= u_ModelViewMatrix * vec4(a_VertexPosition, 1.0f);
-	mat4 inverseTranspose	= transpose(inverse(u_ModelViewMatrix));
+	int objectIndex			= int(a_ObjectIndex);
+	mat4 modelViewMatrix	= u_Objects[objectIndex].mModelViewMatrix;
+	vec4 vertexView			= modelViewMatrix * vec4(a_VertexPosition, 1.0f);
 	gl_Position				= u_ProjectionMatrix * vertexView;
 
 	// Calculate the Vertex data for the fragment shader in view space
 	vs_Vertex.mPosition		= vertexView.xyz;
-	vs_Vertex.mNormal		= normalize(inverseTranspose * vec4(a_VertexNormal, 0.0f)).xyz;
+	vs_Vertex.mNormal		= normalize(u_Objects[objectIndex].mNormalMatrix * a_VertexNormal);
 	vs_Vertex.mUV			= a_VertexUV;
-
-	// Calculate the PointLights coordinates in view space
-	vs_NumPointLights = (u_NumPointLights > MAX_POINT_LIGHTS)? MAX_POINT_LIGHTS : u_NumPointLights;
-	for (int i = 0; i < vs_NumPointLights; ++i) {
-		vs_PointLightsPositions[i] = (u_ModelViewMatrix * vec4(u_PointLightsPositions[i], 1.0f)).xyz;
-	}
+	vs_MaterialIndex		= u_Objects[objectIndex].mMaterialIndex;
 }
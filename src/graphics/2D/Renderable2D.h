@@ -4,12 +4,14 @@
 #include <memory>
 #include <glm/glm.hpp>
 #include "../Texture.h"
+#include "TextureAtlas.h"
 
 namespace graphics {
 
 	/**
 	 * Class Renderable2D, is a 2D graphics entity that holds a position,
-	 * scale and texture
+	 * scale, texture and the layer where it's drawn. It can use a whole
+	 * Texture or only a region of it, like an image of a TextureAtlas
 	 */
 	class Renderable2D
 	{
@@ -26,18 +28,48 @@ namespace graphics {
 		/** The texture of the 2D element */
 		const TextureSPtr mTexture;
 
+		/** The UV coordinates of the bottom-left corner of the region of
+		 * the texture used by the 2D element */
+		glm::vec2 mUVPosition;
+
+		/** The size of the region of the texture in UV coordinates */
+		glm::vec2 mUVSize;
+
+		/** The layer of the 2D element, the elements of the higher layers
+		 * are drawn over the ones of the lower layers */
+		int mLayer;
+
 	public:		// Functions
 		/** Creates a new Renderable2D
 		 *
 		 * @param	position the 2D position of the Renderable2D
 		 * @param	scale the 2D scale of the Renderable2D
-		 * @param	texture a pointer to the texture of the Renderable2D */
+		 * @param	texture a pointer to the texture of the Renderable2D
+		 * @param	layer the layer of the Renderable2D */
+		Renderable2D(
+			const glm::vec2& position,
+			const glm::vec2& scale,
+			const std::shared_ptr<Texture> texture,
+			int layer = 0
+		) :	mPosition(position), mScale(scale),
+			mTexture(std::move(texture)),
+			mUVPosition(0.0f), mUVSize(1.0f), mLayer(layer) {};
+
+		/** Creates a new Renderable2D that uses a region of a Texture
+		 *
+		 * @param	position the 2D position of the Renderable2D
+		 * @param	scale the 2D scale of the Renderable2D
+		 * @param	region the region of the texture of the Renderable2D
+		 * @param	layer the layer of the Renderable2D */
 		Renderable2D(
 			const glm::vec2& position,
 			const glm::vec2& scale,
-			const std::shared_ptr<Texture> texture
+			const TextureRegion& region,
+			int layer = 0
 		) :	mPosition(position), mScale(scale),
-			mTexture(std::move(texture)) {};
+			mTexture(region.mTexture),
+			mUVPosition(region.mUVPosition), mUVSize(region.mUVSize),
+			mLayer(layer) {};
 
 		/** Class destructor */
 		~Renderable2D() {};
@@ -49,7 +81,23 @@ namespace graphics {
 		inline glm::vec2 getScale() const { return mScale; };
 
 		/** @return the texture of the Renderable 2D */
-		inline TextureSPtr getTexture() const { return mTexture; };
+		inline const TextureSPtr& getTexture() const { return mTexture; };
+
+		/** @return the UV coordinates of the bottom-left corner of the
+		 *			region of the texture of the Renderable2D */
+		inline glm::vec2 getUVPosition() const { return mUVPosition; };
+
+		/** @return the size in UV coordinates of the region of the
+		 *			texture of the Renderable2D */
+		inline glm::vec2 getUVSize() const { return mUVSize; };
+
+		/** @return the layer of the Renderable2D */
+		inline int getLayer() const { return mLayer; };
+
+		/** Sets the layer of the Renderable2D
+		 *
+		 * @param	layer the new layer of the Renderable2D */
+		inline void setLayer(int layer) { mLayer = layer; };
 	};
 
 }
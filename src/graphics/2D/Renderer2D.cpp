@@ -2,17 +2,22 @@
 #include <string>
 #include <sstream>
 #include <fstream>
-#include <glm/gtc/matrix_transform.hpp>
-#include "../Shader.h"
+#include <algorithm>
+#include "../GLStateCache.h"
 #include "Renderable2D.h"
 
 namespace graphics {
 
 // Static variables definition
-	const GLfloat Renderer2D::Quad2D::mPositions[] = { -1,1, -1,-1, 1,1, 1,-1 };
+	const GLfloat Renderer2D::mCorners[][2] = {
+		{ -1,-1 }, { 1,-1 }, { -1,1 },
+		{ -1,1 }, { 1,-1 }, { 1,1 }
+	};
 
 // Public functions
-	Renderer2D::Renderer2D()
+	Renderer2D::Renderer2D() :
+		mVertexBuffer(static_cast<const GLfloat*>(nullptr), 0, 4),
+		mNumDrawCalls(0)
 	{
 		// 1. Read the shader text from the shader files
 		std::ifstream reader;
@@ -32,14 +37,14 @@ namespace graphics {
 		reader.close();
 
 		// 2. Create the Program
-		Shader vertexShader(vertexShaderText.c_str(), GL_VERTEX_SHADER);
-		Shader fragmentShader(fragmentShaderText.c_str(), GL_FRAGMENT_SHADER);
-
-		std::vector<const Shader*> shaders = { &vertexShader, &fragmentShader };
-		mProgram = new Program(shaders);
-
-		// 3. Get the uniform locations
-		mUniformLocations.u_ModelMatrix = mProgram->getUniformLocation("u_ModelMatrix");
+		mProgram = new Program({
+			{ GL_VERTEX_SHADER, vertexShaderText },
+			{ GL_FRAGMENT_SHADER, fragmentShaderText }
+		});
+
+		// 3. Create the VAO, each vertex is read as a vec4 with its
+		// position and UV coordinates
+		mVAO.addBuffer(&mVertexBuffer, 0);
 	}
 
 
@@ -49,35 +54,96 @@ namespace graphics {
 	}
 
 
-	void Renderer2D::render()
+	void Renderer2D::submit(const Renderable2D* renderable)
 	{
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDisable(GL_DEPTH_TEST);
+		const Texture* texture = renderable->getTexture().get();
 
-		mProgram->enable();
-		mQuad.bindVAO();
+		std::uint64_t layer		= static_cast<std::uint32_t>(renderable->getLayer()) ^ 0x80000000u;
+		std::uint64_t textureID	= (texture)? texture->getID() + 1 : 0;
+		mSprites.push_back({ (layer << 32) | textureID, renderable });
+	}
 
-		while (!mRenderable2Ds.empty()) {
-			const Renderable2D* renderable2D = mRenderable2Ds.front();
-			mRenderable2Ds.pop();
 
-			glm::mat4 transforms = glm::translate(glm::mat4(), glm::vec3(renderable2D->getPosition(), 0));
-			transforms *= glm::scale(glm::mat4(), glm::vec3(renderable2D->getScale(), 1));
-			mProgram->setUniform(mUniformLocations.u_ModelMatrix, transforms);
+	void Renderer2D::submit(const std::vector<const Renderable2D*>& renderables)
+	{
+		mSprites.reserve(mSprites.size() + renderables.size());
+		for (const Renderable2D* renderable : renderables) {
+			submit(renderable);
+		}
+	}
 
-			glActiveTexture(GL_TEXTURE0);
-			renderable2D->getTexture()->bind();
-	
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, mQuad.getNumVertices());
+
+	void Renderer2D::render()
+	{
+		mNumDrawCalls = 0;
+		if (mSprites.empty()) return;
+
+		// Sort the Renderable2Ds by layer and Texture
+		std::stable_sort(
+			mSprites.begin(), mSprites.end(),
+			[](const Sprite& s1, const Sprite& s2) { return s1.mKey < s2.mKey; }
+		);
+
+		// Transform the quads and upload all of them at once
+		mVertices.resize(NUM_VERTICES_PER_SPRITE * mSprites.size());
+		for (unsigned int i = 0; i < mSprites.size(); ++i) {
+			const Renderable2D* renderable2D = mSprites[i].mRenderable2D;
+			glm::vec2 position		= renderable2D->getPosition();
+			glm::vec2 scale			= renderable2D->getScale();
+			glm::vec2 uvPosition	= renderable2D->getUVPosition();
+			glm::vec2 uvSize		= renderable2D->getUVSize();
+
+			for (unsigned int j = 0; j < NUM_VERTICES_PER_SPRITE; ++j) {
+				SpriteVertex& vertex = mVertices[NUM_VERTICES_PER_SPRITE * i + j];
+				vertex.mPosition[0]	= position.x + scale.x * mCorners[j][0];
+				vertex.mPosition[1]	= position.y + scale.y * mCorners[j][1];
+				vertex.mUV[0]		= uvPosition.x + uvSize.x * 0.5f * (mCorners[j][0] + 1.0f);
+				vertex.mUV[1]		= uvPosition.y + uvSize.y * 0.5f * (mCorners[j][1] + 1.0f);
+			}
+		}
+		mVertexBuffer.setData(
+			reinterpret_cast<const GLfloat*>(mVertices.data()),
+			mVertices.size() * sizeof(SpriteVertex) / sizeof(GLfloat)
+		);
+
+		GLStateCache::enable(GL_BLEND);
+		GLStateCache::setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		GLStateCache::disable(GL_DEPTH_TEST);
+		GLStateCache::disable(GL_SCISSOR_TEST);
+
+		mProgram->enable();
+		mVAO.bind();
+
+		// Draw the consecutive quads with the same Texture at once
+		unsigned int iFirst = 0;
+		while (iFirst < mSprites.size()) {
+			const Texture* texture = mSprites[iFirst].mRenderable2D->getTexture().get();
+
+			unsigned int iLast = iFirst + 1;
+			while ((iLast < mSprites.size())
+				&& (mSprites[iLast].mRenderable2D->getTexture().get() == texture)
+			) {
+				++iLast;
+			}
+
+			if (texture) {
+				texture->bind(0);
+			}
+			else {
+				GLStateCache::bindTexture(0, GL_TEXTURE_2D, 0);
+			}
+
+			glDrawArrays(
+				GL_TRIANGLES,
+				NUM_VERTICES_PER_SPRITE * iFirst,
+				NUM_VERTICES_PER_SPRITE * (iLast - iFirst)
+			);
+			++mNumDrawCalls;
+
+			iFirst = iLast;
 		}
-		glBindTexture(GL_TEXTURE_2D, 0);
 
-		glBindVertexArray(0);
-		mProgram->disable();
-		
-		glEnable(GL_DEPTH_TEST);
-		glDisable(GL_BLEND);
+		mSprites.clear();
 	}
 
 }
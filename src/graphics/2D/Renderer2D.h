@@ -1,7 +1,8 @@
 #ifndef RENDERER_2D_H
 #define RENDERER_2D_H
 
-#include <queue>
+#include <vector>
+#include <cstdint>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include "../Program.h"
@@ -14,80 +15,68 @@ namespace graphics {
 
 
 	/**
-	 * Class Renderer2D, it's a Forward Renderer used for rendering 2D 2D
-	 * graphics elements
+	 * Class Renderer2D, it's a Forward Renderer used for rendering 2D
+	 * graphics elements.
+	 * <br>The submitted Renderable2Ds are sorted by their layer and
+	 * Texture, and their quads are transformed in the CPU and written to a
+	 * single streaming vertex buffer, so all the consecutive Renderable2Ds
+	 * with the same Texture are drawn with only one draw call
 	 */
 	class Renderer2D
 	{
 	private:	// Nested Types
-		/** Struct UniformLocations, it holds the uniform variables location
-		 * so we don't have to get them in each render call */
-		struct UniformLocations
+		/** Struct SpriteVertex, it holds the data of a vertex of the quad
+		 * of a Renderable2D */
+		struct SpriteVertex
 		{
-			GLuint u_ModelMatrix;
+			/** The position of the vertex in Projection space */
+			GLfloat mPosition[2];
+
+			/** The UV coordinates of the vertex */
+			GLfloat mUV[2];
 		};
 
-		/** Class 2DQuad, it holds all the needed data for rendering the 2D
-		 * elements */
-		class Quad2D
+		/** Struct Sprite, it holds a submitted Renderable2D and the key
+		 * used for sorting it */
+		struct Sprite
 		{
-		private:	// Attributes
-			/** The positions of the only quad needed for rendering the 2D
-			 * entities */
-			static const GLfloat mPositions[];
-
-			/** The number of vertices in the positions array */
-			static const unsigned int mNumVertices = 4;
-
-			/** The number of components in the positions array needed for each
-			 * vertex */
-			static const unsigned int mNumComponentsPerVertex = 2;
-
-			/** The vertex buffer for the positions of the quad  of the renderer */
-			VertexBuffer mPositionsBuffer;
-
-			/** The Vertex Array Object of the Renderer */
-			VertexArray mVAO;
-
-		public:		// Functions
-			/** Creates a new 2DQuad */
-			Quad2D() :
-				mPositionsBuffer(
-					mPositions,
-					mNumVertices * mNumComponentsPerVertex,
-					mNumComponentsPerVertex
-				)
-			{ mVAO.addBuffer(&mPositionsBuffer, 0); };
-
-			/** Class destructor */
-			~Quad2D() {};
-
-			/** @return	the number of vertices of the quad */
-			inline unsigned int getNumVertices() const
-			{ return mNumVertices; };
-
-			/** Binds the VAO of the 2DQuad */
-			inline void bindVAO() const { mVAO.bind(); };
+			/** The layer (most significant bits) and the Texture ID of the
+			 * Renderable2D */
+			std::uint64_t mKey;
+
+			/** The Renderable2D to draw */
+			const Renderable2D* mRenderable2D;
 		};
 
 	private:	// Attributes
+		/** The number of vertices of the quad of each Renderable2D, drawn
+		 * as two triangles */
+		static const unsigned int NUM_VERTICES_PER_SPRITE = 6;
+
+		/** The corners of the quads in Local space, and their UV
+		 * coordinates in the same order */
+		static const GLfloat mCorners[NUM_VERTICES_PER_SPRITE][2];
+
 		/** The Program of the renderer */
 		Program* mProgram;
 
-		/** The locations of uniform variables in the shader */
-		UniformLocations mUniformLocations;
-
 		/** The Renderables that we want to render */
-		std::queue<const Renderable2D*> mRenderable2Ds;
+		std::vector<Sprite> mSprites;
+
+		/** The vertices of the quads of the current render call */
+		std::vector<SpriteVertex> mVertices;
+
+		/** The streaming vertex buffer with the vertices of the quads */
+		VertexBuffer mVertexBuffer;
 
-		/** The quad needed for rendering all the 2D elements */
-		Quad2D mQuad;
+		/** The Vertex Array Object of the Renderer */
+		VertexArray mVAO;
+
+		/** The number of draw calls issued in the last render call */
+		unsigned int mNumDrawCalls;
 
 	public:		// Functions
-		/** Creates a new Renderer2D and sets all the GL data like depth
-		 * testing, face culling and the window clear color
-		 *
-		 * @param	program the Program with which the renderer will render */
+		/** Creates a new Renderer2D */
 		Renderer2D();
 
 		/** Class destructor */
@@ -98,13 +87,27 @@ namespace graphics {
 		 *
 		 * @param	renderable a pointer to the Renderable2D that we want to
 		 *			render */
-		inline void submit(const Renderable2D* renderable)
-		{ mRenderable2Ds.push(renderable); };
+		void submit(const Renderable2D* renderable);
+
+		/** Submits the given Renderable2Ds to the queue of Renderable2Ds to
+		 * render
+		 *
+		 * @param	renderables a vector with pointers to the Renderable2Ds
+		 *			that we want to render */
+		void submit(const std::vector<const Renderable2D*>& renderables);
 
 		/** Renders the Renderable2Ds that currently are in the render queue
-		 * 
+		 * sorted by their layer, from the lowest to the highest one. The
+		 * Renderable2Ds of the same layer are grouped by Texture, and keep
+		 * their submission order inside each group
+		 *
 		 * @note	after calling this method the render queue will be empty */
 		void render();
+
+		/** @return	the number of draw calls issued in the last render
+		 *			call */
+		inline unsigned int getNumDrawCalls() const
+		{ return mNumDrawCalls; };
 	};
 
 }
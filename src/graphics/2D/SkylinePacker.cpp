@@ -0,0 +1,122 @@
+#include "SkylinePacker.h"
+#include <limits>
+
+namespace graphics {
+
+	SkylinePacker::SkylinePacker(unsigned int width, unsigned int height) :
+		mWidth(width), mHeight(height), mUsedArea(0)
+	{
+		mSkyline.push_back({ 0, 0, mWidth });
+	}
+
+
+	bool SkylinePacker::insert(
+		unsigned int width, unsigned int height,
+		unsigned int& x, unsigned int& y
+	) {
+		if ((width == 0) || (height == 0)) return false;
+
+		// Find the segment where the top edge of the rectangle is the
+		// lowest one, using the narrowest segment on ties
+		unsigned int iBestSegment = mSkyline.size();
+		unsigned int bestTop = std::numeric_limits<unsigned int>::max();
+		unsigned int bestWidth = std::numeric_limits<unsigned int>::max();
+		for (unsigned int i = 0; i < mSkyline.size(); ++i) {
+			unsigned int segmentY;
+			if (fits(i, width, height, segmentY)) {
+				unsigned int top = segmentY + height;
+				if ((top < bestTop) || ((top == bestTop) && (mSkyline[i].mWidth < bestWidth))) {
+					iBestSegment = i;
+					bestTop = top;
+					bestWidth = mSkyline[i].mWidth;
+					y = segmentY;
+				}
+			}
+		}
+
+		if (iBestSegment == mSkyline.size()) {
+			return false;
+		}
+
+		x = mSkyline[iBestSegment].mX;
+		addSegment(iBestSegment, width, bestTop);
+		mUsedArea += static_cast<unsigned long>(width) * height;
+
+		return true;
+	}
+
+
+	float SkylinePacker::getOccupancy() const
+	{
+		return static_cast<float>(mUsedArea) / (static_cast<float>(mWidth) * mHeight);
+	}
+
+// Private functions
+	bool SkylinePacker::fits(
+		unsigned int iSegment,
+		unsigned int width, unsigned int height,
+		unsigned int& y
+	) const {
+		unsigned int x = mSkyline[iSegment].mX;
+		if (x + width > mWidth) {
+			return false;
+		}
+
+		// The rectangle lies over the highest of the segments that it
+		// spans
+		y = 0;
+		unsigned int remainingWidth = width;
+		for (unsigned int i = iSegment; remainingWidth > 0; ++i) {
+			const Segment& segment = mSkyline[i];
+			if (segment.mY > y) {
+				y = segment.mY;
+			}
+			if (y + height > mHeight) {
+				return false;
+			}
+
+			remainingWidth -= (segment.mWidth < remainingWidth)? segment.mWidth : remainingWidth;
+		}
+
+		return true;
+	}
+
+
+	void SkylinePacker::addSegment(unsigned int iSegment, unsigned int width, unsigned int top)
+	{
+		Segment newSegment = { mSkyline[iSegment].mX, top, width };
+		mSkyline.insert(mSkyline.begin() + iSegment, newSegment);
+
+		// Shrink or remove the segments covered by the new one
+		unsigned int right = newSegment.mX + newSegment.mWidth;
+		unsigned int i = iSegment + 1;
+		while (i < mSkyline.size()) {
+			Segment& segment = mSkyline[i];
+			if (segment.mX >= right) {
+				break;
+			}
+
+			unsigned int segmentRight = segment.mX + segment.mWidth;
+			if (segmentRight <= right) {
+				mSkyline.erase(mSkyline.begin() + i);
+			}
+			else {
+				segment.mWidth = segmentRight - right;
+				segment.mX = right;
+				break;
+			}
+		}
+
+		// Merge the consecutive segments at the same height
+		for (i = 0; i + 1 < mSkyline.size();) {
+			if (mSkyline[i].mY == mSkyline[i + 1].mY) {
+				mSkyline[i].mWidth += mSkyline[i + 1].mWidth;
+				mSkyline.erase(mSkyline.begin() + i + 1);
+			}
+			else {
+				++i;
+			}
+		}
+	}
+
+}
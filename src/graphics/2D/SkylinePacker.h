@@ -0,0 +1,100 @@
+#ifndef SKYLINE_PACKER_H
+#define SKYLINE_PACKER_H
+
+#include <vector>
+
+namespace graphics {
+
+	/**
+	 * Class SkylinePacker, it packs rectangles inside of a bigger one with
+	 * the Skyline Bottom-Left algorithm.
+	 * <br>The packer only stores the skyline, the top edge of the
+	 * rectangles already packed, as a list of horizontal segments. Each
+	 * new rectangle is placed over the segment where its top edge is the
+	 * lowest one, so inserting a rectangle costs O(n) in the number of
+	 * segments. The best results are obtained inserting the rectangles
+	 * sorted by decreasing height
+	 */
+	class SkylinePacker
+	{
+	private:	// Nested types
+		/** Struct Segment, it's an horizontal segment of the skyline */
+		struct Segment
+		{
+			/** The coordinates of the left end of the segment */
+			unsigned int mX, mY;
+
+			/** The length of the segment */
+			unsigned int mWidth;
+		};
+
+	private:	// Attributes
+		/** The size of the rectangle where the other rectangles are
+		 * packed */
+		unsigned int mWidth, mHeight;
+
+		/** The segments of the skyline sorted from left to right */
+		std::vector<Segment> mSkyline;
+
+		/** The area of the packed rectangles */
+		unsigned long mUsedArea;
+
+	public:		// Functions
+		/** Creates a new SkylinePacker
+		 *
+		 * @param	width the width of the rectangle where the other
+		 *			rectangles are packed
+		 * @param	height the height of the rectangle where the other
+		 *			rectangles are packed */
+		SkylinePacker(unsigned int width, unsigned int height);
+
+		/** Class destructor */
+		~SkylinePacker() {};
+
+		/** Packs a rectangle with the given size
+		 *
+		 * @param	width the width of the rectangle
+		 * @param	height the height of the rectangle
+		 * @param	x where the x coordinate of the bottom-left corner of
+		 *			the rectangle will be stored
+		 * @param	y where the y coordinate of the bottom-left corner of
+		 *			the rectangle will be stored
+		 * @return	true if the rectangle was packed, false if there isn't
+		 *			enough space for it */
+		bool insert(
+			unsigned int width, unsigned int height,
+			unsigned int& x, unsigned int& y
+		);
+
+		/** @return	the fraction of the area of the packer used by the
+		 *			packed rectangles */
+		float getOccupancy() const;
+	private:
+		/** Calculates the position of a rectangle placed over the given
+		 * segment
+		 *
+		 * @param	iSegment the index of the segment where the left edge of
+		 *			the rectangle is placed
+		 * @param	width the width of the rectangle
+		 * @param	height the height of the rectangle
+		 * @param	y where the y coordinate of the bottom edge of the
+		 *			rectangle will be stored
+		 * @return	true if the rectangle fits, false otherwise */
+		bool fits(
+			unsigned int iSegment,
+			unsigned int width, unsigned int height,
+			unsigned int& y
+		) const;
+
+		/** Adds the top edge of the given rectangle to the skyline
+		 *
+		 * @param	iSegment the index of the segment where the left edge of
+		 *			the rectangle is placed
+		 * @param	width the width of the rectangle
+		 * @param	top the y coordinate of the top edge of the rectangle */
+		void addSegment(unsigned int iSegment, unsigned int width, unsigned int top);
+	};
+
+}
+
+#endif		// SKYLINE_PACKER_H
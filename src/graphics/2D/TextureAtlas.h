@@ -0,0 +1,87 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+namespace graphics {
+
+	class Texture;
+
+
+	/**
+	 * Struct TextureRegion, it's a rectangle of a Texture in UV
+	 * coordinates
+	 */
+	struct TextureRegion
+	{
+		/** The Texture that holds the region */
+		std::shared_ptr<Texture> mTexture;
+
+		/** The UV coordinates of the bottom-left corner of the region */
+		glm::vec2 mUVPosition;
+
+		/** The size of the region in UV coordinates */
+		glm::vec2 mUVSize;
+	};
+
+
+	/**
+	 * Class TextureAtlas, it holds the pages (big Textures) where multiple
+	 * images were packed, and the region of each image inside of them, so
+	 * the elements that use different images of the same page can be
+	 * drawn without changing the bound Texture
+	 */
+	class TextureAtlas
+	{
+	private:	// Attributes
+		/** The Textures with the packed images */
+		std::vector<std::shared_ptr<Texture>> mPages;
+
+		/** Maps the name of each image with its region */
+		std::unordered_map<std::string, TextureRegion> mRegions;
+
+	public:		// Functions
+		/** Creates a new empty TextureAtlas */
+		TextureAtlas() {};
+
+		/** Class destructor */
+		~TextureAtlas() {};
+
+		/** Adds the given page to the TextureAtlas
+		 *
+		 * @param	page a pointer to the Texture of the page */
+		inline void addPage(std::shared_ptr<Texture> page)
+		{ mPages.push_back(std::move(page)); };
+
+		/** Adds the region of an image to the TextureAtlas
+		 *
+		 * @param	name the name of the image
+		 * @param	region the region of the image in one of the pages */
+		inline void addRegion(const std::string& name, const TextureRegion& region)
+		{ mRegions[name] = region; };
+
+		/** @return	the number of pages of the TextureAtlas */
+		inline unsigned int getNumPages() const { return mPages.size(); };
+
+		/** @return	the number of images of the TextureAtlas */
+		inline unsigned int getNumRegions() const { return mRegions.size(); };
+
+		/** Returns the region of the image with the given name
+		 *
+		 * @param	name the name of the image
+		 * @return	a pointer to the region, nullptr if the TextureAtlas
+		 *			doesn't have the image */
+		inline const TextureRegion* getRegion(const std::string& name) const
+		{
+			auto itRegion = mRegions.find(name);
+			return (itRegion != mRegions.end())? &itRegion->second : nullptr;
+		};
+	};
+
+}
+
+#endif		// TEXTURE_ATLAS_H
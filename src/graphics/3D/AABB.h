@@ -4,19 +4,43 @@
 #include <glm/glm.hpp>
 
 namespace graphics {
-	
+
 	/** Struct AABB, it's a Axis Aligned Bounding Box that holds the maximum
-	 * and the minimum coordinates in Global Space of the vertices of the mesh
-	 * in each axis of */
+	 * and the minimum coordinates of the vertices of a mesh in each axis */
 	struct AABB
 	{
-		/** The maximum coordinates of the vertices of the Mesh in Global
-		 * Space */
+		/** The maximum coordinates of the vertices of the Mesh */
 		glm::vec3 mMaximum;
 
-		/** The minimum coordinates of the vertices of the Mesh in Global
-		 * Space */
+		/** The minimum coordinates of the vertices of the Mesh */
 		glm::vec3 mMinimum;
+
+		/** @return	the radius of the bounding sphere of the AABB, centered
+		 *			at the center of the AABB */
+		inline float getRadius() const
+		{ return 0.5f * glm::length(mMaximum - mMinimum); };
+
+		/** Calculates the AABB that encloses the current one after
+		 * transforming it with the given matrix
+		 *
+		 * @param	transforms the matrix with which we want to transform
+		 *			the AABB
+		 * @return	the transformed AABB */
+		inline AABB transform(const glm::mat4& transforms) const
+		{
+			glm::vec3 center	= 0.5f * (mMaximum + mMinimum);
+			glm::vec3 extents	= 0.5f * (mMaximum - mMinimum);
+
+			glm::vec3 newCenter(transforms * glm::vec4(center, 1.0f));
+			glm::vec3 newExtents(0.0f);
+			for (int i = 0; i < 3; ++i) {
+				for (int j = 0; j < 3; ++j) {
+					newExtents[i] += glm::abs(transforms[j][i]) * extents[j];
+				}
+			}
+
+			return { newCenter + newExtents, newCenter - newExtents };
+		};
 	};
 
 }
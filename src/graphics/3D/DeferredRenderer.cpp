@@ -0,0 +1,241 @@
+#include "DeferredRenderer.h"
+#include <cmath>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include "../Program.h"
+#include "../GLStateCache.h"
+#include "Camera.h"
+#include "Lights.h"
+
+namespace graphics {
+
+// Static variables definition
+	const GLfloat DeferredRenderer::mQuadPositions[] = { -1,1, -1,-1, 1,1, 1,-1 };
+
+// Public functions
+	DeferredRenderer::DeferredRenderer(
+		const glm::mat4& projectionMatrix,
+		GLuint width, GLuint height,
+		JobSystem& jobSystem
+	) : mProjectionMatrix(projectionMatrix),
+		mLightProjector(projectionMatrix),
+		mGBuffer(width, height),
+		mBatcher(jobSystem),
+		mQuadBuffer(mQuadPositions, 8, 2)
+	{
+		mQuadVAO.addBuffer(&mQuadBuffer, 0);
+
+		initShaders();
+		initUniformLocations();
+	}
+
+
+	DeferredRenderer::~DeferredRenderer()
+	{
+		delete mLightingProgram;
+		delete mTexturedGeometryProgram;
+		delete mGeometryProgram;
+	}
+
+
+	void DeferredRenderer::render(
+		const Camera* camera,
+		const std::vector<const PointLight*>& pointLights,
+		const std::vector<const SpotLight*>& spotLights
+	) {
+		if (!camera) return;
+
+		glm::mat4 viewMatrix = camera->getViewMatrix();
+
+		// Cull and sort the Renderable3Ds and upload their data
+		mBatcher.prepare(viewMatrix, mProjectionMatrix);
+		mLightBuffer.setLights(pointLights, spotLights);
+
+		geometryPass();
+		lightingPass(viewMatrix, pointLights, spotLights);
+	}
+
+// Private functions
+	void DeferredRenderer::initShaders()
+	{
+		// 1. Read the shader text from the shader files
+		const char* shaderPaths[] = {
+			"res/shaders/GBuffer.vert", "res/shaders/GBuffer.frag",
+			"res/shaders/DeferredLight.vert", "res/shaders/DeferredLight.frag"
+		};
+		std::string shaderTexts[4];
+
+		std::ifstream reader;
+		for (unsigned int i = 0; i < 4; ++i) {
+			std::stringstream shaderStream;
+			reader.open(shaderPaths[i]);
+			shaderStream << reader.rdbuf();
+			shaderTexts[i] = shaderStream.str();
+			reader.close();
+		}
+
+		// 2. Create the Programs with the sizes of the uniform blocks
+		// that they read
+		mGeometryProgram = new Program({
+			{ GL_VERTEX_SHADER, shaderTexts[0] },
+			{ GL_FRAGMENT_SHADER, shaderTexts[1] }
+		}, SceneBatcher::getBlockDefines());
+		mTexturedGeometryProgram = new Program({
+			{ GL_VERTEX_SHADER, shaderTexts[0] },
+			{ GL_FRAGMENT_SHADER, shaderTexts[1] }
+		}, SceneBatcher::getBlockDefines() + "#define TEXTURED\n");
+		mLightingProgram = new Program({
+			{ GL_VERTEX_SHADER, shaderTexts[2] },
+			{ GL_FRAGMENT_SHADER, shaderTexts[3] }
+		}, SceneBatcher::getBlockDefines() + LightBuffer::getBlockDefines());
+	}
+
+
+	void DeferredRenderer::initUniformLocations()
+	{
+		mUniformLocations.mProjectionMatrix	= mGeometryProgram->getUniformLocation("u_ProjectionMatrix");
+		mUniformLocations.mTexturedProjectionMatrix	= mTexturedGeometryProgram->getUniformLocation("u_ProjectionMatrix");
+		mUniformLocations.mViewMatrix		= mLightingProgram->getUniformLocation("u_ViewMatrix");
+		mUniformLocations.mLightType		= mLightingProgram->getUniformLocation("u_LightType");
+		mUniformLocations.mLightIndex		= mLightingProgram->getUniformLocation("u_LightIndex");
+
+		mGeometryProgram->setUniformBlockBinding("ObjectBlock", SceneBatcher::OBJECT_BLOCK_BINDING);
+		mGeometryProgram->setUniformBlockBinding("MaterialBlock", SceneBatcher::MATERIAL_BLOCK_BINDING);
+		mTexturedGeometryProgram->setUniformBlockBinding("ObjectBlock", SceneBatcher::OBJECT_BLOCK_BINDING);
+		mTexturedGeometryProgram->setUniformBlockBinding("MaterialBlock", SceneBatcher::MATERIAL_BLOCK_BINDING);
+		mLightingProgram->setUniformBlockBinding("MaterialBlock", SceneBatcher::MATERIAL_BLOCK_BINDING);
+		mLightingProgram->setUniformBlockBinding("LightBlock", LightBuffer::LIGHT_BLOCK_BINDING);
+
+		mTexturedGeometryProgram->enable();
+		mTexturedGeometryProgram->setUniform("u_DiffuseTexture", static_cast<int>(DIFFUSE_TEXTURE_UNIT));
+
+		mLightingProgram->enable();
+		mLightingProgram->setUniform("u_PositionTexture", static_cast<int>(GBUFFER_TEXTURE_TYPE_POSITION));
+		mLightingProgram->setUniform("u_DiffuseTexture", static_cast<int>(GBUFFER_TEXTURE_TYPE_DIFFUSE));
+		mLightingProgram->setUniform("u_NormalTexture", static_cast<int>(GBUFFER_TEXTURE_TYPE_NORMAL));
+		mLightingProgram->setUniform("u_TexCoordTexture", static_cast<int>(GBUFFER_TEXTURE_TYPE_TEXCOORD));
+		mLightingProgram->setUniform("u_DepthTexture", static_cast<int>(DEPTH_TEXTURE_UNIT));
+		Program::disable();
+	}
+
+
+	void DeferredRenderer::geometryPass()
+	{
+		mGBuffer.bindForWriting();
+		GLStateCache::disable(GL_SCISSOR_TEST);
+		GLStateCache::setDepthMask(true);
+
+		// Clear the GBuffer, the pixels without geometry will have a null
+		// normal
+		const GLfloat zeros[] = { 0.0f, 0.0f, 0.0f, 0.0f }, one = 1.0f;
+		for (GLint i = 0; i < GBUFFER_NUM_TEXTURES; ++i) {
+			glClearBufferfv(GL_COLOR, i, zeros);
+		}
+		glClearBufferfv(GL_DEPTH, 0, &one);
+
+		mTexturedGeometryProgram->enable();
+		mTexturedGeometryProgram->setUniform(mUniformLocations.mTexturedProjectionMatrix, mProjectionMatrix);
+		mGeometryProgram->enable();
+		mGeometryProgram->setUniform(mUniformLocations.mProjectionMatrix, mProjectionMatrix);
+
+		// Switch to the textured variant while the draws have a Texture,
+		// like the forward renderer does
+		mBatcher.draw([this](const Texture* texture) {
+			(texture? mTexturedGeometryProgram : mGeometryProgram)->enable();
+		});
+
+		mGBuffer.unbind();
+	}
+
+
+	void DeferredRenderer::lightingPass(
+		const glm::mat4& viewMatrix,
+		const std::vector<const PointLight*>& pointLights,
+		const std::vector<const SpotLight*>& spotLights
+	) {
+		for (GLuint i = 0; i < GBUFFER_NUM_TEXTURES; ++i) {
+			mGBuffer.bindTexture(static_cast<GBUFFER_TEXTURE_TYPE>(i), i);
+		}
+		mGBuffer.bindDepthTexture(DEPTH_TEXTURE_UNIT);
+		mLightBuffer.bind();
+
+		mLightingProgram->enable();
+		mLightingProgram->setUniform(mUniformLocations.mViewMatrix, viewMatrix);
+		mQuadVAO.bind();
+
+		// Copy the depth of the GBuffer and clear the color of the pixels
+		// with geometry
+		GLStateCache::enable(GL_DEPTH_TEST);
+		GLStateCache::setDepthFunction(GL_ALWAYS);
+		GLStateCache::disable(GL_BLEND);
+		mLightingProgram->setUniform(mUniformLocations.mLightType, static_cast<int>(NO_LIGHT));
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+		// Add the light of each light to the pixels of its volume
+		GLStateCache::disable(GL_DEPTH_TEST);
+		GLStateCache::enable(GL_BLEND);
+		GLStateCache::setBlendFunction(GL_ONE, GL_ONE);
+		GLStateCache::enable(GL_SCISSOR_TEST);
+
+		mLightingProgram->setUniform(mUniformLocations.mLightType, static_cast<int>(POINT_LIGHT));
+		for (unsigned int i = 0; i < mLightBuffer.getNumPointLights(); ++i) {
+			glm::vec3 center(viewMatrix * glm::vec4(pointLights[i]->getPosition(), 1.0f));
+			drawLight(POINT_LIGHT, i, center, pointLights[i]->getRadius());
+		}
+
+		mLightingProgram->setUniform(mUniformLocations.mLightType, static_cast<int>(SPOT_LIGHT));
+		for (unsigned int i = 0; i < mLightBuffer.getNumSpotLights(); ++i) {
+			glm::vec3 position;
+			float radius;
+			spotLights[i]->getBoundingSphere(position, radius);
+
+			glm::vec3 center(viewMatrix * glm::vec4(position, 1.0f));
+			drawLight(SPOT_LIGHT, i, center, radius);
+		}
+	}
+
+
+	void DeferredRenderer::drawLight(
+		LightType lightType, GLint lightIndex,
+		const glm::vec3& center, float radius
+	) {
+		GLint rectangle[4];
+		if (!calculateScissor(center, radius, rectangle)) {
+			return;
+		}
+
+		glScissor(rectangle[0], rectangle[1], rectangle[2], rectangle[3]);
+		mLightingProgram->setUniform(mUniformLocations.mLightIndex, lightIndex);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+
+
+	bool DeferredRenderer::calculateScissor(
+		const glm::vec3& center, float radius,
+		GLint rectangle[4]
+	) const {
+		SphereProjector::Bounds bounds;
+		if (!mLightProjector.project(center, radius, bounds)) {
+			return false;
+		}
+
+		// Transform the NDC bounds to window coordinates
+		const GLint size[2] = { static_cast<GLint>(mGBuffer.getWidth()), static_cast<GLint>(mGBuffer.getHeight()) };
+		const float ndcMin[2] = { bounds.mMinimum.x, bounds.mMinimum.y };
+		const float ndcMax[2] = { bounds.mMaximum.x, bounds.mMaximum.y };
+		for (int i = 0; i < 2; ++i) {
+			float minimum = glm::clamp(0.5f * ndcMin[i] + 0.5f, 0.0f, 1.0f) * size[i];
+			float maximum = glm::clamp(0.5f * ndcMax[i] + 0.5f, 0.0f, 1.0f) * size[i];
+
+			rectangle[i]		= static_cast<GLint>(std::floor(minimum));
+			rectangle[i + 2]	= static_cast<GLint>(std::ceil(maximum)) - rectangle[i];
+			if (rectangle[i + 2] <= 0) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,222 @@
+#ifndef DEFERRED_RENDERER_H
+#define DEFERRED_RENDERER_H
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "SceneBatcher.h"
+#include "LightBuffer.h"
+#include "SphereProjector.h"
+#include "../buffers/GBuffer.h"
+#include "../buffers/VertexArray.h"
+#include "../buffers/VertexBuffer.h"
+
+namespace graphics {
+
+	class Program;
+	class Renderable3D;
+	class PointLight;
+	class SpotLight;
+	class Camera;
+
+
+	/**
+	 * Class DeferredRenderer, it's a Deferred Renderer used for rendering
+	 * Renderable3Ds without skeletal animation.
+	 * <br>First the Renderable3Ds are drawn in a geometry pass to the
+	 * GBuffer, which holds for each pixel its position, diffuse color,
+	 * normal in View space and the UV coordinates with the Material index.
+	 * The Renderable3Ds with a Texture are drawn with a variant of the
+	 * geometry Program that multiplies it with the Material diffuse color.
+	 * Then each light is drawn in the lighting pass as a screen quad
+	 * scissored to the bounds of its volume, so the cost of the lights
+	 * only depends on the number of pixels that they cover.
+	 * <br>The transparent Renderable3Ds are drawn as opaque ones
+	 */
+	class DeferredRenderer
+	{
+	private:	// Nested types
+		/** The types of lights of the lighting pass */
+		enum LightType
+		{
+			NO_LIGHT = 0,
+			POINT_LIGHT = 1,
+			SPOT_LIGHT = 2
+		};
+
+		/** Struct UniformLocations, it holds the uniform variables location
+		 * so we don't have to get them in each render call */
+		struct UniformLocations
+		{
+			GLuint mProjectionMatrix;
+			GLuint mTexturedProjectionMatrix;
+			GLuint mViewMatrix;
+			GLuint mLightType;
+			GLuint mLightIndex;
+		};
+
+	private:	// Attributes
+		/** The positions of the screen quad of the lighting pass */
+		static const GLfloat mQuadPositions[];
+
+		/** The texture unit of the depth texture of the GBuffer, the other
+		 * textures use the unit of their GBUFFER_TEXTURE_TYPE */
+		static const GLuint DEPTH_TEXTURE_UNIT = GBUFFER_NUM_TEXTURES;
+
+		/** The texture unit where the SceneBatcher binds the Textures of
+		 * the Renderable3Ds in the geometry pass */
+		static const GLuint DIFFUSE_TEXTURE_UNIT = 0;
+
+		/** The Programs of the geometry pass for the Renderable3Ds without
+		 * and with a Texture */
+		Program* mGeometryProgram;
+		Program* mTexturedGeometryProgram;
+
+		/** The Program of the lighting pass */
+		Program* mLightingProgram;
+
+		/** The locations of uniform variables in the shaders */
+		UniformLocations mUniformLocations;
+
+		/** The projection matrix of the renderer that transforms from View
+		 * Space to Projection Space */
+		glm::mat4 mProjectionMatrix;
+
+		/** Calculates the bounds of the lights for their scissor
+		 * rectangles, the same way that LightClusters does */
+		SphereProjector mLightProjector;
+
+		/** The GBuffer where the geometry pass is drawn */
+		GBuffer mGBuffer;
+
+		/** Culls, sorts and draws the submitted Renderable3Ds */
+		SceneBatcher mBatcher;
+
+		/** The data of the lights of the scene */
+		LightBuffer mLightBuffer;
+
+		/** The vertex buffer with the positions of the screen quad */
+		VertexBuffer mQuadBuffer;
+
+		/** The Vertex Array Object of the screen quad */
+		VertexArray mQuadVAO;
+
+	public:		// Functions
+		/** Creates a new DeferredRenderer
+		 *
+		 * @param	projectionMatrix the projectionMatrix of the renderer
+		 * @param	width the width of the viewport
+		 * @param	height the height of the viewport
+		 * @param	jobSystem the JobSystem used for preparing the frames */
+		DeferredRenderer(
+			const glm::mat4& projectionMatrix,
+			GLuint width, GLuint height,
+			JobSystem& jobSystem
+		);
+
+		/** Class destructor */
+		~DeferredRenderer();
+
+		/** Sets the projection matrix */
+		inline void setProjectionMatrix(const glm::mat4& projectionMatrix)
+		{
+			mProjectionMatrix = projectionMatrix;
+			mLightProjector.setProjectionMatrix(projectionMatrix);
+		};
+
+		/** Submits the given Renderable3D to the list of Renderable3Ds to
+		 * render
+		 *
+		 * @param	renderable3D a pointer to the Renderable3D that we want
+		 *			to render */
+		inline void submit(const Renderable3D* renderable3D)
+		{ mBatcher.submit(renderable3D); };
+
+		/** Submits the given Renderable3Ds to the list of Renderable3Ds to
+		 * render
+		 *
+		 * @param	renderable3Ds a vector with pointers to the
+		 *			Renderable3Ds that we want to render */
+		inline void submit(const std::vector<const Renderable3D*>& renderable3Ds)
+		{ mBatcher.submit(renderable3Ds); };
+
+		/** Renders the submitted Renderable3Ds with the given lights
+		 *
+		 * @note	after calling this method the list of submitted
+		 *			Renderable3Ds will be empty
+		 * @param	camera a pointer to the camera with which we will render
+		 *			the scene
+		 * @param	pointLights a vector with pointers to the PointLights
+		 *			that will affect to the next renders
+		 * @param	spotLights a vector with pointers to the SpotLights
+		 *			that will affect to the next renders */
+		void render(
+			const Camera* camera,
+			const std::vector<const PointLight*>& pointLights,
+			const std::vector<const SpotLight*>& spotLights
+		);
+
+		/** @return	the statistics of the last render call */
+		inline SceneBatcher::Statistics getStatistics() const
+		{ return mBatcher.getStatistics(); };
+
+		/** Sets the LOD bias of the Renderable3Ds
+		 *
+		 * @param	lodBias the factor applied to the projected sizes of the
+		 *			Renderable3Ds, values lower than 1 select simpler
+		 *			LODs and values greater than 1 more detailed ones */
+		inline void setLODBias(float lodBias)
+		{ mBatcher.setLODBias(lodBias); };
+	private:
+		/** Creates the Shaders and the Programs of the geometry and
+		 * lighting passes */
+		void initShaders();
+
+		/** Gets the location of all the uniform variables and stores them in
+		 * mUniformLocations */
+		void initUniformLocations();
+
+		/** Draws the prepared Renderable3Ds to the GBuffer */
+		void geometryPass();
+
+		/** Draws the lights to the current Frame Buffer with the data of
+		 * the GBuffer
+		 *
+		 * @param	viewMatrix the matrix that transforms from World space
+		 *			to View space
+		 * @param	pointLights a vector with pointers to the PointLights
+		 * @param	spotLights a vector with pointers to the SpotLights */
+		void lightingPass(
+			const glm::mat4& viewMatrix,
+			const std::vector<const PointLight*>& pointLights,
+			const std::vector<const SpotLight*>& spotLights
+		);
+
+		/** Draws the screen quad of the given light scissored to the bounds
+		 * of the given sphere
+		 *
+		 * @param	lightType the type of the light
+		 * @param	lightIndex the index of the light in the LightBuffer
+		 * @param	center the center of the sphere in View space
+		 * @param	radius the radius of the sphere */
+		void drawLight(
+			LightType lightType, GLint lightIndex,
+			const glm::vec3& center, float radius
+		);
+
+		/** Calculates the rectangle in window coordinates that contains the
+		 * given sphere
+		 *
+		 * @param	center the center of the sphere in View space
+		 * @param	radius the radius of the sphere
+		 * @param	rectangle the x, y, width and height of the rectangle
+		 * @return	true if the sphere is visible, false otherwise */
+		bool calculateScissor(
+			const glm::vec3& center, float radius,
+			GLint rectangle[4]
+		) const;
+	};
+
+}
+
+#endif		// DEFERRED_RENDERER_H
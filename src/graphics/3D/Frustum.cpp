@@ -0,0 +1,130 @@
+#include "Frustum.h"
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define FRUSTUM_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
+namespace graphics {
+
+	Frustum::Frustum(const glm::mat4& viewProjectionMatrix)
+	{
+		// Gribb-Hartmann plane extraction: each plane is the sum or the
+		// difference of the 4th row of the matrix with one of the other rows
+		const glm::mat4& m = viewProjectionMatrix;
+		glm::vec4 row[4];
+		for (int i = 0; i < 4; ++i) {
+			row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+		}
+
+		glm::vec4 planes[NUM_PADDED_PLANES] = {
+			row[3] + row[0],	// Left
+			row[3] - row[0],	// Right
+			row[3] + row[1],	// Bottom
+			row[3] - row[1],	// Top
+			row[3] + row[2],	// Near
+			row[3] - row[2],	// Far
+			glm::vec4(0.0f, 0.0f, 0.0f, 1.0f),	// Padding, always passes
+			glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)	// Padding, always passes
+		};
+
+		for (unsigned int i = 0; i < NUM_PADDED_PLANES; ++i) {
+			float length = glm::length(glm::vec3(planes[i]));
+			if (length > 0.0f) {
+				planes[i] /= length;
+			}
+
+			mPlanesX[i]		= planes[i].x;
+			mPlanesY[i]		= planes[i].y;
+			mPlanesZ[i]		= planes[i].z;
+			mPlanesD[i]		= planes[i].w;
+			mAbsPlanesX[i]	= std::abs(planes[i].x);
+			mAbsPlanesY[i]	= std::abs(planes[i].y);
+			mAbsPlanesZ[i]	= std::abs(planes[i].z);
+		}
+	}
+
+
+	bool Frustum::intersects(const AABB& aabb) const
+	{
+		unsigned int visibleIndex;
+		return intersects(&aabb, 1, &visibleIndex) > 0;
+	}
+
+
+	unsigned int Frustum::intersects(
+		const AABB* aabbs, unsigned int count,
+		unsigned int* visibleIndices
+	) const
+	{
+		// An AABB is outside the Frustum if it's completely behind any of
+		// its planes, that is, if the signed distance of its center to the
+		// plane is smaller than the negative of the projected radius
+		unsigned int numVisible = 0;
+
+#ifdef FRUSTUM_USE_SSE
+		const __m128 zero	= _mm_setzero_ps();
+		const __m128 half	= _mm_set1_ps(0.5f);
+		const __m128 px[]	= { _mm_load_ps(mPlanesX), _mm_load_ps(mPlanesX + 4) };
+		const __m128 py[]	= { _mm_load_ps(mPlanesY), _mm_load_ps(mPlanesY + 4) };
+		const __m128 pz[]	= { _mm_load_ps(mPlanesZ), _mm_load_ps(mPlanesZ + 4) };
+		const __m128 pd[]	= { _mm_load_ps(mPlanesD), _mm_load_ps(mPlanesD + 4) };
+		const __m128 apx[]	= { _mm_load_ps(mAbsPlanesX), _mm_load_ps(mAbsPlanesX + 4) };
+		const __m128 apy[]	= { _mm_load_ps(mAbsPlanesY), _mm_load_ps(mAbsPlanesY + 4) };
+		const __m128 apz[]	= { _mm_load_ps(mAbsPlanesZ), _mm_load_ps(mAbsPlanesZ + 4) };
+
+		for (unsigned int i = 0; i < count; ++i) {
+			const glm::vec3& maximum = aabbs[i].mMaximum;
+			const glm::vec3& minimum = aabbs[i].mMinimum;
+
+			__m128 maxX = _mm_set1_ps(maximum.x), minX = _mm_set1_ps(minimum.x);
+			__m128 maxY = _mm_set1_ps(maximum.y), minY = _mm_set1_ps(minimum.y);
+			__m128 maxZ = _mm_set1_ps(maximum.z), minZ = _mm_set1_ps(minimum.z);
+
+			__m128 cx = _mm_mul_ps(_mm_add_ps(maxX, minX), half);
+			__m128 cy = _mm_mul_ps(_mm_add_ps(maxY, minY), half);
+			__m128 cz = _mm_mul_ps(_mm_add_ps(maxZ, minZ), half);
+			__m128 ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+			__m128 ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+			__m128 ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+			int outside = 0;
+			for (int j = 0; j < 2; ++j) {
+				__m128 distance = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(px[j], cx), _mm_mul_ps(py[j], cy)),
+					_mm_add_ps(_mm_mul_ps(pz[j], cz), pd[j])
+				);
+				__m128 radius = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(apx[j], ex), _mm_mul_ps(apy[j], ey)),
+					_mm_mul_ps(apz[j], ez)
+				);
+				outside |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+			}
+
+			visibleIndices[numVisible] = i;
+			numVisible += (outside == 0);
+		}
+#else
+		for (unsigned int i = 0; i < count; ++i) {
+			glm::vec3 center	= 0.5f * (aabbs[i].mMaximum + aabbs[i].mMinimum);
+			glm::vec3 extents	= 0.5f * (aabbs[i].mMaximum - aabbs[i].mMinimum);
+
+			bool outside = false;
+			for (unsigned int j = 0; j < NUM_PLANES; ++j) {
+				float distance	= mPlanesX[j] * center.x + mPlanesY[j] * center.y
+								+ mPlanesZ[j] * center.z + mPlanesD[j];
+				float radius	= mAbsPlanesX[j] * extents.x + mAbsPlanesY[j] * extents.y
+								+ mAbsPlanesZ[j] * extents.z;
+				outside |= (distance + radius < 0.0f);
+			}
+
+			visibleIndices[numVisible] = i;
+			numVisible += !outside;
+		}
+#endif
+
+		return numVisible;
+	}
+
+}
@@ -0,0 +1,73 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <glm/glm.hpp>
+#include "AABB.h"
+
+namespace graphics {
+
+	/**
+	 * Class Frustum, it holds the 6 planes of the view volume of a camera
+	 * and it's used for discarding the elements that are outside of it
+	 */
+	class Frustum
+	{
+	private:	// Attributes
+		/** The number of planes of the Frustum */
+		static const unsigned int NUM_PLANES = 6;
+
+		/** The number of planes stored, padded to a multiple of 4 so they
+		 * can be tested in groups of 4 */
+		static const unsigned int NUM_PADDED_PLANES = 8;
+
+		/** The components of the normals of the planes and their distances
+		 * to the origin, stored as a Structure of Arrays */
+		alignas(16) float mPlanesX[NUM_PADDED_PLANES];
+		alignas(16) float mPlanesY[NUM_PADDED_PLANES];
+		alignas(16) float mPlanesZ[NUM_PADDED_PLANES];
+		alignas(16) float mPlanesD[NUM_PADDED_PLANES];
+
+		/** The absolute values of the components of the normals of the
+		 * planes */
+		alignas(16) float mAbsPlanesX[NUM_PADDED_PLANES];
+		alignas(16) float mAbsPlanesY[NUM_PADDED_PLANES];
+		alignas(16) float mAbsPlanesZ[NUM_PADDED_PLANES];
+
+	public:		// Functions
+		/** Creates a new Frustum from the given matrix
+		 *
+		 * @param	viewProjectionMatrix the matrix that transforms from
+		 *			World space to Projection space. The planes of the
+		 *			Frustum will be extracted from it in World space */
+		Frustum(const glm::mat4& viewProjectionMatrix);
+
+		/** Class destructor */
+		~Frustum() {};
+
+		/** Checks if the given AABB is inside or intersects the Frustum
+		 *
+		 * @param	aabb the AABB in World space that we want to test
+		 * @return	true if the AABB is inside or intersects the Frustum,
+		 *			false otherwise */
+		bool intersects(const AABB& aabb) const;
+
+		/** Checks which of the given AABBs are inside or intersect the
+		 * Frustum
+		 *
+		 * @param	aabbs a pointer to the AABBs in World space that we want
+		 *			to test
+		 * @param	count the number of AABBs to test
+		 * @param	visibleIndices a pointer to the array where the indices
+		 *			of the AABBs that are inside or intersect the Frustum
+		 *			are going to be stored in increasing order, it must have
+		 *			space for at least count elements
+		 * @return	the number of AABBs inside or intersecting the Frustum */
+		unsigned int intersects(
+			const AABB* aabbs, unsigned int count,
+			unsigned int* visibleIndices
+		) const;
+	};
+
+}
+
+#endif		// FRUSTUM_H
@@ -0,0 +1,75 @@
+#include "LightBuffer.h"
+#include <cmath>
+#include <cstring>
+#include "Lights.h"
+
+namespace graphics {
+
+	LightBuffer::LightBuffer() :
+		mBuffer(nullptr, MAX_POINT_LIGHTS * sizeof(PointLightData) + MAX_SPOT_LIGHTS * sizeof(SpotLightData)) {}
+
+
+	void LightBuffer::setLights(
+		const std::vector<const PointLight*>& pointLights,
+		const std::vector<const SpotLight*>& spotLights
+	) {
+		unsigned int numPointLights = (pointLights.size() > MAX_POINT_LIGHTS) ? MAX_POINT_LIGHTS : pointLights.size();
+		unsigned int numSpotLights = (spotLights.size() > MAX_SPOT_LIGHTS) ? MAX_SPOT_LIGHTS : spotLights.size();
+
+		mNewPointLightData.resize(numPointLights);
+		for (unsigned int i = 0; i < numPointLights; ++i) {
+			BaseLight base		= pointLights[i]->getBaseLight();
+			glm::vec3 position	= pointLights[i]->getPosition();
+			Attenuation att		= pointLights[i]->getAttenuation();
+
+			mNewPointLightData[i] = {
+				{ position.x, position.y, position.z },
+				base.getAmbientIntensity(), base.getIntensity(),
+				att.mConstant, att.mLinear, att.mExponential
+			};
+		}
+
+		mNewSpotLightData.resize(numSpotLights);
+		for (unsigned int i = 0; i < numSpotLights; ++i) {
+			BaseLight base		= spotLights[i]->getBase().getBaseLight();
+			glm::vec3 position	= spotLights[i]->getBase().getPosition();
+			Attenuation att		= spotLights[i]->getBase().getAttenuation();
+			glm::vec3 direction	= glm::normalize(spotLights[i]->getDirection());
+
+			mNewSpotLightData[i] = {
+				{ position.x, position.y, position.z }, base.getAmbientIntensity(),
+				{ direction.x, direction.y, direction.z }, std::cos(spotLights[i]->getCutoff()),
+				base.getIntensity(), att.mConstant, att.mLinear, att.mExponential
+			};
+		}
+
+		// Upload the data only if the lights changed
+		if ((mNewPointLightData.size() != mPointLightData.size())
+			|| (std::memcmp(mNewPointLightData.data(), mPointLightData.data(), numPointLights * sizeof(PointLightData)) != 0)
+		) {
+			mBuffer.setSubData(mNewPointLightData.data(), 0, numPointLights * sizeof(PointLightData));
+			mPointLightData.swap(mNewPointLightData);
+		}
+
+		if ((mNewSpotLightData.size() != mSpotLightData.size())
+			|| (std::memcmp(mNewSpotLightData.data(), mSpotLightData.data(), numSpotLights * sizeof(SpotLightData)) != 0)
+		) {
+			mBuffer.setSubData(mNewSpotLightData.data(), MAX_POINT_LIGHTS * sizeof(PointLightData), numSpotLights * sizeof(SpotLightData));
+			mSpotLightData.swap(mNewSpotLightData);
+		}
+	}
+
+
+	void LightBuffer::bind() const
+	{
+		mBuffer.bindBase(LIGHT_BLOCK_BINDING);
+	}
+
+
+	std::string LightBuffer::getBlockDefines()
+	{
+		return "#define MAX_POINT_LIGHTS " + std::to_string(MAX_POINT_LIGHTS) + "\n"
+			"#define MAX_SPOT_LIGHTS " + std::to_string(MAX_SPOT_LIGHTS) + "\n";
+	}
+
+}
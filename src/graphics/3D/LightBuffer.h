@@ -0,0 +1,119 @@
+#ifndef LIGHT_BUFFER_H
+#define LIGHT_BUFFER_H
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "../buffers/UniformBuffer.h"
+
+namespace graphics {
+
+	class PointLight;
+	class SpotLight;
+
+
+	/**
+	 * Class LightBuffer, it holds the data of the lights of the scene in
+	 * the light uniform block with the std140 layout, so it can be shared
+	 * by all the Programs that need it:
+	 * <br>- LightBlock: PointLight u_PointLights[MAX_POINT_LIGHTS];
+	 * SpotLight u_SpotLights[MAX_SPOT_LIGHTS], bound to
+	 * LIGHT_BLOCK_BINDING
+	 */
+	class LightBuffer
+	{
+	public:		// Nested types
+		/** The maximum number of lights of each type in the light uniform
+		 * block */
+		static const unsigned int MAX_POINT_LIGHTS = 256;
+		static const unsigned int MAX_SPOT_LIGHTS = 128;
+
+		/** The binding point of the light uniform block */
+		static const GLuint LIGHT_BLOCK_BINDING = 2;
+
+	private:	// Nested types
+		/** Struct PointLightData, it holds the data of a PointLight of the
+		 * light uniform block with the std140 layout */
+		struct PointLightData
+		{
+			/** The position of the PointLight in World space */
+			GLfloat mPosition[3];
+			GLfloat mAmbientIntensity;
+			GLfloat mIntensity;
+			GLfloat mConstant;
+			GLfloat mLinear;
+			GLfloat mExponential;
+		};
+
+		/** Struct SpotLightData, it holds the data of a SpotLight of the
+		 * light uniform block with the std140 layout */
+		struct SpotLightData
+		{
+			/** The position of the SpotLight in World space */
+			GLfloat mPosition[3];
+			GLfloat mAmbientIntensity;
+
+			/** The direction of the SpotLight in World space */
+			GLfloat mDirection[3];
+
+			/** The cosine of the cutoff angle of the SpotLight */
+			GLfloat mCosCutoff;
+			GLfloat mIntensity;
+			GLfloat mConstant;
+			GLfloat mLinear;
+			GLfloat mExponential;
+		};
+
+	private:	// Attributes
+		/** The buffer with the data of the light uniform block */
+		UniformBuffer mBuffer;
+
+		/** The data of the lights currently stored in mBuffer */
+		std::vector<PointLightData> mPointLightData;
+		std::vector<SpotLightData> mSpotLightData;
+
+		/** The data of the lights submitted in the current frame */
+		std::vector<PointLightData> mNewPointLightData;
+		std::vector<SpotLightData> mNewSpotLightData;
+
+	public:		// Functions
+		/** Creates a new LightBuffer */
+		LightBuffer();
+
+		/** Class destructor */
+		~LightBuffer() {};
+
+		/** Sets the data of the given lights. The data is only uploaded if
+		 * it changed since the last call
+		 * 
+		 * @param	pointLights a vector of pointer to the PointLights
+		 * @param	spotLights a vector of pointer to the SpotLights
+		 * @note	the maximum number of lights is MAX_POINT_LIGHTS and
+		 *			MAX_SPOT_LIGHTS, so if there are more lights in the given
+		 *			vectors only the first lights of the vectors will be
+		 *			submited */
+		void setLights(
+			const std::vector<const PointLight*>& pointLights,
+			const std::vector<const SpotLight*>& spotLights
+		);
+
+		/** @return	the number of PointLights of the light uniform block */
+		inline unsigned int getNumPointLights() const
+		{ return mPointLightData.size(); };
+
+		/** @return	the number of SpotLights of the light uniform block */
+		inline unsigned int getNumSpotLights() const
+		{ return mSpotLightData.size(); };
+
+		/** Binds the LightBuffer to the light uniform block binding point */
+		void bind() const;
+
+		/** @return	the defines of MAX_POINT_LIGHTS and MAX_SPOT_LIGHTS for
+		 *			the shaders that read the light uniform block, so its
+		 *			size isn't duplicated in them */
+		static std::string getBlockDefines();
+	};
+
+}
+
+#endif		// LIGHT_BUFFER_H
@@ -0,0 +1,151 @@
+#include "LightClusters.h"
+#include <cmath>
+#include <algorithm>
+#include "Lights.h"
+
+namespace graphics {
+
+	LightClusters::LightClusters(const glm::mat4& projectionMatrix) :
+		mProjector(projectionMatrix),
+		mClusters(NUM_CLUSTERS), mCursors(NUM_CLUSTERS)
+	{
+		setProjectionMatrix(projectionMatrix);
+	}
+
+
+	void LightClusters::setProjectionMatrix(const glm::mat4& projectionMatrix)
+	{
+		mProjector.setProjectionMatrix(projectionMatrix);
+
+		float zNear = mProjector.getZNear(), zFar = mProjector.getZFar();
+		float logRatio = std::log(zFar / zNear);
+		mZScale	= NUM_SLICES / logRatio;
+		mZBias	= -(NUM_SLICES * std::log(zNear)) / logRatio;
+	}
+
+
+	void LightClusters::build(
+		const glm::mat4& viewMatrix,
+		const PointLight* const* pointLights, unsigned int numPointLights,
+		const SpotLight* const* spotLights, unsigned int numSpotLights
+	) {
+		// 1. Calculate the range of clusters of each light in View space.
+		// Each light is processed independently of the others
+		mPointLightRanges.resize(numPointLights);
+		for (unsigned int i = 0; i < numPointLights; ++i) {
+			glm::vec3 center(viewMatrix * glm::vec4(pointLights[i]->getPosition(), 1.0f));
+			mPointLightRanges[i] = calculateRange(center, pointLights[i]->getRadius());
+		}
+
+		mSpotLightRanges.resize(numSpotLights);
+		for (unsigned int i = 0; i < numSpotLights; ++i) {
+			glm::vec3 position;
+			float radius;
+			spotLights[i]->getBoundingSphere(position, radius);
+
+			glm::vec3 center(viewMatrix * glm::vec4(position, 1.0f));
+			mSpotLightRanges[i] = calculateRange(center, radius);
+		}
+
+		// 2. Count the lights of each cluster
+		for (Cluster& cluster : mClusters) {
+			cluster.mCounts = 0;
+		}
+		for (const ClusterRange& range : mPointLightRanges) {
+			addToCounts(range, 1);
+		}
+		for (const ClusterRange& range : mSpotLightRanges) {
+			addToCounts(range, 1 << 16);
+		}
+
+		// 3. Calculate where the list of each cluster starts
+		GLuint offset = 0;
+		for (unsigned int i = 0; i < NUM_CLUSTERS; ++i) {
+			mClusters[i].mOffset	= offset;
+			mCursors[i]				= offset;
+			offset += (mClusters[i].mCounts & 0xFFFF) + (mClusters[i].mCounts >> 16);
+		}
+		mLightIndices.resize(offset);
+
+		// 4. Scatter the light indices, the point lights go before the spot
+		// lights in each list
+		for (unsigned int i = 0; i < numPointLights; ++i) {
+			addToLists(mPointLightRanges[i], i);
+		}
+		for (unsigned int i = 0; i < numSpotLights; ++i) {
+			addToLists(mSpotLightRanges[i], i);
+		}
+	}
+
+// Private functions
+	LightClusters::ClusterRange LightClusters::calculateRange(const glm::vec3& center, float radius) const
+	{
+		ClusterRange range = {};
+
+		SphereProjector::Bounds bounds;
+		if (!mProjector.project(center, radius, bounds)) {
+			range.mVisible = false;
+			return range;
+		}
+
+		const float ndcMin[2] = { bounds.mMinimum.x, bounds.mMinimum.y };
+		const float ndcMax[2] = { bounds.mMaximum.x, bounds.mMaximum.y };
+		const unsigned int numTiles[2] = { NUM_TILES_X, NUM_TILES_Y };
+		for (int i = 0; i < 2; ++i) {
+			if ((ndcMax[i] < -1.0f) || (ndcMin[i] > 1.0f)) {
+				range.mVisible = false;
+				return range;
+			}
+
+			float maxTile = static_cast<float>(numTiles[i] - 1);
+			range.mMinimum[i] = static_cast<unsigned int>(glm::clamp(std::floor((0.5f * ndcMin[i] + 0.5f) * numTiles[i]), 0.0f, maxTile));
+			range.mMaximum[i] = static_cast<unsigned int>(glm::clamp(std::floor((0.5f * ndcMax[i] + 0.5f) * numTiles[i]), 0.0f, maxTile));
+		}
+
+		range.mMinimum[2] = getSlice(bounds.mMinDepth);
+		range.mMaximum[2] = getSlice(bounds.mMaxDepth);
+		range.mVisible = true;
+
+		return range;
+	}
+
+
+	unsigned int LightClusters::getSlice(float depth) const
+	{
+		if (depth <= mProjector.getZNear()) {
+			return 0;
+		}
+
+		float slice = std::floor(std::log(depth) * mZScale + mZBias);
+		return static_cast<unsigned int>(glm::clamp(slice, 0.0f, static_cast<float>(NUM_SLICES - 1)));
+	}
+
+
+	void LightClusters::addToCounts(const ClusterRange& range, GLuint value)
+	{
+		if (!range.mVisible) return;
+
+		for (unsigned int z = range.mMinimum[2]; z <= range.mMaximum[2]; ++z) {
+			for (unsigned int y = range.mMinimum[1]; y <= range.mMaximum[1]; ++y) {
+				for (unsigned int x = range.mMinimum[0]; x <= range.mMaximum[0]; ++x) {
+					mClusters[x + NUM_TILES_X * (y + NUM_TILES_Y * z)].mCounts += value;
+				}
+			}
+		}
+	}
+
+
+	void LightClusters::addToLists(const ClusterRange& range, GLushort lightIndex)
+	{
+		if (!range.mVisible) return;
+
+		for (unsigned int z = range.mMinimum[2]; z <= range.mMaximum[2]; ++z) {
+			for (unsigned int y = range.mMinimum[1]; y <= range.mMaximum[1]; ++y) {
+				for (unsigned int x = range.mMinimum[0]; x <= range.mMaximum[0]; ++x) {
+					mLightIndices[ mCursors[x + NUM_TILES_X * (y + NUM_TILES_Y * z)]++ ] = lightIndex;
+				}
+			}
+		}
+	}
+
+}
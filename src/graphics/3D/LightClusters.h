@@ -0,0 +1,167 @@
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "SphereProjector.h"
+
+namespace graphics {
+
+	class PointLight;
+	class SpotLight;
+
+
+	/**
+	 * Class LightClusters, it splits the view frustum in a 3D grid of
+	 * clusters (NUM_TILES_X x NUM_TILES_Y tiles in screen space and
+	 * NUM_SLICES exponentially distributed slices in depth) and stores for
+	 * each cluster the lists of the lights that can affect to it, so the
+	 * shaders only have to process those lights.
+	 * <br>The lights are binned in two passes: first the range of clusters
+	 * of each light is calculated independently of the other lights, and
+	 * then the light indices are scattered to the cluster lists with a
+	 * counting sort
+	 */
+	class LightClusters
+	{
+	public:		// Nested types
+		/** The number of clusters in each dimension of the grid */
+		static const unsigned int NUM_TILES_X = 16;
+		static const unsigned int NUM_TILES_Y = 9;
+		static const unsigned int NUM_SLICES = 24;
+		static const unsigned int NUM_CLUSTERS = NUM_TILES_X * NUM_TILES_Y * NUM_SLICES;
+
+		/** Struct Cluster, it holds the location of the light lists of a
+		 * cluster in the light indices, first the point lights and then the
+		 * spot lights */
+		struct Cluster
+		{
+			/** The index of the first light index of the cluster */
+			GLuint mOffset;
+
+			/** The number of point lights in the 16 least significant bits
+			 * and the number of spot lights in the 16 most significant
+			 * ones */
+			GLuint mCounts;
+		};
+
+	private:	// Nested types
+		/** Struct ClusterRange, it holds the range of clusters that a light
+		 * can affect */
+		struct ClusterRange
+		{
+			/** The first cluster of the range in each dimension */
+			unsigned int mMinimum[3];
+
+			/** The last cluster of the range in each dimension */
+			unsigned int mMaximum[3];
+
+			/** If the light affects to any cluster or not */
+			bool mVisible;
+		};
+
+	private:	// Attributes
+		/** The object used for calculating the bounds of the lights in
+		 * NDC and depth */
+		SphereProjector mProjector;
+
+		/** The values that transforms the logarithm of the depth of a
+		 * point in View space to its slice with slice = log(depth) *
+		 * mZScale + mZBias */
+		float mZScale, mZBias;
+
+		/** The ranges of clusters of the point lights */
+		std::vector<ClusterRange> mPointLightRanges;
+
+		/** The ranges of clusters of the spot lights */
+		std::vector<ClusterRange> mSpotLightRanges;
+
+		/** The light lists of each cluster */
+		std::vector<Cluster> mClusters;
+
+		/** The light lists of all the clusters */
+		std::vector<GLushort> mLightIndices;
+
+		/** The position where the next light index of each cluster will be
+		 * stored while the light lists are being built */
+		std::vector<GLuint> mCursors;
+
+	public:		// Functions
+		/** Creates a new LightClusters
+		 *
+		 * @param	projectionMatrix the perspective projection matrix with
+		 *			which the scene is going to be rendered */
+		LightClusters(const glm::mat4& projectionMatrix);
+
+		/** Class destructor */
+		~LightClusters() {};
+
+		/** Sets the projection matrix used for calculating the clusters
+		 *
+		 * @param	projectionMatrix the new perspective projection matrix */
+		void setProjectionMatrix(const glm::mat4& projectionMatrix);
+
+		/** Builds the light lists of all the clusters
+		 *
+		 * @param	viewMatrix the matrix that transforms from World space
+		 *			to View space
+		 * @param	pointLights a pointer to the point lights, the indices
+		 *			of the lists are their positions in this array
+		 * @param	numPointLights the number of point lights
+		 * @param	spotLights a pointer to the spot lights, the indices of
+		 *			the lists are their positions in this array
+		 * @param	numSpotLights the number of spot lights */
+		void build(
+			const glm::mat4& viewMatrix,
+			const PointLight* const* pointLights, unsigned int numPointLights,
+			const SpotLight* const* spotLights, unsigned int numSpotLights
+		);
+
+		/** @return	the light lists of each cluster, the index of the
+		 *			cluster (x, y, z) is x + NUM_TILES_X * (y + NUM_TILES_Y
+		 *			* z) */
+		inline const std::vector<Cluster>& getClusters() const
+		{ return mClusters; };
+
+		/** @return	the light indices of all the clusters */
+		inline const std::vector<GLushort>& getLightIndices() const
+		{ return mLightIndices; };
+
+		/** @return	the values (scale, bias) used for calculating the slice
+		 *			of a point with its depth in View space */
+		inline glm::vec2 getZParams() const
+		{ return glm::vec2(mZScale, mZBias); };
+	private:
+		/** Calculates the range of clusters that the given sphere overlaps
+		 *
+		 * @param	center the center of the sphere in View space
+		 * @param	radius the radius of the sphere
+		 * @return	the range of clusters */
+		ClusterRange calculateRange(const glm::vec3& center, float radius) const;
+
+		/** Returns the slice of the given depth
+		 *
+		 * @param	depth the distance to the camera along the view
+		 *			direction
+		 * @return	the slice index, clamped to the valid range */
+		unsigned int getSlice(float depth) const;
+
+		/** Adds the given value to the counts of all the clusters of the
+		 * given range
+		 *
+		 * @param	range the range of clusters
+		 * @param	value the value to add to the counts */
+		void addToCounts(const ClusterRange& range, GLuint value);
+
+		/** Appends the given light index to the lists of all the clusters
+		 * of the given range
+		 *
+		 * @param	range the range of clusters
+		 * @param	lightIndex the index of the light */
+		void addToLists(const ClusterRange& range, GLushort lightIndex);
+	};
+
+}
+
+#endif		// LIGHT_CLUSTERS_H
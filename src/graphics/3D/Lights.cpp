@@ -0,0 +1,59 @@
+#include "Lights.h"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace graphics {
+
+// Static attributes
+	const float PointLight::MIN_INTENSITY = 1.0f / 256.0f;
+
+// Public functions
+	float PointLight::getRadius() const
+	{
+		// Both the ambient and the diffuse terms are attenuated, so we must
+		// use the largest one
+		float intensity = std::max(mBase.getAmbientIntensity(), mBase.getIntensity());
+
+		// Solve intensity / (constant + linear * d + exponential * d^2)
+		// = MIN_INTENSITY for d
+		float c = mAttenuation.mConstant - intensity / MIN_INTENSITY;
+		if (c >= 0.0f) {
+			return 0.0f;
+		}
+
+		if (mAttenuation.mExponential > 0.0f) {
+			float a = mAttenuation.mExponential, b = mAttenuation.mLinear;
+			return (-b + std::sqrt(b * b - 4.0f * a * c)) / (2.0f * a);
+		}
+		else if (mAttenuation.mLinear > 0.0f) {
+			return -c / mAttenuation.mLinear;
+		}
+
+		return std::numeric_limits<float>::max();
+	}
+
+
+
+	void SpotLight::getBoundingSphere(glm::vec3& center, float& radius) const
+	{
+		center = mBase.getPosition();
+		radius = mBase.getRadius();
+		if (radius >= std::numeric_limits<float>::max()) {
+			return;
+		}
+
+		glm::vec3 direction = glm::normalize(mDirection);
+		if (mCutoff > 0.25f * glm::radians(180.0f)) {
+			// The sphere is centered in the base of the cone
+			center	= center + direction * (radius * std::cos(mCutoff));
+			radius	= radius * std::sin(mCutoff);
+		}
+		else {
+			// The sphere passes through the apex and the base of the cone
+			radius	= radius / (2.0f * std::cos(mCutoff));
+			center	= center + direction * radius;
+		}
+	}
+
+}
@@ -112,6 +112,14 @@ namespace graphics {
 		 * @param	position the new position of the Light */
 		inline void setPosition(const glm::vec3& position)
 		{ mPosition = position; };
+
+		/** @return	the distance from the position of the light at which
+		 *			its attenuated intensity falls below MIN_INTENSITY, so
+		 *			it can be ignored */
+		float getRadius() const;
+
+		/** The intensity below which the light is considered negligible */
+		static const float MIN_INTENSITY;
 	};
 
 
@@ -124,7 +132,7 @@ namespace graphics {
 	class SpotLight
 	{
 	private:	// Attributes
-		const PointLight mBase;
+		PointLight mBase;
 		glm::vec3 mDirection;
 		float mCutoff;
 
@@ -132,13 +140,45 @@ namespace graphics {
 		/** Creates a new SpotLight
 		 *
 		 * @param	baseLight the basis PointLight of the SpotLight
-		 * @param	direction the direction of the SpotLight */
+		 * @param	direction the direction of the SpotLight
+		 * @param	cutoff the angle in radians between the direction and
+		 *			the border of the cone of the SpotLight */
 		SpotLight(
-			const PointLight& baseLight, const glm::vec3& direction
-		) : mBase(baseLight), mDirection(direction) {};
+			const PointLight& baseLight, const glm::vec3& direction,
+			float cutoff
+		) : mBase(baseLight), mDirection(direction), mCutoff(cutoff) {};
 
 		/** Class destructor */
 		~SpotLight() {};
+
+		/** @return the basis PointLight of the SpotLight */
+		inline const PointLight& getBase() const { return mBase; };
+
+		/** @return the direction of the SpotLight */
+		inline glm::vec3 getDirection() const { return mDirection; };
+
+		/** Sets the direction of the SpotLight
+		 * 
+		 * @param	direction the new direction of the SpotLight */
+		inline void setDirection(const glm::vec3& direction)
+		{ mDirection = direction; };
+
+		/** @return the angle in radians between the direction and the
+		 * border of the cone of the SpotLight */
+		inline float getCutoff() const { return mCutoff; };
+
+		/** Sets the position of the SpotLight
+		 * 
+		 * @param	position the new position of the SpotLight */
+		inline void setPosition(const glm::vec3& position)
+		{ mBase.setPosition(position); };
+
+		/** Calculates the smallest sphere that contains the cone of the
+		 * SpotLight up to the radius of its basis PointLight
+		 *
+		 * @param	center the center of the sphere in World space
+		 * @param	radius the radius of the sphere */
+		void getBoundingSphere(glm::vec3& center, float& radius) const;
 	};
 
 }
@@ -4,6 +4,7 @@
 #include <vector>
 #include <string>
 #include "../PrimitiveTypes.h"
+#include "../../utils/IDGenerator.h"
 
 namespace graphics {
 
@@ -14,6 +15,9 @@ namespace graphics {
 	class Material
 	{
 	protected:	// Attributes
+		/** The unique identifier of the Material */
+		unsigned int mID;
+
 		/** The name of the Material */
 		std::string mName;
 
@@ -43,7 +47,8 @@ namespace graphics {
 			const RGBColor& diffuseColor,
 			const RGBColor& specularColor,
 			float shininess
-		) : mName(name),
+		) : mID(IDGenerator<Material>::nextID()),
+			mName(name),
 			mAmbientColor(ambientColor),
 			mDiffuseColor(diffuseColor),
 			mSpecularColor(specularColor),
@@ -52,6 +57,9 @@ namespace graphics {
 		/** Class destructor */
 		~Material() {};
 
+		/** @return the unique identifier of the Material */
+		inline unsigned int getID() const { return mID; };
+
 		/** @return the ambient color of the Material */
 		inline RGBColor getAmbientColor() const { return mAmbientColor; };
 
@@ -1,32 +1,51 @@
 #include "Mesh.h"
-#include "../buffers/VertexBuffer.h"
-#include "../buffers/IndexBuffer.h"
-#include "../buffers/VertexArray.h"
+#include <limits>
+#include <algorithm>
+#include "../../utils/IDGenerator.h"
 
 namespace graphics {
 
 	Mesh::Mesh(
 		const std::string& name,
-		std::vector<VertexBufferUPtr> vbos,
-		IndexBufferUPtr ibo, VertexArrayUPtr vao
-	) : mName(name),
-		mVBOs(std::move(vbos)),
-		mIBO(std::move(ibo)),
-		mVAO(std::move(vao)) {}
-	
-	
-	Mesh::~Mesh() {}
-
-
-	unsigned int Mesh::getIndexCount() const
+		MeshBufferPool& pool, unsigned int rangeID
+	) : mID(IDGenerator<Mesh>::nextID()),
+		mName(name),
+		mPool(pool)
 	{
-		return mIBO->getIndexCount();
+		mLODs.push_back({ rangeID, std::numeric_limits<float>::max() });
 	}
 
 
-	void Mesh::bindVAO() const
+	Mesh::~Mesh()
 	{
-		mVAO->bind();
+		for (const LOD& lod : mLODs) {
+			mPool.removeMesh(lod.mRangeID);
+		}
+	}
+
+
+	bool Mesh::addLOD(unsigned int rangeID, float screenSize)
+	{
+		if (mLODs.size() >= MAX_LODS) {
+			return false;
+		}
+
+		// The screen sizes must decrease with each LOD
+		mLODs.push_back({ rangeID, std::min(screenSize, mLODs.back().mScreenSize) });
+		return true;
+	}
+
+
+	std::size_t Mesh::getGPUSize() const
+	{
+		std::size_t size = 0;
+		for (const LOD& lod : mLODs) {
+			const MeshBufferPool::Range& range = mPool.getRange(lod.mRangeID);
+			size += range.mNumVertices * mPool.getFormat().mStride
+				+ range.mIndexCount * sizeof(GLushort);
+		}
+
+		return size;
 	}
 
 }
@@ -1,73 +1,137 @@
 #ifndef MESH_H
 #define MESH_H
 
-#include <memory>
-#include <vector>
 #include <string>
+#include <cstddef>
+#include <vector>
 #include "AABB.h"
+#include "../buffers/MeshBufferPool.h"
 
 namespace graphics {
 
-	class VertexBuffer;
-	class IndexBuffer;
-	class VertexArray;
-
-
 	/**
-	 * Class Mesh, it holds the vertex, indices and the weights of its
-	 * bones. Also it holds the indices to its buffers
+	 * Class Mesh, it holds the ID of the Range of the vertices and indices
+	 * of a Mesh inside of the MeshBufferPool where they are stored. The
+	 * data is removed from the MeshBufferPool when the Mesh is destroyed.
+	 * <br>The Mesh can also have a chain of simplified levels of detail
+	 * (LODs), each one with its own range of indices that reference the
+	 * vertices of the first LOD. Each LOD is used when the projected size
+	 * of the Mesh falls below its screen size
 	 */
 	class Mesh
 	{
-	private:	// Nested Types
-		typedef std::unique_ptr<VertexBuffer> VertexBufferUPtr;
-		typedef std::unique_ptr<IndexBuffer> IndexBufferUPtr;
-		typedef std::unique_ptr<VertexArray> VertexArrayUPtr;
+	public:		// Nested types
+		/** The maximum number of LODs of a Mesh, including the first
+		 * one */
+		static const unsigned int MAX_LODS = 4;
+
+	private:	// Nested types
+		/** Struct LOD, it holds a level of detail of the Mesh */
+		struct LOD
+		{
+			/** The ID of the Range of the indices of the LOD */
+			unsigned int mRangeID;
+
+			/** The projected size of the bounding sphere of the Mesh
+			 * relative to the height of the screen below which the LOD
+			 * can be used */
+			float mScreenSize;
+		};
 
 	private:	// Attributes
+		/** The unique identifier of the Mesh */
+		const unsigned int mID;
+
 		/** The name of the Mesh */
 		const std::string mName;
 
-		/** The vertex buffers of the Mesh */
-		std::vector<VertexBufferUPtr> mVBOs;
-
-		/** The IBO of the Mesh */
-		IndexBufferUPtr mIBO;
+		/** The MeshBufferPool that holds the data of the Mesh */
+		MeshBufferPool& mPool;
 
-		/** The VAO of the Mesh */
-		VertexArrayUPtr mVAO;
+		/** The LODs of the Mesh, the first one is the Range with the
+		 * vertices and the original indices of the Mesh */
+		std::vector<LOD> mLODs;
 
-		/** The bounds of the Mesh in global space stored as an AABB */
+		/** The bounds of the Mesh in local space stored as an AABB */
 		AABB mBounds;
 
 	public:		// Functions
 		/** Creates a new Mesh from the given data
 		 *
 		 * @param	name the name of the Mesh
-		 * @param	vbos the vertex buffers that coint all the vertex data of
-		 *			the mesh
-		 * @param	ibo the IBO of the mesh that cointains the data of the
-		 *			faces of the mesh
-		 * @param	vao the VAO of the mesh
-		 * @note	the vertexBuffers must be already bound to the VAO with its
-		 *			respective attribute indices */
+		 * @param	pool the MeshBufferPool that holds the data of the Mesh
+		 * @param	rangeID the ID of the Range of the data of the Mesh in
+		 *			the MeshBufferPool
+		 * @note	the MeshBufferPool must outlive the Mesh */
 		Mesh(
 			const std::string& name,
-			std::vector<VertexBufferUPtr> vbos,
-			IndexBufferUPtr ibo, VertexArrayUPtr vao
+			MeshBufferPool& pool, unsigned int rangeID
 		);
 
-		/** Class destructor */
+		/** Class destructor, it removes the data of the Mesh and its LODs
+		 * from its MeshBufferPool */
 		~Mesh();
 
+		/** Adds a new LOD to the Mesh, it must be simpler than the previous
+		 * ones
+		 *
+		 * @param	rangeID the ID of the Range of the indices of the LOD in
+		 *			the MeshBufferPool of the Mesh, they must be relative to
+		 *			the base vertex of the Mesh
+		 * @param	screenSize the projected size of the bounding sphere of
+		 *			the Mesh relative to the height of the screen below
+		 *			which the LOD can be used
+		 * @return	true if the LOD was added, false if the Mesh already
+		 *			has MAX_LODS LODs */
+		bool addLOD(unsigned int rangeID, float screenSize);
+
+		/** @return	the number of LODs of the Mesh, including the first
+		 *			one */
+		inline unsigned int getNumLODs() const { return mLODs.size(); };
+
+		/** Returns the projected size below which the given LOD can be
+		 * used
+		 *
+		 * @param	lod the index of the LOD
+		 * @return	the screen size of the LOD */
+		inline float getLODScreenSize(unsigned int lod) const
+		{ return mLODs[lod].mScreenSize; };
+
+		/** @return the unique identifier of the Mesh */
+		inline unsigned int getID() const { return mID; };
+
 		/** @return the name of the Mesh */
-		inline std::string getName() const { return mName; };
+		inline const std::string& getName() const { return mName; };
+
+		/** @return the MeshBufferPool that holds the data of the Mesh */
+		inline const MeshBufferPool& getPool() const { return mPool; };
+
+		/** @return the index of the first vertex of the Mesh in its
+		 * MeshBufferPool */
+		inline GLint getBaseVertex() const
+		{ return mPool.getRange(mLODs.front().mRangeID).mBaseVertex; };
+
+		/** Returns the index of the first index of a LOD of the Mesh in its
+		 * MeshBufferPool
+		 *
+		 * @param	lod the index of the LOD
+		 * @return	the first index of the LOD */
+		inline unsigned int getFirstIndex(unsigned int lod = 0) const
+		{ return mPool.getRange(mLODs[lod].mRangeID).mFirstIndex; };
+
+		/** Returns the number of indices of the faces of a LOD of the Mesh
+		 *
+		 * @param	lod the index of the LOD
+		 * @return	the index count of the LOD */
+		inline unsigned int getIndexCount(unsigned int lod = 0) const
+		{ return mPool.getRange(mLODs[lod].mRangeID).mIndexCount; };
 
-		/** @return the number of Indices of the faces of the Mesh */
-		unsigned int getIndexCount() const;
+		/** @return	the size in bytes of the vertices and indices of the
+		 *			Mesh and its LODs in the GPU */
+		std::size_t getGPUSize() const;
 
 		/** @return a struct AABB with the maximum and minimum coordinates in
-		 * Global Space of the vertices of the mesh in each axis */
+		 * Local Space of the vertices of the mesh in each axis */
 		inline AABB getBounds() const { return mBounds; };
 
 		/** Sets the bounds of the Mesh
@@ -75,8 +139,8 @@ namespace graphics {
 		 * @param	bounds the new bounds of the Mesh stored as an AABB */
 		inline void setBounds(const AABB& bounds) { mBounds = bounds; };
 
-		/** Binds the VAO of the Mesh */
-		void bindVAO() const;
+		/** Binds the VAO of the MeshBufferPool of the Mesh */
+		inline void bindVAO() const { mPool.bind(); };
 	};
 
 }
@@ -0,0 +1,141 @@
+#include "RenderQueue.h"
+#include <cstring>
+#include "Renderable3D.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "../Texture.h"
+
+namespace graphics {
+
+	void RenderQueue::submit(
+		const Renderable3D* renderable3D,
+		const glm::mat4& modelViewMatrix,
+		float depth, unsigned int lod
+	) {
+		Command command = createCommand(renderable3D, modelViewMatrix, depth, lod);
+		submit(&command, 1);
+	}
+
+
+	void RenderQueue::submit(const Command* commands, unsigned int count)
+	{
+		mSortedEntries.reserve(mSortedEntries.size() + count);
+		mCommands.reserve(mCommands.size() + count);
+
+		for (unsigned int i = 0; i < count; ++i) {
+			mSortedEntries.push_back({ commands[i].mKey, static_cast<unsigned int>(mCommands.size()) });
+			mCommands.push_back(commands[i]);
+		}
+	}
+
+
+	void RenderQueue::sort()
+	{
+		if (mSortedEntries.empty()) return;
+
+		const unsigned int numEntries = mSortedEntries.size();
+		const unsigned int numDigits = sizeof(std::uint64_t);
+
+		// Calculate the histograms of all the digits at once
+		unsigned int histograms[numDigits][256] = {};
+		for (const SortEntry& entry : mSortedEntries) {
+			for (unsigned int digit = 0; digit < numDigits; ++digit) {
+				++histograms[digit][(entry.mKey >> (8 * digit)) & 0xFF];
+			}
+		}
+
+		// Sort by each byte from the least significant to the most one
+		mAuxEntries.resize(numEntries);
+		for (unsigned int digit = 0; digit < numDigits; ++digit) {
+			unsigned int* histogram = histograms[digit];
+
+			// Skip the digits where all the keys have the same byte
+			unsigned int firstByte = (mSortedEntries.front().mKey >> (8 * digit)) & 0xFF;
+			if (histogram[firstByte] == numEntries) {
+				continue;
+			}
+
+			unsigned int offset = 0;
+			for (unsigned int i = 0; i < 256; ++i) {
+				unsigned int count = histogram[i];
+				histogram[i] = offset;
+				offset += count;
+			}
+
+			for (const SortEntry& entry : mSortedEntries) {
+				mAuxEntries[ histogram[(entry.mKey >> (8 * digit)) & 0xFF]++ ] = entry;
+			}
+
+			mSortedEntries.swap(mAuxEntries);
+		}
+	}
+
+
+	void RenderQueue::clear()
+	{
+		mCommands.clear();
+		mSortedEntries.clear();
+	}
+
+
+	RenderQueue::Command RenderQueue::createCommand(
+		const Renderable3D* renderable3D,
+		const glm::mat4& modelViewMatrix,
+		float depth, unsigned int lod
+	) {
+		const Material* material	= renderable3D->getMaterial().get();
+		const Texture* texture		= renderable3D->getTexture().get();
+
+		Pass pass				= renderable3D->hasTransparency()? TRANSPARENT_PASS : OPAQUE_PASS;
+		unsigned int materialID	= (material)? material->getID() + 1 : 0;
+		unsigned int textureID	= (texture)? texture->getID() + 1 : 0;
+		unsigned int meshID		= renderable3D->getMesh()->getID() + 1;
+
+		std::uint64_t key = calculateKey(pass, materialID, textureID, meshID, lod, depth);
+		return { key, renderable3D, lod, modelViewMatrix };
+	}
+
+
+	RenderQueue::Pass RenderQueue::getPass(std::uint64_t key)
+	{
+		return static_cast<Pass>(key >> (64 - PASS_BITS));
+	}
+
+// Private functions
+	std::uint64_t RenderQueue::calculateKey(
+		Pass pass,
+		unsigned int materialID, unsigned int textureID,
+		unsigned int meshID, unsigned int lod, float depth
+	) {
+		const std::uint64_t idMask = (1 << ID_BITS) - 1;
+		const std::uint64_t lodMask = (1 << LOD_BITS) - 1;
+		static_assert(Mesh::MAX_LODS <= (1 << LOD_BITS), "The LODs of the Meshes must fit in the keys");
+
+		// The bit representation of the positive floats keeps their order,
+		// so we can use its most significant bits as the quantized depth
+		std::uint32_t depthBits = 0;
+		if (depth > 0.0f) {
+			std::memcpy(&depthBits, &depth, sizeof(float));
+		}
+		std::uint64_t quantizedDepth = depthBits >> (31 - DEPTH_BITS);
+
+		std::uint64_t ids	= ((textureID & idMask) << (2 * ID_BITS + LOD_BITS))
+							| ((materialID & idMask) << (ID_BITS + LOD_BITS))
+							| ((meshID & idMask) << LOD_BITS)
+							| (lod & lodMask);
+
+		std::uint64_t key = static_cast<std::uint64_t>(pass) << (64 - PASS_BITS);
+		if (pass == TRANSPARENT_PASS) {
+			// Back to front
+			std::uint64_t invertedDepth = ((1 << DEPTH_BITS) - 1) - quantizedDepth;
+			key |= (invertedDepth << (3 * ID_BITS + LOD_BITS)) | ids;
+		}
+		else {
+			// Front to back
+			key |= (ids << DEPTH_BITS) | quantizedDepth;
+		}
+
+		return key;
+	}
+
+}
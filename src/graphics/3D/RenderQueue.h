@@ -0,0 +1,172 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <vector>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace graphics {
+
+	class Renderable3D;
+
+
+	/**
+	 * Class RenderQueue, it holds the Renderable3Ds to draw in a frame
+	 * sorted by a 64-bit key, so the Renderable3Ds that share the same
+	 * GL state are drawn one after the other.
+	 * <br>The bits of the key are (from most to least significant):
+	 * <br>- Opaque pass: pass (2) | texture (14) | material (14) |
+	 * mesh (14) | LOD (2) | depth front to back (18)
+	 * <br>- Transparent pass: pass (2) | depth back to front (18) |
+	 * texture (14) | material (14) | mesh (14) | LOD (2)
+	 * <br>The Texture is the most significant ID because it's the only
+	 * one that requires a GL state change, the Material is read from the
+	 * per object data
+	 */
+	class RenderQueue
+	{
+	public:		// Nested types
+		/** The passes in which the Renderable3Ds are drawn, in order */
+		enum Pass
+		{
+			OPAQUE_PASS = 0,
+			TRANSPARENT_PASS = 1
+		};
+
+		/** Struct Command, it holds all the data needed for drawing a
+		 * Renderable3D */
+		struct Command
+		{
+			/** The sort key of the Command */
+			std::uint64_t mKey;
+
+			/** The Renderable3D to draw */
+			const Renderable3D* mRenderable3D;
+
+			/** The LOD of the Mesh of the Renderable3D to draw */
+			unsigned int mLOD;
+
+			/** The matrix that transforms from the Local space of the
+			 * Renderable3D to View space */
+			glm::mat4 mModelViewMatrix;
+		};
+
+	private:	// Nested types
+		/** Struct SortEntry, it's the data that is moved while sorting,
+		 * the key and the index of its Command */
+		struct SortEntry
+		{
+			std::uint64_t mKey;
+			unsigned int mIndex;
+		};
+
+	private:	// Attributes
+		/** The number of bits of each field of the keys */
+		static const unsigned int PASS_BITS = 2;
+		static const unsigned int ID_BITS = 14;
+		static const unsigned int LOD_BITS = 2;
+		static const unsigned int DEPTH_BITS = 18;
+
+		/** The Commands in submission order */
+		std::vector<Command> mCommands;
+
+		/** The keys and indices of the Commands in sorted order */
+		std::vector<SortEntry> mSortedEntries;
+
+		/** The auxiliar buffer used by the radix sort */
+		std::vector<SortEntry> mAuxEntries;
+
+	public:		// Functions
+		/** Creates a new RenderQueue */
+		RenderQueue() {};
+
+		/** Class destructor */
+		~RenderQueue() {};
+
+		/** Submits the given Renderable3D to the RenderQueue
+		 *
+		 * @param	renderable3D a pointer to the Renderable3D to draw, it
+		 *			must have a Mesh
+		 * @param	modelViewMatrix the matrix that transforms from the
+		 *			Local space of the Renderable3D to View space
+		 * @param	depth the distance in View space from the camera to the
+		 *			Renderable3D
+		 * @param	lod the LOD of the Mesh of the Renderable3D to draw */
+		void submit(
+			const Renderable3D* renderable3D,
+			const glm::mat4& modelViewMatrix,
+			float depth, unsigned int lod = 0
+		);
+
+		/** Submits the given Commands to the RenderQueue
+		 *
+		 * @param	commands a pointer to the Commands created with
+		 *			createCommand
+		 * @param	count the number of Commands to submit */
+		void submit(const Command* commands, unsigned int count);
+
+		/** Sorts the submitted Commands by their keys with a LSD radix
+		 * sort */
+		void sort();
+
+		/** Removes all the Commands from the RenderQueue */
+		void clear();
+
+		/** @return	the number of Commands in the RenderQueue */
+		inline unsigned int size() const { return mSortedEntries.size(); };
+
+		/** @return	true if there aren't Commands in the RenderQueue */
+		inline bool empty() const { return mSortedEntries.empty(); };
+
+		/** Returns the Command at the given position
+		 *
+		 * @param	i the position of the Command in the queue. If sort was
+		 *			called it's the position in sorted order
+		 * @return	a reference to the Command */
+		inline const Command& operator[](unsigned int i) const
+		{ return mCommands[ mSortedEntries[i].mIndex ]; };
+
+		/** Creates the Command for drawing the given Renderable3D. It
+		 * doesn't modify any RenderQueue, so it can be called from any
+		 * thread
+		 *
+		 * @param	renderable3D a pointer to the Renderable3D to draw, it
+		 *			must have a Mesh
+		 * @param	modelViewMatrix the matrix that transforms from the
+		 *			Local space of the Renderable3D to View space
+		 * @param	depth the distance in View space from the camera to the
+		 *			Renderable3D
+		 * @param	lod the LOD of the Mesh of the Renderable3D to draw
+		 * @return	the Command */
+		static Command createCommand(
+			const Renderable3D* renderable3D,
+			const glm::mat4& modelViewMatrix,
+			float depth, unsigned int lod = 0
+		);
+
+		/** Returns the pass of the given key
+		 *
+		 * @param	key the key of a Command
+		 * @return	the pass of the Command */
+		static Pass getPass(std::uint64_t key);
+	private:
+		/** Calculates the sort key with the given data
+		 *
+		 * @param	pass the Pass of the Renderable3D
+		 * @param	materialID the ID of its Material
+		 * @param	textureID the ID of its Texture
+		 * @param	meshID the ID of its Mesh
+		 * @param	lod the LOD of its Mesh
+		 * @param	depth the distance in View space from the camera to the
+		 *			Renderable3D
+		 * @return	the sort key */
+		static std::uint64_t calculateKey(
+			Pass pass,
+			unsigned int materialID, unsigned int textureID,
+			unsigned int meshID, unsigned int lod, float depth
+		);
+	};
+
+}
+
+#endif		// RENDER_QUEUE_H
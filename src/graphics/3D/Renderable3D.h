@@ -66,13 +66,13 @@ namespace graphics {
 		{ mTransparency = transparency; };
 
 		/** @return a pointer to the Mesh of the Renderable3D */
-		inline const MeshSPtr getMesh() const { return mMesh; };
+		inline const MeshSPtr& getMesh() const { return mMesh; };
 
 		/** @return a pointer to the Material of the Renderable3D */
-		inline const MaterialSPtr getMaterial() const { return mMaterial; };
+		inline const MaterialSPtr& getMaterial() const { return mMaterial; };
 
 		/** @return a pointer to the Texture of the Renderable3D */
-		inline const TextureSPtr getTexture() const { return mTexture; };
+		inline const TextureSPtr& getTexture() const { return mTexture; };
 
 		/** @return the model matrix of the Renderable3D */
 		inline glm::mat4 getModelMatrix() const { return mModelMatrix; };
@@ -0,0 +1,438 @@
+#include "SceneBatcher.h"
+#include <limits>
+#include <algorithm>
+#include "../Texture.h"
+#include "Renderable3D.h"
+#include "Material.h"
+#include "Mesh.h"
+#include "Frustum.h"
+#include "../GLStateCache.h"
+#include "../buffers/MeshBufferPool.h"
+
+namespace graphics {
+
+	static_assert(
+		MeshBufferPool::MAX_INSTANCES >= SceneBatcher::MAX_OBJECTS,
+		"The instance attribute must be able to index all the objects of a range"
+	);
+
+
+	SceneBatcher::SceneBatcher(JobSystem& jobSystem) :
+		mJobSystem(jobSystem),
+		mLODBias(1.0f), mLODHysteresis(0.1f),
+		mUseMultiDrawIndirect(GLEW_ARB_multi_draw_indirect && GLEW_ARB_base_instance),
+		mObjectBuffer(nullptr, MAX_OBJECTS * sizeof(ObjectData)),
+		mMaterialBuffer(nullptr, MAX_MATERIALS * sizeof(MaterialData)),
+		mStatistics() {}
+
+
+	void SceneBatcher::prepare(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix)
+	{
+		// Cull the Renderable3Ds and create their Commands in parallel,
+		// each Job writes to its own CommandBuffer
+		Frustum frustum(projectionMatrix * viewMatrix);
+		float projectionScale = projectionMatrix[1][1];
+
+		const unsigned int numRenderable3Ds = mRenderable3Ds.size();
+		const unsigned int numJobs = (numRenderable3Ds + RENDERABLES_PER_JOB - 1) / RENDERABLES_PER_JOB;
+		if (mCommandBuffers.size() < numJobs) {
+			mCommandBuffers.resize(numJobs);
+		}
+
+		mJobSystem.parallelFor(
+			0, numRenderable3Ds, RENDERABLES_PER_JOB,
+			[&](unsigned int first, unsigned int last) {
+				CommandBuffer& commandBuffer = mCommandBuffers[first / RENDERABLES_PER_JOB];
+				prepareCommands(frustum, viewMatrix, projectionScale, first, last, commandBuffer);
+			}
+		);
+		mRenderable3Ds.clear();
+
+		// Merge the CommandBuffers in submission order and sort them by
+		// their GL state, remembering the LODs of the visible
+		// Renderable3Ds for the next frame
+		mRenderQueue.clear();
+		mLODs.clear();
+		mStatistics.mNumCulled = 0;
+		for (unsigned int i = 0; i < numJobs; ++i) {
+			const CommandBuffer& commandBuffer = mCommandBuffers[i];
+			mRenderQueue.submit(commandBuffer.mCommands.data(), commandBuffer.mCommands.size());
+			mStatistics.mNumCulled += commandBuffer.mNumCulled;
+
+			for (const RenderQueue::Command& command : commandBuffer.mCommands) {
+				mLODs[command.mRenderable3D] = command.mLOD;
+			}
+		}
+		mRenderQueue.sort();
+
+		mStatistics.mNumDrawn			= mRenderQueue.size();
+		mStatistics.mNumStateChanges	= 0;
+
+		// Upload the per object and Material data of the whole frame. The
+		// object buffer is padded so the last range can be bound with the
+		// full size of the uniform block
+		buildDrawCalls();
+		mObjectBuffer.resize((mObjects.size() + MAX_OBJECTS) * sizeof(ObjectData));
+		mObjectBuffer.setSubData(mObjects.data(), 0, mObjects.size() * sizeof(ObjectData));
+		mMaterialBuffer.setSubData(mMaterials.data(), 0, mMaterials.size() * sizeof(MaterialData));
+
+		if (mUseMultiDrawIndirect) {
+			buildMultiDraws();
+			mIndirectBuffer.setData(mIndirectCommands.data(), mIndirectCommands.size() * sizeof(DrawElementsIndirectCommand));
+			mStatistics.mNumDrawCalls = mMultiDraws.size();
+		}
+		else {
+			mStatistics.mNumDrawCalls = mDrawCalls.size();
+		}
+	}
+
+
+	void SceneBatcher::draw(const TextureCallback& textureCallback)
+	{
+		mMaterialBuffer.bindBase(MATERIAL_BLOCK_BINDING);
+
+		GLStateCache::enable(GL_DEPTH_TEST);
+		GLStateCache::setDepthFunction(GL_LEQUAL);
+		GLStateCache::disable(GL_BLEND);
+
+		// Draw the visible Renderable3Ds changing the GL state only when
+		// it differs from the one of the previous draw. The state is left
+		// bound after the last draw, so the next frame can reuse it
+		RenderQueue::Pass lastPass		= RenderQueue::OPAQUE_PASS;
+		const Texture* lastTexture		= nullptr;
+		const MeshBufferPool* lastPool	= nullptr;
+		bool firstDraw					= true;
+
+		auto setState = [&](const DrawCall& drawCall) {
+			const RenderQueue::Command& command = mRenderQueue[drawCall.mFirstCommand];
+			const Renderable3D* renderable3D = command.mRenderable3D;
+
+			const Mesh* mesh		= renderable3D->getMesh().get();
+			const Texture* texture	= renderable3D->getTexture().get();
+
+			RenderQueue::Pass pass = RenderQueue::getPass(command.mKey);
+			if (pass != lastPass) {
+				GLStateCache::enable(GL_BLEND);
+				GLStateCache::setBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				lastPass = pass;
+			}
+
+			bool textureChanged = (texture != lastTexture);
+			if (textureChanged) {
+				if (texture) {
+					texture->bind(0);
+				}
+				else {
+					lastTexture->unbind(0);
+				}
+				lastTexture = texture;
+				++mStatistics.mNumStateChanges;
+			}
+			if (textureCallback && (textureChanged || firstDraw)) {
+				textureCallback(texture);
+			}
+			firstDraw = false;
+
+			if (&mesh->getPool() != lastPool) {
+				mesh->bindVAO();
+				lastPool = &mesh->getPool();
+				++mStatistics.mNumStateChanges;
+			}
+
+			// The instances read their data from the bound range of
+			// objects with their instance index plus the base instance
+			mObjectBuffer.bindRange(
+				OBJECT_BLOCK_BINDING,
+				drawCall.mFirstObject * sizeof(ObjectData),
+				MAX_OBJECTS * sizeof(ObjectData)
+			);
+		};
+
+		if (mUseMultiDrawIndirect) {
+			mIndirectBuffer.bind();
+
+			for (const MultiDraw& multiDraw : mMultiDraws) {
+				setState(mDrawCalls[multiDraw.mFirstDrawCall]);
+				glMultiDrawElementsIndirect(
+					GL_TRIANGLES, GL_UNSIGNED_SHORT,
+					reinterpret_cast<const GLvoid*>(multiDraw.mFirstDrawCall * sizeof(DrawElementsIndirectCommand)),
+					multiDraw.mNumDrawCalls, 0
+				);
+			}
+		}
+		else {
+			for (const DrawCall& drawCall : mDrawCalls) {
+				const RenderQueue::Command& command = mRenderQueue[drawCall.mFirstCommand];
+				const Mesh* mesh = command.mRenderable3D->getMesh().get();
+
+				setState(drawCall);
+				glDrawElementsInstancedBaseVertex(
+					GL_TRIANGLES, mesh->getIndexCount(command.mLOD), GL_UNSIGNED_SHORT,
+					reinterpret_cast<const GLvoid*>(mesh->getFirstIndex(command.mLOD) * sizeof(GLushort)),
+					drawCall.mNumInstances, mesh->getBaseVertex()
+				);
+			}
+		}
+	}
+
+
+	SceneBatcher::MaterialData SceneBatcher::createMaterialData(const Material* material)
+	{
+		RGBColor ambientColor = { 1.0f, 1.0f, 1.0f }, diffuseColor = { 1.0f, 1.0f, 1.0f }, specularColor = { 1.0f, 1.0f, 1.0f };
+		float shininess = 1.0f;
+		if (material) {
+			ambientColor	= material->getAmbientColor();
+			diffuseColor	= material->getDiffuseColor();
+			specularColor	= material->getSpecularColor();
+			shininess		= material->getShininess();
+		}
+
+		return {
+			{ ambientColor.r, ambientColor.g, ambientColor.b }, 0.0f,
+			{ diffuseColor.r, diffuseColor.g, diffuseColor.b }, 0.0f,
+			{ specularColor.r, specularColor.g, specularColor.b }, shininess
+		};
+	}
+
+	std::string SceneBatcher::getBlockDefines()
+	{
+		return "#define MAX_OBJECTS " + std::to_string(MAX_OBJECTS) + "\n"
+			"#define MAX_MATERIALS " + std::to_string(MAX_MATERIALS) + "\n";
+	}
+
+// Private functions
+	void SceneBatcher::prepareCommands(
+		const Frustum& frustum, const glm::mat4& viewMatrix,
+		float projectionScale,
+		unsigned int first, unsigned int last,
+		CommandBuffer& commandBuffer
+	) const {
+		commandBuffer.mCommands.clear();
+		commandBuffer.mCandidates.clear();
+		commandBuffer.mCandidateBounds.clear();
+
+		// Calculate the World space bounds of the Renderable3Ds
+		for (unsigned int i = first; i < last; ++i) {
+			const Renderable3D* renderable3D = mRenderable3Ds[i];
+			const Mesh* mesh = renderable3D->getMesh().get();
+			if (mesh) {
+				commandBuffer.mCandidates.push_back(renderable3D);
+				commandBuffer.mCandidateBounds.push_back( mesh->getBounds().transform(renderable3D->getModelMatrix()) );
+			}
+		}
+
+		// Discard the Renderable3Ds outside of the view frustum
+		const unsigned int numCandidates = commandBuffer.mCandidates.size();
+		commandBuffer.mVisibleIndices.resize(numCandidates);
+		unsigned int numVisible = frustum.intersects(
+			commandBuffer.mCandidateBounds.data(), numCandidates,
+			commandBuffer.mVisibleIndices.data()
+		);
+		commandBuffer.mNumCulled = numCandidates - numVisible;
+
+		// Create the Commands of the visible Renderable3Ds
+		for (unsigned int i = 0; i < numVisible; ++i) {
+			unsigned int iCandidate = commandBuffer.mVisibleIndices[i];
+			const Renderable3D* renderable3D = commandBuffer.mCandidates[iCandidate];
+			const AABB& bounds = commandBuffer.mCandidateBounds[iCandidate];
+
+			glm::vec3 center(viewMatrix * glm::vec4(0.5f * (bounds.mMaximum + bounds.mMinimum), 1.0f));
+			glm::mat4 modelViewMatrix = viewMatrix * renderable3D->getModelMatrix();
+
+			// Select the LOD with the projected size of the bounding sphere
+			// of the Mesh. The radius is the same one that the MeshLoader
+			// used for calculating the screen sizes of the LODs, scaled by
+			// the largest scale of the model matrix, so it doesn't grow
+			// with the rotations like the radius of the World space bounds
+			const Mesh& mesh = *renderable3D->getMesh();
+			unsigned int lod = 0;
+			if (mesh.getNumLODs() > 1) {
+				const glm::mat4& modelMatrix = renderable3D->getModelMatrix();
+				float maxScale = std::max({
+					glm::length(glm::vec3(modelMatrix[0])),
+					glm::length(glm::vec3(modelMatrix[1])),
+					glm::length(glm::vec3(modelMatrix[2]))
+				});
+				float radius = maxScale * mesh.getBounds().getRadius();
+				float distance = glm::length(center);
+				float screenSize = (distance > radius)?
+					mLODBias * projectionScale * radius / distance :
+					std::numeric_limits<float>::max();
+
+				auto itLOD = mLODs.find(renderable3D);
+				lod = selectLOD(mesh, screenSize, (itLOD != mLODs.end())? itLOD->second : 0);
+			}
+
+			commandBuffer.mCommands.push_back( RenderQueue::createCommand(renderable3D, modelViewMatrix, -center.z, lod) );
+		}
+	}
+
+
+	unsigned int SceneBatcher::selectLOD(const Mesh& mesh, float screenSize, unsigned int lastLOD) const
+	{
+		unsigned int lod = std::min(lastLOD, mesh.getNumLODs() - 1);
+
+		while ((lod + 1 < mesh.getNumLODs())
+			&& (screenSize < mesh.getLODScreenSize(lod + 1) * (1.0f - mLODHysteresis))
+		) {
+			++lod;
+		}
+		while ((lod > 0)
+			&& (screenSize > mesh.getLODScreenSize(lod) * (1.0f + mLODHysteresis))
+		) {
+			--lod;
+		}
+
+		return lod;
+	}
+
+
+	void SceneBatcher::buildDrawCalls()
+	{
+		mMaterials.clear();
+		mMaterialIndices.clear();
+		mDrawCalls.clear();
+
+		// The first Material is the default one
+		mMaterials.push_back( createMaterialData(nullptr) );
+
+		const unsigned int objectAlignment = getObjectAlignment();
+
+		unsigned int iCommand = 0, numObjects = 0;
+		while (iCommand < mRenderQueue.size()) {
+			const RenderQueue::Command& command = mRenderQueue[iCommand];
+			const Renderable3D* renderable3D = command.mRenderable3D;
+
+			const Mesh* mesh			= renderable3D->getMesh().get();
+			const Material* material	= renderable3D->getMaterial().get();
+			const Texture* texture		= renderable3D->getTexture().get();
+			RenderQueue::Pass pass		= RenderQueue::getPass(command.mKey);
+
+			// Find the consecutive Renderable3Ds that can be drawn with the
+			// same state
+			unsigned int iLastInstance = iCommand + 1;
+			while ((iLastInstance < mRenderQueue.size())
+				&& (iLastInstance - iCommand < MAX_OBJECTS)
+			) {
+				const RenderQueue::Command& other = mRenderQueue[iLastInstance];
+				if ((RenderQueue::getPass(other.mKey) != pass)
+					|| (other.mRenderable3D->getMesh().get() != mesh)
+					|| (other.mLOD != command.mLOD)
+					|| (other.mRenderable3D->getMaterial().get() != material)
+					|| (other.mRenderable3D->getTexture().get() != texture)
+				) {
+					break;
+				}
+				++iLastInstance;
+			}
+
+			// The per object data of the instances starts at an aligned
+			// position
+			unsigned int firstObject = objectAlignment * ((numObjects + objectAlignment - 1) / objectAlignment);
+			numObjects = firstObject + (iLastInstance - iCommand);
+
+			mDrawCalls.push_back({ iCommand, iLastInstance - iCommand, firstObject, getMaterialIndex(material) });
+			iCommand = iLastInstance;
+		}
+
+		// Build the per object data of the draw calls in parallel
+		mObjects.resize(numObjects);
+		mJobSystem.parallelFor(
+			0, mDrawCalls.size(), DRAW_CALLS_PER_JOB,
+			[this](unsigned int first, unsigned int last) { buildObjects(first, last); }
+		);
+	}
+
+
+	void SceneBatcher::buildMultiDraws()
+	{
+		mIndirectCommands.clear();
+		mMultiDraws.clear();
+
+		unsigned int iDrawCall = 0;
+		while (iDrawCall < mDrawCalls.size()) {
+			const DrawCall& firstDrawCall = mDrawCalls[iDrawCall];
+			const RenderQueue::Command& command = mRenderQueue[firstDrawCall.mFirstCommand];
+
+			const MeshBufferPool* pool	= &command.mRenderable3D->getMesh()->getPool();
+			const Texture* texture		= command.mRenderable3D->getTexture().get();
+			RenderQueue::Pass pass		= RenderQueue::getPass(command.mKey);
+
+			// The objects of all the draw calls must be inside of the
+			// range bound for the first one
+			unsigned int iLastDrawCall = iDrawCall;
+			while (iLastDrawCall < mDrawCalls.size()) {
+				const DrawCall& drawCall = mDrawCalls[iLastDrawCall];
+				const RenderQueue::Command& other = mRenderQueue[drawCall.mFirstCommand];
+				const Mesh* mesh = other.mRenderable3D->getMesh().get();
+
+				if ((RenderQueue::getPass(other.mKey) != pass)
+					|| (&mesh->getPool() != pool)
+					|| (other.mRenderable3D->getTexture().get() != texture)
+					|| (drawCall.mFirstObject + drawCall.mNumInstances > firstDrawCall.mFirstObject + MAX_OBJECTS)
+				) {
+					break;
+				}
+
+				mIndirectCommands.push_back({
+					mesh->getIndexCount(other.mLOD), drawCall.mNumInstances,
+					mesh->getFirstIndex(other.mLOD), mesh->getBaseVertex(),
+					drawCall.mFirstObject - firstDrawCall.mFirstObject
+				});
+				++iLastDrawCall;
+			}
+
+			mMultiDraws.push_back({ iDrawCall, iLastDrawCall - iDrawCall });
+			iDrawCall = iLastDrawCall;
+		}
+	}
+
+
+	void SceneBatcher::buildObjects(unsigned int first, unsigned int last)
+	{
+		for (unsigned int iDrawCall = first; iDrawCall < last; ++iDrawCall) {
+			const DrawCall& drawCall = mDrawCalls[iDrawCall];
+
+			for (unsigned int i = 0; i < drawCall.mNumInstances; ++i) {
+				const glm::mat4& modelViewMatrix = mRenderQueue[drawCall.mFirstCommand + i].mModelViewMatrix;
+				glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelViewMatrix)));
+
+				ObjectData& object = mObjects[drawCall.mFirstObject + i];
+				object.mModelViewMatrix = modelViewMatrix;
+				for (int j = 0; j < 3; ++j) {
+					object.mNormalMatrix[j] = glm::vec4(normalMatrix[j], 0.0f);
+				}
+				object.mMaterialIndex = drawCall.mMaterialIndex;
+			}
+		}
+	}
+
+
+	GLint SceneBatcher::getMaterialIndex(const Material* material)
+	{
+		if (!material) return 0;
+
+		auto itMaterial = mMaterialIndices.find(material);
+		if (itMaterial != mMaterialIndices.end()) {
+			return itMaterial->second;
+		}
+
+		if (mMaterials.size() >= MAX_MATERIALS) {
+			return 0;
+		}
+
+		GLint materialIndex = mMaterials.size();
+		mMaterials.push_back( createMaterialData(material) );
+		mMaterialIndices.emplace(material, materialIndex);
+
+		return materialIndex;
+	}
+
+
+	unsigned int SceneBatcher::getObjectAlignment()
+	{
+		unsigned int alignment = UniformBuffer::getOffsetAlignment();
+		return (alignment > sizeof(ObjectData))? alignment / sizeof(ObjectData) : 1;
+	}
+
+}
@@ -0,0 +1,393 @@
+#ifndef SCENE_BATCHER_H
+#define SCENE_BATCHER_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+#include "AABB.h"
+#include "RenderQueue.h"
+#include "../buffers/UniformBuffer.h"
+#include "../buffers/IndirectBuffer.h"
+#include "../../utils/JobSystem.h"
+
+namespace graphics {
+
+	class Renderable3D;
+	class Material;
+	class Texture;
+	class Mesh;
+	class Frustum;
+
+
+	/**
+	 * Class SceneBatcher, it culls the submitted Renderable3Ds against the
+	 * view frustum, sorts them by their GL state and draws them with
+	 * instanced draw calls. It's shared by all the 3D renderers, so their
+	 * Programs only have to read the per object and Material data from
+	 * the uniform blocks that the SceneBatcher uploads:
+	 * <br>- ObjectBlock: ObjectData u_Objects[MAX_OBJECTS], bound to
+	 * OBJECT_BLOCK_BINDING
+	 * <br>- MaterialBlock: MaterialData u_Materials[MAX_MATERIALS], bound to
+	 * MATERIAL_BLOCK_BINDING
+	 * <br>The frame preparation is split in Jobs: each one culls a range of
+	 * the submitted Renderable3Ds and writes their RenderQueue Commands to
+	 * its own CommandBuffer, which are later merged in submission order, so
+	 * the GL thread only has to sort and replay them
+	 * <br>The Programs must read the index of the per object data from the
+	 * instance attribute of the MeshBufferPools. When multi draw indirect
+	 * and base instances are supported, the consecutive draw calls with the same Texture and
+	 * MeshBufferPool whose objects fit in the same range of the object
+	 * uniform block are submitted with a single glMultiDrawElementsIndirect
+	 * call, otherwise each draw call is submitted on its own
+	 * <br>The LOD of the Mesh of each visible Renderable3D is selected with
+	 * the projected size of its bounding sphere, scaled by the LOD bias.
+	 * The LOD used in the previous frame is kept until the size moves
+	 * past the screen size of the next LOD by the hysteresis ratio, so the
+	 * Renderable3Ds near a threshold don't switch every frame
+	 */
+	class SceneBatcher
+	{
+	public:		// Nested types
+		/** The function called before the first draw and each time that
+		 * the Texture changes between draws, so the renderers can select
+		 * the Program for it. It receives the Texture, nullptr if the
+		 * draw doesn't have one */
+		typedef std::function<void(const Texture*)> TextureCallback;
+
+		/** The maximum number of objects that can be drawn with a single
+		 * range of the object uniform block */
+		static const unsigned int MAX_OBJECTS = 128;
+
+		/** The maximum number of materials in the material uniform block */
+		static const unsigned int MAX_MATERIALS = 256;
+
+		/** The binding points of the uniform blocks */
+		static const GLuint OBJECT_BLOCK_BINDING = 0;
+		static const GLuint MATERIAL_BLOCK_BINDING = 1;
+
+		/** Struct ObjectData, it holds the per object data of the object
+		 * uniform block with the std140 layout */
+		struct ObjectData
+		{
+			/** The matrix that transforms from Local space to View space */
+			glm::mat4 mModelViewMatrix;
+
+			/** The columns of the matrix that transforms the normals from
+			 * Local space to View space */
+			glm::vec4 mNormalMatrix[3];
+
+			/** The index of the material of the object in the material
+			 * uniform block */
+			GLint mMaterialIndex;
+			GLint mPadding[3];
+		};
+
+		/** Struct MaterialData, it holds the data of a Material of the
+		 * material uniform block with the std140 layout */
+		struct MaterialData
+		{
+			GLfloat mAmbientColor[3];
+			GLfloat mPadding0;
+			GLfloat mDiffuseColor[3];
+			GLfloat mPadding1;
+			GLfloat mSpecularColor[3];
+			GLfloat mShininess;
+		};
+
+		/** Struct Statistics, it holds the data of the last render call */
+		struct Statistics
+		{
+			/** The number of Renderable3Ds discarded by the frustum culling */
+			unsigned int mNumCulled;
+
+			/** The number of Renderable3Ds drawn */
+			unsigned int mNumDrawn;
+
+			/** The number of draw calls issued, the multi draw calls
+			 * count as one */
+			unsigned int mNumDrawCalls;
+
+			/** The number of times that the Texture or MeshBufferPool had
+			 * to be changed between draws */
+			unsigned int mNumStateChanges;
+		};
+
+	private:	// Nested types
+		/** Struct DrawCall, it holds the data of an instanced draw call */
+		struct DrawCall
+		{
+			/** The index in the RenderQueue of the first instance */
+			unsigned int mFirstCommand;
+
+			/** The number of instances to draw */
+			unsigned int mNumInstances;
+
+			/** The index of the per object data of the first instance */
+			unsigned int mFirstObject;
+
+			/** The index of the Material of the instances in mMaterials */
+			GLint mMaterialIndex;
+		};
+
+		/** Struct DrawElementsIndirectCommand, it holds the parameters of a
+		 * draw call with the layout of the Draw Indirect Buffers */
+		struct DrawElementsIndirectCommand
+		{
+			GLuint mCount;
+			GLuint mInstanceCount;
+			GLuint mFirstIndex;
+			GLint mBaseVertex;
+			GLuint mBaseInstance;
+		};
+
+		/** Struct MultiDraw, it holds the data of a multi draw indirect
+		 * call */
+		struct MultiDraw
+		{
+			/** The index of the first draw call of the multi draw */
+			unsigned int mFirstDrawCall;
+
+			/** The number of draw calls of the multi draw */
+			unsigned int mNumDrawCalls;
+		};
+
+		/** Struct CommandBuffer, it holds the Commands created by a
+		 * preparation Job and the scratch data used for creating them */
+		struct CommandBuffer
+		{
+			/** The Commands of the visible Renderable3Ds of the range */
+			std::vector<RenderQueue::Command> mCommands;
+
+			/** The Renderable3Ds of the range that have a Mesh */
+			std::vector<const Renderable3D*> mCandidates;
+
+			/** The bounds in World space of mCandidates */
+			std::vector<AABB> mCandidateBounds;
+
+			/** The indices of the candidates that passed the frustum
+			 * culling */
+			std::vector<unsigned int> mVisibleIndices;
+
+			/** The number of candidates discarded by the frustum culling */
+			unsigned int mNumCulled;
+		};
+
+	private:	// Attributes
+		/** The number of Renderable3Ds prepared by each Job */
+		static const unsigned int RENDERABLES_PER_JOB = 1024;
+
+		/** The number of draw calls whose per object data is built by each
+		 * Job */
+		static const unsigned int DRAW_CALLS_PER_JOB = 16;
+
+		/** The JobSystem used for preparing the frames */
+		JobSystem& mJobSystem;
+
+		/** The factor applied to the projected sizes of the Renderable3Ds
+		 * before selecting their LODs */
+		float mLODBias;
+
+		/** The ratio by which the projected size must cross the screen
+		 * size of a LOD before switching to it */
+		float mLODHysteresis;
+
+		/** The LOD selected for each Renderable3D drawn in the last
+		 * frame */
+		std::unordered_map<const Renderable3D*, unsigned int> mLODs;
+
+		/** The Renderables submitted for the next render call */
+		std::vector<const Renderable3D*> mRenderable3Ds;
+
+		/** The CommandBuffers of the preparation Jobs, they are kept
+		 * between frames so their memory is reused */
+		std::vector<CommandBuffer> mCommandBuffers;
+
+		/** The visible Renderables sorted by their GL state */
+		RenderQueue mRenderQueue;
+
+		/** The per object data of the visible Renderables in the same
+		 * order than the RenderQueue */
+		std::vector<ObjectData> mObjects;
+
+		/** The data of the Materials used in the current frame */
+		std::vector<MaterialData> mMaterials;
+
+		/** Maps each Material used in the current frame with its index in
+		 * mMaterials */
+		std::unordered_map<const Material*, GLint> mMaterialIndices;
+
+		/** The draw calls of the current frame */
+		std::vector<DrawCall> mDrawCalls;
+
+		/** If the draw calls are submitted with multi draw indirect calls
+		 * or not. The indirect commands need a non zero base instance, so
+		 * it also requires ARB_base_instance */
+		bool mUseMultiDrawIndirect;
+
+		/** The parameters of each draw call of the current frame, with
+		 * the base instance relative to the range of objects of its multi
+		 * draw */
+		std::vector<DrawElementsIndirectCommand> mIndirectCommands;
+
+		/** The multi draw calls of the current frame */
+		std::vector<MultiDraw> mMultiDraws;
+
+		/** The buffer with the data of mIndirectCommands */
+		IndirectBuffer mIndirectBuffer;
+
+		/** The buffer with the data of the object uniform block */
+		UniformBuffer mObjectBuffer;
+
+		/** The buffer with the data of the material uniform block */
+		UniformBuffer mMaterialBuffer;
+
+		/** The statistics of the last render call */
+		Statistics mStatistics;
+
+	public:		// Functions
+		/** Creates a new SceneBatcher
+		 *
+		 * @param	jobSystem the JobSystem used for preparing the frames */
+		SceneBatcher(JobSystem& jobSystem);
+
+		/** Class destructor */
+		~SceneBatcher() {};
+
+		/** Submits the given Renderable3D to the list of Renderable3Ds to
+		 * render
+		 *
+		 * @param	renderable3D a pointer to the Renderable3D that we want
+		 *			to render */
+		inline void submit(const Renderable3D* renderable3D)
+		{ mRenderable3Ds.push_back(renderable3D); };
+
+		/** Submits the given Renderable3Ds to the list of Renderable3Ds to
+		 * render
+		 *
+		 * @param	renderable3Ds a vector with pointers to the
+		 *			Renderable3Ds that we want to render */
+		inline void submit(const std::vector<const Renderable3D*>& renderable3Ds)
+		{ mRenderable3Ds.insert(mRenderable3Ds.end(), renderable3Ds.begin(), renderable3Ds.end()); };
+
+		/** Culls and sorts the submitted Renderable3Ds, builds their draw
+		 * calls and uploads the per object and Material data of all of
+		 * them. The culling and the per object data are calculated in
+		 * parallel with the JobSystem
+		 *
+		 * @note	after calling this method the list of submitted
+		 *			Renderable3Ds will be empty
+		 * @param	viewMatrix the matrix that transforms from World space to
+		 *			View space
+		 * @param	projectionMatrix the matrix that transforms from View
+		 *			space to Projection space */
+		void prepare(const glm::mat4& viewMatrix, const glm::mat4& projectionMatrix);
+
+		/** Draws the Renderable3Ds prepared in the last prepare call with
+		 * the Program that is currently in use. The consecutive
+		 * Renderable3Ds with the same Mesh, Material and Texture are drawn
+		 * with a single instanced draw call, and the draw calls are merged
+		 * in multi draw indirect calls if they are supported
+		 *
+		 * @param	textureCallback the function called when the Texture
+		 *			changes, it can change the Program in use */
+		void draw(const TextureCallback& textureCallback = nullptr);
+
+		/** @return	the statistics of the last render call */
+		inline Statistics getStatistics() const { return mStatistics; };
+
+		/** Sets the LOD bias
+		 *
+		 * @param	lodBias the factor applied to the projected sizes of the
+		 *			Renderable3Ds, values lower than 1 select simpler
+		 *			LODs and values greater than 1 more detailed ones */
+		inline void setLODBias(float lodBias) { mLODBias = lodBias; };
+
+		/** Sets the LOD hysteresis
+		 *
+		 * @param	lodHysteresis the ratio by which the projected size of a
+		 *			Renderable3D must cross the screen size of a LOD
+		 *			before switching to it */
+		inline void setLODHysteresis(float lodHysteresis)
+		{ mLODHysteresis = lodHysteresis; };
+
+		/** Creates the data of the material uniform block for the given
+		 * Material
+		 *
+		 * @param	material a pointer to the Material, if it's nullptr the
+		 *			data of a default white material will be returned
+		 * @return	the material data */
+		static MaterialData createMaterialData(const Material* material);
+
+		/** @return	the defines of MAX_OBJECTS and MAX_MATERIALS for the
+		 *			shaders that read the object and material uniform
+		 *			blocks, so their sizes aren't duplicated in them */
+		static std::string getBlockDefines();
+	private:
+		/** Culls the submitted Renderable3Ds in the given range and creates
+		 * the Commands of the visible ones. It only reads the SceneBatcher,
+		 * so it can be called from multiple threads at the same time
+		 *
+		 * @param	frustum the view Frustum in World space
+		 * @param	viewMatrix the matrix that transforms from World space to
+		 *			View space
+		 * @param	projectionScale the scale of the projection matrix in
+		 *			the vertical axis, used for calculating the projected
+		 *			sizes
+		 * @param	first the index of the first Renderable3D of the range
+		 * @param	last the index after the last Renderable3D of the range
+		 * @param	commandBuffer the CommandBuffer where the Commands will
+		 *			be stored */
+		void prepareCommands(
+			const Frustum& frustum, const glm::mat4& viewMatrix,
+			float projectionScale,
+			unsigned int first, unsigned int last,
+			CommandBuffer& commandBuffer
+		) const;
+
+		/** Selects the LOD of a Mesh
+		 *
+		 * @param	mesh the Mesh
+		 * @param	screenSize the projected size of the bounding sphere of
+		 *			the Mesh relative to the height of the screen
+		 * @param	lastLOD the LOD selected in the previous frame
+		 * @return	the LOD to draw */
+		unsigned int selectLOD(const Mesh& mesh, float screenSize, unsigned int lastLOD) const;
+
+		/** Builds the Material data and the draw calls of the Renderables
+		 * of the RenderQueue, and the per object data in parallel. The
+		 * consecutive Renderables with the same state are merged in a
+		 * single draw call of up to MAX_OBJECTS instances */
+		void buildDrawCalls();
+
+		/** Merges the consecutive draw calls with the same state whose
+		 * objects fit in a single range of the object uniform block in
+		 * multi draw calls, and builds their indirect commands */
+		void buildMultiDraws();
+
+		/** Builds the per object data of the instances of the given draw
+		 * calls
+		 *
+		 * @param	first the index of the first draw call
+		 * @param	last the index after the last draw call */
+		void buildObjects(unsigned int first, unsigned int last);
+
+		/** Returns the index of the given Material in mMaterials, adding
+		 * it if it wasn't used before in the current frame
+		 *
+		 * @param	material a pointer to the Material
+		 * @return	the index of the Material, 0 (the default Material) if
+		 *			material is nullptr or there isn't space for more
+		 *			Materials */
+		GLint getMaterialIndex(const Material* material);
+
+		/** @return	the multiple of objects at which the ranges of objects
+		 *			can start */
+		static unsigned int getObjectAlignment();
+	};
+
+}
+
+#endif		// SCENE_BATCHER_H
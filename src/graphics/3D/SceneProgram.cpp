@@ -2,138 +2,163 @@
 #include <string>
 #include <sstream>
 #include <fstream>
-#include "../Shader.h"
-#include "../Program.h"
-#include "Lights.h"
-#include "Material.h"
+#include "SceneBatcher.h"
+#include "LightBuffer.h"
+#include "LightClusters.h"
 
 namespace graphics {
 
-	SceneProgram::SceneProgram()
+	SceneProgram::SceneProgram() :
+		mCurrentVariant(nullptr),
+		mViewMatrix(1.0f), mProjectionMatrix(1.0f), mClusterZParams(0.0f),
+		mUniformVersion(0),
+		mClusterBuffer(GL_RG32UI),
+		mLightIndexBuffer(GL_R16UI)
 	{
 		initShaders();
-		initUniformLocations();
 	}
 
 
-	SceneProgram::~SceneProgram()
-	{
-		delete mProgram;
-	}
+	SceneProgram::~SceneProgram() {}
 
 
-	void SceneProgram::enable() const
+	void SceneProgram::enable(unsigned int features)
 	{
-		mProgram->enable();
+		Variant& variant = getVariant(features);
+		variant.mProgram->enable();
+		mCurrentVariant = &variant;
+
+		if (variant.mUniformVersion != mUniformVersion) {
+			variant.mProgram->setUniform(variant.mUniformLocations.mViewMatrix, mViewMatrix);
+			variant.mProgram->setUniform(variant.mUniformLocations.mProjectionMatrix, mProjectionMatrix);
+			variant.mProgram->setUniform(variant.mUniformLocations.mClusterZParams, mClusterZParams);
+			variant.mUniformVersion = mUniformVersion;
+		}
 	}
 
 
-	void SceneProgram::disable() const
+	void SceneProgram::disable()
 	{
 		Program::disable();
+		mCurrentVariant = nullptr;
 	}
 
 
-	void SceneProgram::setProjectionMatrix(const glm::mat4& projectionMatrix)
+	void SceneProgram::prepare(const std::vector<unsigned int>& features)
 	{
-		mProgram->setUniform(mUniformLocations.mProjectionMatrix, projectionMatrix);
+		for (unsigned int variantFeatures : features) {
+			getVariant(variantFeatures);
+		}
 	}
 
 
-	void SceneProgram::setModelViewMatrix(const glm::mat4& modelViewMatrix)
+	void SceneProgram::setViewMatrix(const glm::mat4& viewMatrix)
 	{
-		mProgram->setUniform(mUniformLocations.mModelViewMatrix, modelViewMatrix);
+		mViewMatrix = viewMatrix;
+		++mUniformVersion;
 	}
 
 
-	void SceneProgram::setMaterial(const Material* material)
+	void SceneProgram::setProjectionMatrix(const glm::mat4& projectionMatrix)
 	{
-		mProgram->setUniform(mUniformLocations.mMaterial.mAmbientColor, material->getAmbientColor());
-		mProgram->setUniform(mUniformLocations.mMaterial.mDiffuseColor, material->getDiffuseColor());
-		mProgram->setUniform(mUniformLocations.mMaterial.mSpecularColor, material->getSpecularColor());
-		mProgram->setUniform(mUniformLocations.mMaterial.mShininess, material->getShininess());
+		mProjectionMatrix = projectionMatrix;
+		++mUniformVersion;
 	}
 
 
-	void SceneProgram::setLights(const std::vector<const PointLight*>& pointLights)
+	void SceneProgram::setLightClusters(const LightClusters& lightClusters)
 	{
-		int numPointLights = (pointLights.size() > MAX_POINT_LIGHTS) ? MAX_POINT_LIGHTS : pointLights.size();
-		glUniform1i(mUniformLocations.mNumPointLights, numPointLights);
-
-		for (int i = 0; i < numPointLights; ++i) {
-			BaseLight base		= pointLights[i]->getBaseLight();
-			glm::vec3 position	= pointLights[i]->getPosition();
-			Attenuation att		= pointLights[i]->getAttenuation();
-
-			mProgram->setUniform(mUniformLocations.mPointLights[i].mBaseLight.mAmbientIntensity, base.getAmbientIntensity());
-			mProgram->setUniform(mUniformLocations.mPointLights[i].mBaseLight.mIntensity, base.getAmbientIntensity());
-			mProgram->setUniform(mUniformLocations.mPointLights[i].mAttenuation.mConstant, att.mConstant);
-			mProgram->setUniform(mUniformLocations.mPointLights[i].mAttenuation.mLinear, att.mLinear);
-			mProgram->setUniform(mUniformLocations.mPointLights[i].mAttenuation.mExponential, att.mExponential);
-			mProgram->setUniform(mUniformLocations.mPointLightsPositions[i], position);
-		}
+		const std::vector<LightClusters::Cluster>& clusters = lightClusters.getClusters();
+		const std::vector<GLushort>& lightIndices = lightClusters.getLightIndices();
+
+		mClusterBuffer.setData(clusters.data(), clusters.size() * sizeof(LightClusters::Cluster));
+		mLightIndexBuffer.setData(lightIndices.data(), lightIndices.size() * sizeof(GLushort));
+
+		mClusterBuffer.bind(CLUSTER_TEXTURE_UNIT);
+		mLightIndexBuffer.bind(LIGHT_INDEX_TEXTURE_UNIT);
+
+		mClusterZParams = lightClusters.getZParams();
+		++mUniformVersion;
 	}
 
 // Private functions
 	void SceneProgram::initShaders()
 	{
-		// 1. Read the shader text from the shader files
+		// Read the shader text from the shader files
+		const char* shaderPaths[] = { "res/shaders/Scene.vert", "res/shaders/Scene.frag" };
+		const GLenum shaderTypes[] = { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER };
+
 		std::ifstream reader;
+		for (unsigned int i = 0; i < 2; ++i) {
+			std::stringstream shaderStream;
+			reader.open(shaderPaths[i]);
+			shaderStream << reader.rdbuf();
+			mSources.push_back({ shaderTypes[i], shaderStream.str() });
+			reader.close();
+		}
+	}
+
+
+	SceneProgram::Variant& SceneProgram::getVariant(unsigned int features)
+	{
+		Variant& variant = mVariants[features & ALL_FEATURES];
+		if (!variant.mProgram) {
+			// The Programs use the ProgramCache, so the variants are only
+			// compiled the first time that they are used
+			variant.mProgram = std::make_unique<Program>(mSources, getDefines(features & ALL_FEATURES));
+			initUniformLocations(variant);
+
+			// Force the upload of the uniform variables
+			variant.mUniformVersion = mUniformVersion - 1;
+
+			// Creating the variant doesn't change the one in use
+			if (mCurrentVariant) {
+				mCurrentVariant->mProgram->enable();
+			}
+		}
+
+		return variant;
+	}
+
 
-		std::string vertexShaderText;
-		std::stringstream vertexShaderStream;
-		reader.open("res/shaders/Scene.vert");
-		vertexShaderStream << reader.rdbuf();
-		vertexShaderText = vertexShaderStream.str();
-		reader.close();
-
-		std::string fragmentShaderText;
-		std::stringstream fragmentShaderStream;
-		reader.open("res/shaders/Scene.frag");
-		fragmentShaderStream << reader.rdbuf();
-		fragmentShaderText = fragmentShaderStream.str();
-		reader.close();
-
-		Shader vertexShader(vertexShaderText.c_str(), GL_VERTEX_SHADER);
-		Shader fragmentShader(fragmentShaderText.c_str(), GL_FRAGMENT_SHADER);
-
-		// 2. Create the Program
-		std::vector<const Shader*> shaders = { &vertexShader, &fragmentShader };
-		mProgram = new Program(shaders);
+	void SceneProgram::initUniformLocations(Variant& variant)
+	{
+		Program& program = *variant.mProgram;
+		variant.mUniformLocations.mViewMatrix		= program.getUniformLocation("u_ViewMatrix");
+		variant.mUniformLocations.mProjectionMatrix	= program.getUniformLocation("u_ProjectionMatrix");
+		variant.mUniformLocations.mClusterZParams	= program.getUniformLocation("u_ClusterZParams");
+
+		program.enable();
+		program.setUniform("u_ColorTexture", static_cast<int>(COLOR_TEXTURE_UNIT));
+		program.setUniform("u_ClusterGrid", static_cast<int>(CLUSTER_TEXTURE_UNIT));
+		program.setUniform("u_LightIndices", static_cast<int>(LIGHT_INDEX_TEXTURE_UNIT));
+		program.disable();
+
+		program.setUniformBlockBinding("ObjectBlock", SceneBatcher::OBJECT_BLOCK_BINDING);
+		program.setUniformBlockBinding("MaterialBlock", SceneBatcher::MATERIAL_BLOCK_BINDING);
+		program.setUniformBlockBinding("LightBlock", LightBuffer::LIGHT_BLOCK_BINDING);
 	}
 
 
-	void SceneProgram::initUniformLocations()
+	std::string SceneProgram::getDefines(unsigned int features)
 	{
-		mUniformLocations.mModelViewMatrix			= mProgram->getUniformLocation("u_ModelViewMatrix");
-		mUniformLocations.mProjectionMatrix			= mProgram->getUniformLocation("u_ProjectionMatrix");
-		
-		mUniformLocations.mMaterial.mAmbientColor	= mProgram->getUniformLocation("u_Material.mAmbientColor");
-		mUniformLocations.mMaterial.mDiffuseColor	= mProgram->getUniformLocation("u_Material.mDiffuseColor");
-		mUniformLocations.mMaterial.mSpecularColor	= mProgram->getUniformLocation("u_Material.mSpecularColor");
-		mUniformLocations.mMaterial.mShininess		= mProgram->getUniformLocation("u_Material.mShininess");
-		
-		mUniformLocations.mNumPointLights			= mProgram->getUniformLocation("u_NumPointLights");
-		for (unsigned int i = 0; i < MAX_POINT_LIGHTS; ++i) {
-			mUniformLocations.mPointLights[i].mBaseLight.mAmbientIntensity = mProgram->getUniformLocation(
-				("u_PointLights[" + std::to_string(i) + "].mBaseLight.mAmbientIntensity").c_str()
-			);
-			mUniformLocations.mPointLights[i].mBaseLight.mIntensity = mProgram->getUniformLocation(
-				("u_PointLights[" + std::to_string(i) + "].mBaseLight.mIntensity").c_str()
-			);
-			mUniformLocations.mPointLights[i].mAttenuation.mConstant = mProgram->getUniformLocation(
-				("u_PointLights[" + std::to_string(i) + "].mAttenuation.mConstant").c_str()
-			);
-			mUniformLocations.mPointLights[i].mAttenuation.mLinear = mProgram->getUniformLocation(
-				("u_PointLights[" + std::to_string(i) + "].mAttenuation.mLinear").c_str()
-			);
-			mUniformLocations.mPointLights[i].mAttenuation.mExponential = mProgram->getUniformLocation(
-				("u_PointLights[" + std::to_string(i) + "].mAttenuation.mExponential").c_str()
-			);
-			mUniformLocations.mPointLightsPositions[i] = mProgram->getUniformLocation(
-				("u_PointLightsPositions[" + std::to_string(i) + "]").c_str()
-			);
+		std::string defines = SceneBatcher::getBlockDefines() + LightBuffer::getBlockDefines()
+			+ "#define CLUSTER_GRID_SIZE ivec3("
+				+ std::to_string(LightClusters::NUM_TILES_X) + ", "
+				+ std::to_string(LightClusters::NUM_TILES_Y) + ", "
+				+ std::to_string(LightClusters::NUM_SLICES) + ")\n";
+
+		if (features & TEXTURED_FEATURE) {
+			defines += "#define TEXTURED\n";
 		}
+		if (features & POINT_LIGHTS_FEATURE) {
+			defines += "#define POINT_LIGHTS\n";
+		}
+		if (features & SPOT_LIGHTS_FEATURE) {
+			defines += "#define SPOT_LIGHTS\n";
+		}
+
+		return defines;
 	}
 
 }
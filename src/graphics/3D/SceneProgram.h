@@ -1,83 +1,140 @@
 #ifndef SCENE_PROGRAM
 #define SCENE_PROGRAM
 
+#include <memory>
+#include <string>
 #include <vector>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
+#include "../Program.h"
+#include "../buffers/TextureBuffer.h"
 
 namespace graphics {
 
-	class Program;
-	class Material;
-	class PointLight;
+	class LightClusters;
 
 
 	/** SceneProgram class, it's a high level Program used by the
 	 * SceneRenderer so it doesn't need to search and set the uniform
-	 * variables */
+	 * variables. The per object, Material and light data are read from
+	 * the uniform blocks of the SceneBatcher and the LightBuffer.
+	 * <br>The shaders are specialized with a variant for each combination
+	 * of Features, created the first time they are enabled, so the draws
+	 * only pay for the Features that they use. The sizes of the uniform
+	 * blocks and of the cluster grid are injected in all the variants as
+	 * defines, so they aren't duplicated in the shaders. The uniform
+	 * variables are stored and uploaded to each variant when it's
+	 * enabled */
 	class SceneProgram
 	{
+	public:		// Nested types
+		/** The Features that can be enabled in the shaders, the variants
+		 * are selected with a bit mask of them */
+		enum Feature
+		{
+			/** The color is multiplied by the bound Texture */
+			TEXTURED_FEATURE		= 1 << 0,
+
+			/** The fragments are lit by the point lights of their
+			 * cluster */
+			POINT_LIGHTS_FEATURE	= 1 << 1,
+
+			/** The fragments are lit by the spot lights of their
+			 * cluster */
+			SPOT_LIGHTS_FEATURE		= 1 << 2,
+
+			ALL_FEATURES			= (1 << 3) - 1
+		};
+
 	private:	// Nested types
-		/** The maximum number of point lights in the program */
-		static const unsigned int MAX_POINT_LIGHTS = 4;
+		/** The texture units of the color Texture and of the light
+		 * clusters */
+		static const GLuint COLOR_TEXTURE_UNIT = 0;
+		static const GLuint CLUSTER_TEXTURE_UNIT = 1;
+		static const GLuint LIGHT_INDEX_TEXTURE_UNIT = 2;
 
 		/** Struct UniformLocations, it holds the uniform variables location
 		 * so we don't have to get them in each render call */
 		struct UniformLocations
 		{
-			GLuint mModelViewMatrix;
+			GLuint mViewMatrix;
 			GLuint mProjectionMatrix;
+			GLuint mClusterZParams;
+		};
 
-			struct
-			{
-				GLuint mAmbientColor;
-				GLuint mDiffuseColor;
-				GLuint mSpecularColor;
-				GLuint mShininess;
-			} mMaterial;
-
-			struct BaseLight
-			{
-				GLuint mAmbientIntensity;
-				GLuint mIntensity;
-			};
-
-			struct Attenuation
-			{
-				GLuint mConstant;
-				GLuint mLinear;
-				GLuint mExponential;
-			};
-
-			GLuint mNumPointLights;
-			struct
-			{
-				BaseLight mBaseLight;
-				Attenuation mAttenuation;
-			} mPointLights[MAX_POINT_LIGHTS];
-			GLuint mPointLightsPositions[MAX_POINT_LIGHTS];
+		/** Struct Variant, it holds the Program specialized for a
+		 * combination of Features */
+		struct Variant
+		{
+			/** The Program of the variant, nullptr if it hasn't been
+			 * created yet */
+			std::unique_ptr<Program> mProgram;
+
+			/** The locations of uniform variables in the Program */
+			UniformLocations mUniformLocations;
+
+			/** The value of mUniformVersion when the uniform variables
+			 * were uploaded to the Program */
+			unsigned int mUniformVersion;
 		};
 
 	private:	// Attributes
-		/** The Program of the renderer */
-		Program* mProgram;
+		/** The source code of the shaders */
+		std::vector<ShaderSource> mSources;
+
+		/** The variants of each combination of Features */
+		Variant mVariants[ALL_FEATURES + 1];
+
+		/** The variant in use, nullptr if there isn't any */
+		Variant* mCurrentVariant;
+
+		/** The values of the uniform variables shared by all the
+		 * variants */
+		glm::mat4 mViewMatrix, mProjectionMatrix;
+		glm::vec2 mClusterZParams;
 
-		/** The locations of uniform variables in the shader */
-		UniformLocations mUniformLocations;
+		/** The number of times that the uniform variables have been
+		 * changed */
+		unsigned int mUniformVersion;
+
+		/** The buffer with the light lists of each cluster */
+		TextureBuffer mClusterBuffer;
+
+		/** The buffer with the light indices of all the clusters */
+		TextureBuffer mLightIndexBuffer;
 
 	public:		// Functions
-		/** Creates a new SceneProgram */
+		/** Creates a new SceneProgram, the shaders of the variants are
+		 * read but they aren't compiled until they are used */
 		SceneProgram();
 
 		/** Class destructor */
 		~SceneProgram();
 
-		/** Uses the current shader object so they can be used as part
-		 * of the current rendering state */
-		void enable() const;
+		/** Uses the variant with the given Features so it can be used as
+		 * part of the current rendering state, creating it if it's the
+		 * first time that it's used. The uniform variables changed since
+		 * the last time it was used are uploaded to it
+		 *
+		 * @param	features the bit mask of the Features of the
+		 *			variant */
+		void enable(unsigned int features = ALL_FEATURES);
 
 		/** Resets the current shader object */
-		void disable() const;
+		void disable();
+
+		/** Creates the variants with the given Features so they don't
+		 * have to be created while rendering
+		 *
+		 * @param	features the bit masks of the Features of the
+		 *			variants */
+		void prepare(const std::vector<unsigned int>& features);
+
+		/** Sets the uniform variables fot the given View matrix
+		 *
+		 * @param	viewMatrix the matrix that we want to set as the
+		 *			View matrix in the shaders */
+		void setViewMatrix(const glm::mat4& viewMatrix);
 
 		/** Sets the uniform variables fot the given Projection matrix
 		 *
@@ -85,35 +142,34 @@ namespace graphics {
 		 *			Projection matrix in the shaders */
 		void setProjectionMatrix(const glm::mat4& projectionMatrix);
 
-		/** Sets the uniform variables fot the given ModelView matrix
-		 * 
-		 * @param	modelViewMatrix the matrix that we want to set as the
-		 *			ModelView matrix in the shaders */
-		void setModelViewMatrix(const glm::mat4& modelViewMatrix);
-
-		/** Sets the uniform variables for the given material
-		 * 
-		 * @param	material a pointer to the material with the data that we
-		 *			want to set as uniform variables in the shaders */
-		void setMaterial(const Material* material);
-
-		/** Sets the uniform variables for the given PointLights
-		 * 
-		 * @param	pointLights a vector of pointer to the PointLights with the
-		 *			data that we want to set as uniform variables in the
-		 *			shaders
-		 * @note	the maximum number of PointLights is MAX_LIGHTS, so if
-		 *			there are more lights in the given vector only the first
-		 *			lights of the vector will be submited */
-		void setLights(const std::vector<const PointLight*>& pointLights);
+		/** Uploads the light lists of the given LightClusters, so each
+		 * fragment only processes the lights of its cluster
+		 *
+		 * @param	lightClusters the LightClusters built with the lights
+		 *			of the LightBuffer */
+		void setLightClusters(const LightClusters& lightClusters);
 	private:
-		/** Creates the Shaders and the Program that the current class will use
-		 * for setting the uniform variables */
+		/** Reads the source code of the shaders */
 		void initShaders();
 
-		/** Gets the location of all the uniform variables and stores them in
-		 * mUniformLocations */
-		void initUniformLocations();
+		/** Creates the Program of the variant with the given Features
+		 *
+		 * @param	features the bit mask of the Features of the variant
+		 * @return	the variant */
+		Variant& getVariant(unsigned int features);
+
+		/** Gets the location of all the uniform variables of the given
+		 * variant and sets the ones that never change
+		 *
+		 * @param	variant the variant with its Program already
+		 *			created */
+		void initUniformLocations(Variant& variant);
+
+		/** Returns the defines of the variant with the given Features
+		 *
+		 * @param	features the bit mask of the Features of the variant
+		 * @return	the defines of the constants and of each Feature */
+		static std::string getDefines(unsigned int features);
 	};
 
 }
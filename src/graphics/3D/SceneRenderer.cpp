@@ -1,54 +1,58 @@
 #include "SceneRenderer.h"
-#include "../Texture.h"
-#include "Renderable3D.h"
-#include "Mesh.h"
 #include "Camera.h"
 
 namespace graphics {
 
-	void SceneRenderer::render(const Camera* camera, const std::vector<const PointLight*>& pointLights)
+	SceneRenderer::SceneRenderer(const glm::mat4& projectionMatrix, JobSystem& jobSystem) :
+		mProjectionMatrix(projectionMatrix),
+		mBatcher(jobSystem),
+		mLightClusters(projectionMatrix)
 	{
+		// Create up front the variants used by the lit scenes, the rest
+		// of them are created the first time that they are used
+		const unsigned int lightFeatures = SceneProgram::POINT_LIGHTS_FEATURE | SceneProgram::SPOT_LIGHTS_FEATURE;
+		mProgram.prepare({ lightFeatures, lightFeatures | SceneProgram::TEXTURED_FEATURE });
+	}
+
+
+	void SceneRenderer::render(
+		const Camera* camera,
+		const std::vector<const PointLight*>& pointLights,
+		const std::vector<const SpotLight*>& spotLights
+	) {
 		if (!camera) return;
 
 		glm::mat4 viewMatrix = camera->getViewMatrix();
 
-		mProgram.enable();
+		// Cull and sort the Renderable3Ds and upload their data
+		mBatcher.prepare(viewMatrix, mProjectionMatrix);
+
+		// Upload the lights and bin them in the clusters
+		mLightBuffer.setLights(pointLights, spotLights);
+		mLightClusters.build(
+			viewMatrix,
+			pointLights.data(), mLightBuffer.getNumPointLights(),
+			spotLights.data(), mLightBuffer.getNumSpotLights()
+		);
+
+		// Draw the Renderable3Ds with the cheapest variant of the Program
+		// for the lights of the frame and the Texture of each draw
+		mProgram.setViewMatrix(viewMatrix);
 		mProgram.setProjectionMatrix(mProjectionMatrix);
-		mProgram.setLights(pointLights);
-
-		while (!mRenderable3Ds.empty()) {
-			const Renderable3D* renderable3D = mRenderable3Ds.front();
-			mRenderable3Ds.pop();
-
-			auto mesh				= renderable3D->getMesh();
-			auto material			= renderable3D->getMaterial();
-			auto texture			= renderable3D->getTexture();
-			glm::mat4 modelMatrix	= renderable3D->getModelMatrix();
-
-			if (mesh) {
-				glm::mat4 modelViewMatrix = viewMatrix * modelMatrix;
-				mProgram.setModelViewMatrix(modelViewMatrix);
-				
-				if (material) {
-					mProgram.setMaterial(material.get());
-				}
-				if (texture) {
-					glActiveTexture(GL_TEXTURE0);
-					texture->bind();
-				}
-
-				// Draw
-				mesh->bindVAO();
-				glDrawElements(GL_TRIANGLES, mesh->getIndexCount(), GL_UNSIGNED_SHORT, nullptr);
-				glBindVertexArray(0);
-
-				if (texture) {
-					texture->unbind();
-				}
-			}
+		mProgram.setLightClusters(mLightClusters);
+		mLightBuffer.bind();
+
+		unsigned int features = 0;
+		if (mLightBuffer.getNumPointLights() > 0) {
+			features |= SceneProgram::POINT_LIGHTS_FEATURE;
+		}
+		if (mLightBuffer.getNumSpotLights() > 0) {
+			features |= SceneProgram::SPOT_LIGHTS_FEATURE;
 		}
 
-		mProgram.disable();
+		mBatcher.draw([&](const Texture* texture) {
+			mProgram.enable(texture? features | SceneProgram::TEXTURED_FEATURE : features);
+		});
 	}
 
 }
@@ -1,14 +1,18 @@
 #ifndef SCENE_RENDERER_H
 #define SCENE_RENDERER_H
 
-#include <queue>
+#include <vector>
 #include <glm/glm.hpp>
+#include "SceneBatcher.h"
 #include "SceneProgram.h"
+#include "LightBuffer.h"
+#include "LightClusters.h"
 
 namespace graphics {
 
 	class Renderable3D;
 	class PointLight;
+	class SpotLight;
 	class Camera;
 
 
@@ -26,43 +30,80 @@ namespace graphics {
 		 * Space to Projection Space */
 		glm::mat4 mProjectionMatrix;
 
-		/** The Renderables that we want to render */
-		std::queue<const Renderable3D*> mRenderable3Ds;
+		/** Culls, sorts and draws the submitted Renderable3Ds */
+		SceneBatcher mBatcher;
+
+		/** The data of the lights of the scene */
+		LightBuffer mLightBuffer;
+
+		/** The lists of the lights that affect to each cluster of the
+		 * view frustum */
+		LightClusters mLightClusters;
 
 	public:		// Functions
 		/** Creates a new SceneRenderer and sets all the uniform locations
 		 * for the renderer
 		 *
-		 * @param	projectionMatrix the projectionMatrix of the renderer */
-		SceneRenderer(const glm::mat4& projectionMatrix) :
-			mProjectionMatrix(projectionMatrix) {};
+		 * @param	projectionMatrix the projectionMatrix of the renderer
+		 * @param	jobSystem the JobSystem used for preparing the frames */
+		SceneRenderer(const glm::mat4& projectionMatrix, JobSystem& jobSystem);
 
 		/** Class destructor */
 		~SceneRenderer() {};
 		
 		/** Sets the projection matrix */
 		inline void setProjectionMatrix(const glm::mat4& projectionMatrix)
-		{ mProjectionMatrix = projectionMatrix; };
+		{
+			mProjectionMatrix = projectionMatrix;
+			mLightClusters.setProjectionMatrix(projectionMatrix);
+		};
 
-		/** Submits the given Renderable3D to the queue of Renderable3Ds to
+		/** Submits the given Renderable3D to the list of Renderable3Ds to
 		 * render
 		 * 
 		 * @param	renderable3D a pointer to the Renderable3D that we want
 		 *			to render */
 		inline void submit(const Renderable3D* renderable3D)
-		{ mRenderable3Ds.push(renderable3D); };
+		{ mBatcher.submit(renderable3D); };
+
+		/** Submits the given Renderable3Ds to the list of Renderable3Ds to
+		 * render
+		 *
+		 * @param	renderable3Ds a vector with pointers to the
+		 *			Renderable3Ds that we want to render */
+		inline void submit(const std::vector<const Renderable3D*>& renderable3Ds)
+		{ mBatcher.submit(renderable3Ds); };
 
-		/** Renders the Renderable3Ds that currently are in the render queue
+		/** Renders the submitted Renderable3Ds sorted by their GL state.
+		 * The consecutive Renderable3Ds with the same Mesh, Material and
+		 * Texture are drawn with a single instanced draw call, and each
+		 * fragment is only lit by the lights of its cluster
 		 * 
-		 * @note	after calling this method the render queue will be empty
+		 * @note	after calling this method the list of submitted
+		 *			Renderable3Ds will be empty
 		 * @param	camera a pointer to the camera with which we will render
 		 *			the scene
-		 * @param	lights a vector with pointers to the lights that will
-		 *			affect to the next renders */
+		 * @param	pointLights a vector with pointers to the PointLights
+		 *			that will affect to the next renders
+		 * @param	spotLights a vector with pointers to the SpotLights
+		 *			that will affect to the next renders */
 		void render(
 			const Camera* camera,
-			const std::vector<const PointLight*>& pointLights
+			const std::vector<const PointLight*>& pointLights,
+			const std::vector<const SpotLight*>& spotLights
 		);
+
+		/** @return	the statistics of the last render call */
+		inline SceneBatcher::Statistics getStatistics() const
+		{ return mBatcher.getStatistics(); };
+
+		/** Sets the LOD bias of the Renderable3Ds
+		 *
+		 * @param	lodBias the factor applied to the projected sizes of the
+		 *			Renderable3Ds, values lower than 1 select simpler
+		 *			LODs and values greater than 1 more detailed ones */
+		inline void setLODBias(float lodBias)
+		{ mBatcher.setLODBias(lodBias); };
 	};
 
 }
@@ -0,0 +1,53 @@
+#include "SphereProjector.h"
+#include <limits>
+#include <algorithm>
+
+namespace graphics {
+
+	void SphereProjector::setProjectionMatrix(const glm::mat4& projectionMatrix)
+	{
+		mProjectionMatrix = projectionMatrix;
+
+		// Extract the near and far distances from the perspective matrix
+		mZNear	= projectionMatrix[3][2] / (projectionMatrix[2][2] - 1.0f);
+		mZFar	= projectionMatrix[3][2] / (projectionMatrix[2][2] + 1.0f);
+	}
+
+
+	bool SphereProjector::project(const glm::vec3& center, float radius, Bounds& bounds) const
+	{
+		if (radius >= std::numeric_limits<float>::max()) {
+			// The sphere covers the whole frustum
+			bounds.mMinimum = glm::vec2(-1.0f);
+			bounds.mMaximum = glm::vec2(1.0f);
+			bounds.mMinDepth = mZNear;
+			bounds.mMaxDepth = mZFar;
+			return true;
+		}
+
+		// Clip the sphere to the depth range of the frustum
+		float minDepth = -center.z - radius, maxDepth = -center.z + radius;
+		if ((radius <= 0.0f) || (maxDepth < mZNear) || (minDepth > mZFar)) {
+			return false;
+		}
+		bounds.mMinDepth = std::max(minDepth, mZNear);
+		bounds.mMaxDepth = std::min(maxDepth, mZFar);
+
+		// Project the corners of the bounding box of the clipped sphere
+		bounds.mMinimum = glm::vec2( std::numeric_limits<float>::max());
+		bounds.mMaximum = glm::vec2(-std::numeric_limits<float>::max());
+		for (float depth : { bounds.mMinDepth, bounds.mMaxDepth }) {
+			for (float x : { center.x - radius, center.x + radius }) {
+				for (float y : { center.y - radius, center.y + radius }) {
+					glm::vec4 clipPosition = mProjectionMatrix * glm::vec4(x, y, -depth, 1.0f);
+					glm::vec2 ndc(clipPosition.x / clipPosition.w, clipPosition.y / clipPosition.w);
+					bounds.mMinimum = glm::min(bounds.mMinimum, ndc);
+					bounds.mMaximum = glm::max(bounds.mMaximum, ndc);
+				}
+			}
+		}
+
+		return true;
+	}
+
+}
@@ -0,0 +1,76 @@
+#ifndef SPHERE_PROJECTOR_H
+#define SPHERE_PROJECTOR_H
+
+#include <glm/glm.hpp>
+
+namespace graphics {
+
+	/**
+	 * Class SphereProjector, it calculates the bounds in Normalized Device
+	 * Coordinates and in depth of the spheres in View space, like the
+	 * volumes of the lights. It's shared by the light culling and the
+	 * scissor rectangles of the lights, so both of them always agree on
+	 * the bounds of each light.
+	 * <br>The sphere is clipped to the depth range of the frustum and the
+	 * 8 corners of its bounding box are projected, so the bounds are
+	 * conservative
+	 */
+	class SphereProjector
+	{
+	public:		// Nested types
+		/** Struct Bounds, it holds the bounds of a projected sphere */
+		struct Bounds
+		{
+			/** The minimum and maximum x and y coordinates in NDC, they
+			 * can be outside the [-1, 1] range */
+			glm::vec2 mMinimum, mMaximum;
+
+			/** The minimum and maximum distances to the camera along the
+			 * view direction, clipped to the near and far planes */
+			float mMinDepth, mMaxDepth;
+		};
+
+	private:	// Attributes
+		/** The matrix that transforms from View space to Projection space */
+		glm::mat4 mProjectionMatrix;
+
+		/** The distances to the near and far planes of the frustum */
+		float mZNear, mZFar;
+
+	public:		// Functions
+		/** Creates a new SphereProjector
+		 *
+		 * @param	projectionMatrix the perspective projection matrix with
+		 *			which the scene is going to be rendered */
+		SphereProjector(const glm::mat4& projectionMatrix)
+		{ setProjectionMatrix(projectionMatrix); };
+
+		/** Class destructor */
+		~SphereProjector() {};
+
+		/** Sets the projection matrix used for projecting the spheres
+		 *
+		 * @param	projectionMatrix the new perspective projection matrix */
+		void setProjectionMatrix(const glm::mat4& projectionMatrix);
+
+		/** @return	the distance to the near plane of the frustum */
+		inline float getZNear() const { return mZNear; };
+
+		/** @return	the distance to the far plane of the frustum */
+		inline float getZFar() const { return mZFar; };
+
+		/** Calculates the bounds of the given sphere
+		 *
+		 * @param	center the center of the sphere in View space
+		 * @param	radius the radius of the sphere, if it's the maximum
+		 *			float the sphere covers the whole frustum
+		 * @param	bounds where the bounds of the sphere will be stored
+		 * @return	true if the sphere is inside the depth range of the
+		 *			frustum, false otherwise. The bounds in x and y still
+		 *			have to be tested against the [-1, 1] range */
+		bool project(const glm::vec3& center, float radius, Bounds& bounds) const;
+	};
+
+}
+
+#endif		// SPHERE_PROJECTOR_H
@@ -0,0 +1,365 @@
+#include "GLStateCache.h"
+
+namespace graphics {
+
+// Static attributes
+	const GLenum GLStateCache::mBufferTargets[] = {
+		GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_TEXTURE_BUFFER,
+		GL_PIXEL_UNPACK_BUFFER, GL_DRAW_INDIRECT_BUFFER
+	};
+	const GLenum GLStateCache::mCapabilities[] = {
+		GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TEST
+	};
+	GLStateCache GLStateCache::mInstance;
+
+// Public functions
+	void GLStateCache::invalidate()
+	{
+		GLStateCache& cache = mInstance;
+
+		cache.mProgram			= UNKNOWN;
+		cache.mVertexArray		= UNKNOWN;
+		cache.mDrawFramebuffer	= UNKNOWN;
+		cache.mReadFramebuffer	= UNKNOWN;
+		cache.mActiveTextureUnit = UNKNOWN;
+		for (TextureUnit& textureUnit : cache.mTextureUnits) {
+			textureUnit = { GL_NONE, UNKNOWN };
+		}
+		for (GLuint& buffer : cache.mBuffers) {
+			buffer = UNKNOWN;
+		}
+		for (BufferRange& range : cache.mUniformBindings) {
+			range = { UNKNOWN, 0, 0 };
+		}
+		for (GLuint& state : cache.mCapabilityStates) {
+			state = UNKNOWN;
+		}
+		cache.mBlendSourceFactor		= GL_NONE;
+		cache.mBlendDestinationFactor	= GL_NONE;
+		cache.mDepthFunction			= GL_NONE;
+		cache.mDepthMask				= UNKNOWN;
+		cache.mCullFace					= GL_NONE;
+	}
+
+
+	GLStateCache::Statistics GLStateCache::getStatistics()
+	{
+		return mInstance.mStatistics;
+	}
+
+
+	void GLStateCache::resetStatistics()
+	{
+		mInstance.mStatistics = { 0, 0 };
+	}
+
+
+	void GLStateCache::useProgram(GLuint program)
+	{
+		GLStateCache& cache = mInstance;
+		if (cache.count(cache.mProgram == program)) return;
+
+		glUseProgram(program);
+		cache.mProgram = program;
+	}
+
+
+	void GLStateCache::bindVertexArray(GLuint vertexArray)
+	{
+		GLStateCache& cache = mInstance;
+		if (cache.count(cache.mVertexArray == vertexArray)) return;
+
+		glBindVertexArray(vertexArray);
+		cache.mVertexArray = vertexArray;
+	}
+
+
+	void GLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer)
+	{
+		GLStateCache& cache = mInstance;
+
+		bool draw = (target == GL_FRAMEBUFFER) || (target == GL_DRAW_FRAMEBUFFER);
+		bool read = (target == GL_FRAMEBUFFER) || (target == GL_READ_FRAMEBUFFER);
+		if (cache.count(
+			(!draw || (cache.mDrawFramebuffer == framebuffer))
+			&& (!read || (cache.mReadFramebuffer == framebuffer))
+		)) return;
+
+		glBindFramebuffer(target, framebuffer);
+		if (draw) { cache.mDrawFramebuffer = framebuffer; }
+		if (read) { cache.mReadFramebuffer = framebuffer; }
+	}
+
+
+	void GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture)
+	{
+		GLStateCache& cache = mInstance;
+
+		if (unit >= MAX_TEXTURE_UNITS) {
+			cache.count(false);
+			cache.setActiveTextureUnit(unit);
+			glBindTexture(target, texture);
+			return;
+		}
+
+		TextureUnit& textureUnit = cache.mTextureUnits[unit];
+		if (cache.count((textureUnit.mTarget == target) && (textureUnit.mTexture == texture))) return;
+
+		cache.setActiveTextureUnit(unit);
+		glBindTexture(target, texture);
+		textureUnit = { target, texture };
+	}
+
+
+	void GLStateCache::bindBuffer(GLenum target, GLuint buffer)
+	{
+		GLStateCache& cache = mInstance;
+
+		unsigned int iTarget = getBufferTargetIndex(target);
+		if (iTarget >= NUM_BUFFER_TARGETS) {
+			cache.count(false);
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		if (cache.count(cache.mBuffers[iTarget] == buffer)) return;
+
+		glBindBuffer(target, buffer);
+		cache.mBuffers[iTarget] = buffer;
+	}
+
+
+	void GLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		bindBufferRange(target, index, buffer, 0, -1);
+	}
+
+
+	void GLStateCache::bindBufferRange(
+		GLenum target, GLuint index, GLuint buffer,
+		GLintptr offset, GLsizeiptr size
+	) {
+		GLStateCache& cache = mInstance;
+
+		// The range binding functions also change the generic binding of
+		// the target
+		unsigned int iTarget = getBufferTargetIndex(target);
+		bool tracked = (target == GL_UNIFORM_BUFFER) && (index < MAX_UNIFORM_BINDINGS);
+		if (tracked) {
+			const BufferRange& range = cache.mUniformBindings[index];
+			if (cache.count(
+				(range.mBuffer == buffer) && (range.mOffset == offset) && (range.mSize == size)
+				&& (cache.mBuffers[iTarget] == buffer)
+			)) return;
+		}
+		else {
+			cache.count(false);
+		}
+
+		if (size < 0) {
+			glBindBufferBase(target, index, buffer);
+		}
+		else {
+			glBindBufferRange(target, index, buffer, offset, size);
+		}
+
+		if (tracked) {
+			cache.mUniformBindings[index] = { buffer, offset, size };
+		}
+		if (iTarget < NUM_BUFFER_TARGETS) {
+			cache.mBuffers[iTarget] = buffer;
+		}
+	}
+
+
+	void GLStateCache::enable(GLenum capability)
+	{
+		mInstance.setCapability(capability, 1);
+	}
+
+
+	void GLStateCache::disable(GLenum capability)
+	{
+		mInstance.setCapability(capability, 0);
+	}
+
+
+	void GLStateCache::setBlendFunction(GLenum sourceFactor, GLenum destinationFactor)
+	{
+		GLStateCache& cache = mInstance;
+		if (cache.count(
+			(cache.mBlendSourceFactor == sourceFactor)
+			&& (cache.mBlendDestinationFactor == destinationFactor)
+		)) return;
+
+		glBlendFunc(sourceFactor, destinationFactor);
+		cache.mBlendSourceFactor		= sourceFactor;
+		cache.mBlendDestinationFactor	= destinationFactor;
+	}
+
+
+	void GLStateCache::setDepthFunction(GLenum function)
+	{
+		GLStateCache& cache = mInstance;
+		if (cache.count(cache.mDepthFunction == function)) return;
+
+		glDepthFunc(function);
+		cache.mDepthFunction = function;
+	}
+
+
+	void GLStateCache::setDepthMask(bool mask)
+	{
+		GLStateCache& cache = mInstance;
+		GLuint state = mask? 1 : 0;
+		if (cache.count(cache.mDepthMask == state)) return;
+
+		glDepthMask(mask? GL_TRUE : GL_FALSE);
+		cache.mDepthMask = state;
+	}
+
+
+	void GLStateCache::setCullFace(GLenum face)
+	{
+		GLStateCache& cache = mInstance;
+		if (cache.count(cache.mCullFace == face)) return;
+
+		glCullFace(face);
+		cache.mCullFace = face;
+	}
+
+
+	void GLStateCache::removeProgram(GLuint program)
+	{
+		// A Program in use isn't deleted until it stops being used
+		if (mInstance.mProgram == program) {
+			useProgram(0);
+		}
+	}
+
+
+	void GLStateCache::removeVertexArray(GLuint vertexArray)
+	{
+		GLStateCache& cache = mInstance;
+		if (cache.mVertexArray == vertexArray) {
+			cache.mVertexArray = 0;
+		}
+	}
+
+
+	void GLStateCache::removeFramebuffer(GLuint framebuffer)
+	{
+		GLStateCache& cache = mInstance;
+		if (cache.mDrawFramebuffer == framebuffer) {
+			cache.mDrawFramebuffer = 0;
+		}
+		if (cache.mReadFramebuffer == framebuffer) {
+			cache.mReadFramebuffer = 0;
+		}
+	}
+
+
+	void GLStateCache::removeTexture(GLuint texture)
+	{
+		for (TextureUnit& textureUnit : mInstance.mTextureUnits) {
+			if (textureUnit.mTexture == texture) {
+				textureUnit.mTexture = 0;
+			}
+		}
+	}
+
+
+	void GLStateCache::removeBuffer(GLuint buffer)
+	{
+		GLStateCache& cache = mInstance;
+		for (GLuint& boundBuffer : cache.mBuffers) {
+			if (boundBuffer == buffer) {
+				boundBuffer = 0;
+			}
+		}
+		for (BufferRange& range : cache.mUniformBindings) {
+			if (range.mBuffer == buffer) {
+				range = { 0, 0, -1 };
+			}
+		}
+	}
+
+// Private functions
+	GLStateCache::GLStateCache() :
+		mProgram(0), mVertexArray(0),
+		mDrawFramebuffer(0), mReadFramebuffer(0),
+		mActiveTextureUnit(0),
+		mBlendSourceFactor(GL_ONE), mBlendDestinationFactor(GL_ZERO),
+		mDepthFunction(GL_LESS), mDepthMask(1), mCullFace(GL_BACK),
+		mStatistics{ 0, 0 }
+	{
+		for (TextureUnit& textureUnit : mTextureUnits) {
+			textureUnit = { GL_TEXTURE_2D, 0 };
+		}
+		for (GLuint& buffer : mBuffers) {
+			buffer = 0;
+		}
+		for (BufferRange& range : mUniformBindings) {
+			range = { 0, 0, -1 };
+		}
+		for (GLuint& state : mCapabilityStates) {
+			state = 0;
+		}
+	}
+
+
+	bool GLStateCache::count(bool elided)
+	{
+		++mStatistics.mNumCalls;
+		if (elided) {
+			++mStatistics.mNumElidedCalls;
+		}
+
+		return elided;
+	}
+
+
+	void GLStateCache::setActiveTextureUnit(GLuint unit)
+	{
+		if (mActiveTextureUnit != unit) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+			mActiveTextureUnit = unit;
+		}
+	}
+
+
+	void GLStateCache::setCapability(GLenum capability, GLuint state)
+	{
+		unsigned int iCapability = 0;
+		while ((iCapability < NUM_CAPABILITIES) && (mCapabilities[iCapability] != capability)) {
+			++iCapability;
+		}
+
+		if (iCapability < NUM_CAPABILITIES) {
+			if (count(mCapabilityStates[iCapability] == state)) return;
+			mCapabilityStates[iCapability] = state;
+		}
+		else {
+			count(false);
+		}
+
+		if (state) {
+			glEnable(capability);
+		}
+		else {
+			glDisable(capability);
+		}
+	}
+
+
+	unsigned int GLStateCache::getBufferTargetIndex(GLenum target)
+	{
+		unsigned int iTarget = 0;
+		while ((iTarget < NUM_BUFFER_TARGETS) && (mBufferTargets[iTarget] != target)) {
+			++iTarget;
+		}
+
+		return iTarget;
+	}
+
+}
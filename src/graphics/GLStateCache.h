@@ -0,0 +1,273 @@
+#ifndef GL_STATE_CACHE_H
+#define GL_STATE_CACHE_H
+
+#include <GL/glew.h>
+
+namespace graphics {
+
+	/**
+	 * Class GLStateCache, it keeps a copy of the GL state of the context
+	 * (the Program in use, the bound objects and the fixed function state)
+	 * so the calls that wouldn't change it can be skipped. It follows the
+	 * Singleton pattern, since there is only one GL context.
+	 * <br>All the changes to the cached state must be done through the
+	 * GLStateCache from the thread of the GL context, and the objects must
+	 * be removed from it when they are deleted. The binding of the
+	 * GL_ELEMENT_ARRAY_BUFFER is part of the VAO state, so it's never
+	 * skipped.
+	 */
+	class GLStateCache
+	{
+	public:		// Nested types
+		/** Struct Statistics, it holds the number of state changes
+		 * requested to the GLStateCache since the last reset */
+		struct Statistics
+		{
+			/** The number of requested state changes */
+			unsigned int mNumCalls;
+
+			/** The number of requested state changes that were skipped
+			 * because the state was already set */
+			unsigned int mNumElidedCalls;
+		};
+
+	private:	// Nested types
+		/** Struct TextureUnit, it holds the texture last bound to a
+		 * texture unit and its target */
+		struct TextureUnit
+		{
+			GLenum mTarget;
+			GLuint mTexture;
+		};
+
+		/** Struct BufferRange, it holds the range of the buffer bound to
+		 * an indexed binding point */
+		struct BufferRange
+		{
+			GLuint mBuffer;
+			GLintptr mOffset;
+			GLsizeiptr mSize;
+		};
+
+	private:	// Attributes
+		/** The value used for the state that isn't known */
+		static const GLuint UNKNOWN = ~0u;
+
+		/** The number of texture units tracked */
+		static const unsigned int MAX_TEXTURE_UNITS = 32;
+
+		/** The number of uniform buffer binding points tracked */
+		static const unsigned int MAX_UNIFORM_BINDINGS = 36;
+
+		/** The buffer targets and capabilities tracked */
+		static const GLenum mBufferTargets[];
+		static const GLenum mCapabilities[];
+		static const unsigned int NUM_BUFFER_TARGETS = 5;
+		static const unsigned int NUM_CAPABILITIES = 4;
+
+		/** The only posible instance of the GLStateCache class */
+		static GLStateCache mInstance;
+
+		/** The Program in use */
+		GLuint mProgram;
+
+		/** The bound Vertex Array Object */
+		GLuint mVertexArray;
+
+		/** The bound draw and read framebuffers */
+		GLuint mDrawFramebuffer, mReadFramebuffer;
+
+		/** The active texture unit */
+		GLuint mActiveTextureUnit;
+
+		/** The textures bound to each texture unit */
+		TextureUnit mTextureUnits[MAX_TEXTURE_UNITS];
+
+		/** The buffers bound to each of mBufferTargets */
+		GLuint mBuffers[NUM_BUFFER_TARGETS];
+
+		/** The ranges bound to the uniform buffer binding points */
+		BufferRange mUniformBindings[MAX_UNIFORM_BINDINGS];
+
+		/** The state of each of mCapabilities: 1 if it's enabled, 0 if
+		 * it's disabled or UNKNOWN */
+		GLuint mCapabilityStates[NUM_CAPABILITIES];
+
+		/** The blending factors */
+		GLenum mBlendSourceFactor, mBlendDestinationFactor;
+
+		/** The depth comparison function */
+		GLenum mDepthFunction;
+
+		/** If the writing to the depth buffer is enabled or not */
+		GLuint mDepthMask;
+
+		/** The culled faces */
+		GLenum mCullFace;
+
+		/** The statistics since the last reset */
+		Statistics mStatistics;
+
+	public:		// Functions
+		/** Class destructor */
+		~GLStateCache() {};
+
+		/** Forgets all the cached state, so the next calls will change it
+		 * unconditionally. It must be called if the GL state is changed
+		 * without the GLStateCache */
+		static void invalidate();
+
+		/** @return	the statistics since the last reset */
+		static Statistics getStatistics();
+
+		/** Resets the statistics */
+		static void resetStatistics();
+
+		/** Uses the given Program
+		 *
+		 * @param	program the id of the Program, 0 for none */
+		static void useProgram(GLuint program);
+
+		/** Binds the given Vertex Array Object
+		 *
+		 * @param	vertexArray the id of the Vertex Array Object */
+		static void bindVertexArray(GLuint vertexArray);
+
+		/** Binds the given framebuffer
+		 *
+		 * @param	target GL_DRAW_FRAMEBUFFER, GL_READ_FRAMEBUFFER or
+		 *			GL_FRAMEBUFFER for both of them
+		 * @param	framebuffer the id of the framebuffer, 0 for the default
+		 *			one */
+		static void bindFramebuffer(GLenum target, GLuint framebuffer);
+
+		/** Binds the given texture to the given texture unit
+		 *
+		 * @param	unit the texture unit
+		 * @param	target the target of the texture
+		 * @param	texture the id of the texture */
+		static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+		/** Binds the given buffer to the given target
+		 *
+		 * @param	target the target of the buffer
+		 * @param	buffer the id of the buffer */
+		static void bindBuffer(GLenum target, GLuint buffer);
+
+		/** Binds the given buffer to the given indexed binding point
+		 *
+		 * @param	target the target of the binding point
+		 * @param	index the index of the binding point
+		 * @param	buffer the id of the buffer */
+		static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+
+		/** Binds the given range of a buffer to the given indexed binding
+		 * point
+		 *
+		 * @param	target the target of the binding point
+		 * @param	index the index of the binding point
+		 * @param	buffer the id of the buffer
+		 * @param	offset the offset in bytes of the range
+		 * @param	size the size in bytes of the range */
+		static void bindBufferRange(
+			GLenum target, GLuint index, GLuint buffer,
+			GLintptr offset, GLsizeiptr size
+		);
+
+		/** Enables the given capability
+		 *
+		 * @param	capability the capability to enable */
+		static void enable(GLenum capability);
+
+		/** Disables the given capability
+		 *
+		 * @param	capability the capability to disable */
+		static void disable(GLenum capability);
+
+		/** Sets the blending factors
+		 *
+		 * @param	sourceFactor the factor of the source color
+		 * @param	destinationFactor the factor of the destination color */
+		static void setBlendFunction(GLenum sourceFactor, GLenum destinationFactor);
+
+		/** Sets the depth comparison function
+		 *
+		 * @param	function the new depth comparison function */
+		static void setDepthFunction(GLenum function);
+
+		/** Enables or disables the writing to the depth buffer
+		 *
+		 * @param	mask true for enabling the writing, false otherwise */
+		static void setDepthMask(bool mask);
+
+		/** Sets the faces that will be culled
+		 *
+		 * @param	face GL_FRONT, GL_BACK or GL_FRONT_AND_BACK */
+		static void setCullFace(GLenum face);
+
+		/** Removes the given Program from the cached state, it must be
+		 * called before deleting it
+		 *
+		 * @param	program the id of the Program */
+		static void removeProgram(GLuint program);
+
+		/** Removes the given Vertex Array Object from the cached state, it
+		 * must be called when it's deleted
+		 *
+		 * @param	vertexArray the id of the Vertex Array Object */
+		static void removeVertexArray(GLuint vertexArray);
+
+		/** Removes the given framebuffer from the cached state, it must be
+		 * called when it's deleted
+		 *
+		 * @param	framebuffer the id of the framebuffer */
+		static void removeFramebuffer(GLuint framebuffer);
+
+		/** Removes the given texture from the cached state, it must be
+		 * called when it's deleted
+		 *
+		 * @param	texture the id of the texture */
+		static void removeTexture(GLuint texture);
+
+		/** Removes the given buffer from the cached state, it must be
+		 * called when it's deleted
+		 *
+		 * @param	buffer the id of the buffer */
+		static void removeBuffer(GLuint buffer);
+	private:
+		/** Class constructor, it's private for preventing construction.
+		 * The cached state starts with the default values of a new GL
+		 * context */
+		GLStateCache();
+
+		/** Constructor-Copy object, it's private for preventing
+		 * construction by copy */
+		GLStateCache(const GLStateCache&);
+
+		/** Updates the statistics with a requested state change
+		 *
+		 * @param	elided if the state change was skipped or not
+		 * @return	elided */
+		bool count(bool elided);
+
+		/** Makes the given texture unit the active one
+		 *
+		 * @param	unit the texture unit */
+		void setActiveTextureUnit(GLuint unit);
+
+		/** Enables or disables the given capability
+		 *
+		 * @param	capability the capability
+		 * @param	state 1 for enabling it, 0 for disabling it */
+		void setCapability(GLenum capability, GLuint state);
+
+		/** Returns the index in mBufferTargets of the given target
+		 *
+		 * @param	target the buffer target
+		 * @return	the index, NUM_BUFFER_TARGETS if it isn't tracked */
+		static unsigned int getBufferTargetIndex(GLenum target);
+	};
+
+}
+
+#endif		// GL_STATE_CACHE_H
@@ -1,6 +1,9 @@
 #include "GraphicsSystem.h"
 #include <GL/glew.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include "../utils/Logger.h"
+#include "GLStateCache.h"
+#include "ProgramCache.h"
 #include "3D/Camera.h"
 #include "3D/Renderable3D.h"
 
@@ -12,25 +15,37 @@ namespace graphics {
 	const float GraphicsSystem::Z_FAR	= 100.0f;
 
 // Public functions
-	GraphicsSystem::GraphicsSystem() :
+	GraphicsSystem::GraphicsSystem(unsigned int width, unsigned int height, JobSystem& jobSystem) :
+		mWidth(width), mHeight(height), mJobSystem(jobSystem),
+		mProjectionMatrix(glm::perspective(FOV, (float)width / (float)height, Z_NEAR, Z_FAR)),
 		mRenderer2D(),
-		mProjectionMatrix(glm::perspective(FOV, (float)WIDTH / (float)HEIGHT, Z_NEAR, Z_FAR)),
-		mSceneRenderer(mProjectionMatrix)
+		mSceneRenderer(mProjectionMatrix, jobSystem),
+		mRenderingMode(FORWARD_RENDERING)
 	{
 		// Enable depth-testing
-		glEnable(GL_DEPTH_TEST);
-		glDepthMask(GL_TRUE);
-		glDepthFunc(GL_LEQUAL);		// Write if depth <= depth buffer
+		GLStateCache::enable(GL_DEPTH_TEST);
+		GLStateCache::setDepthMask(true);
+		GLStateCache::setDepthFunction(GL_LEQUAL);	// Write if depth <= depth buffer
 		glDepthRange(0.0f, 1.0f);	// The Z coordinate range is [0,1]
 
 		// Enable face culling - tells OpenGL to not draw the faces that
 		// cannot be seen
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
+		GLStateCache::enable(GL_CULL_FACE);
+		GLStateCache::setCullFace(GL_BACK);
 		glFrontFace(GL_CCW);		// Render only the counter-clockwise faces
 
 		// The Clear Color of the window
 		glClearColor(1.0f, 0.95f, 1.0f, 1.0f);
+
+		// Log the time spent creating the Programs of the renderers, it's
+		// much lower when they are loaded from the ProgramCache
+		ProgramCache::Statistics programStatistics = ProgramCache::getStatistics();
+		Logger::writeLog(
+			LogType::DEBUG,
+			"Programs created in " + std::to_string(programStatistics.mLoadTime + programStatistics.mCompileTime) + " ms ("
+				+ std::to_string(programStatistics.mNumLoaded) + " loaded from the cache, "
+				+ std::to_string(programStatistics.mNumCompiled) + " compiled)"
+		);
 	}
 
 
@@ -38,19 +53,53 @@ namespace graphics {
 		const Camera* camera,
 		const std::vector<const Renderable3D*>& renderable3Ds,
 		const std::vector<const Renderable2D*>& renderable2Ds,
-		const std::vector<const PointLight*>& pointLights
+		const std::vector<const PointLight*>& pointLights,
+		const std::vector<const SpotLight*>& spotLights
 	) {
+		GLStateCache::resetStatistics();
+
+		// The clear is affected by the scissor test and the depth mask
+		GLStateCache::disable(GL_SCISSOR_TEST);
+		GLStateCache::setDepthMask(true);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		for (const Renderable3D* renderable3D : renderable3Ds) {
-			mSceneRenderer.submit(renderable3D);
+		if (mRenderingMode == DEFERRED_RENDERING) {
+			mDeferredRenderer->submit(renderable3Ds);
+			mDeferredRenderer->render(camera, pointLights, spotLights);
 		}
-		mSceneRenderer.render(camera, pointLights);
-
-		for (const Renderable2D* renderable2D : renderable2Ds) {
-			mRenderer2D.submit(renderable2D);
+		else {
+			mSceneRenderer.submit(renderable3Ds);
+			mSceneRenderer.render(camera, pointLights, spotLights);
 		}
+
+		mRenderer2D.submit(renderable2Ds);
 		mRenderer2D.render();
 	}
 
+
+	void GraphicsSystem::setRenderingMode(RenderingMode renderingMode)
+	{
+		if ((renderingMode == DEFERRED_RENDERING) && !mDeferredRenderer) {
+			mDeferredRenderer = std::unique_ptr<DeferredRenderer>(
+				new DeferredRenderer(mProjectionMatrix, mWidth, mHeight, mJobSystem)
+			);
+		}
+
+		mRenderingMode = renderingMode;
+	}
+
+
+	SceneBatcher::Statistics GraphicsSystem::getSceneStatistics() const
+	{
+		return (mRenderingMode == DEFERRED_RENDERING)?
+			mDeferredRenderer->getStatistics() :
+			mSceneRenderer.getStatistics();
+	}
+
+
+	GLStateCache::Statistics GraphicsSystem::getGLStatistics() const
+	{
+		return GLStateCache::getStatistics();
+	}
+
 }
@@ -2,8 +2,11 @@
 #define GRAPHICS_SYSTEM_H
 
 #include <vector>
+#include <memory>
 #include "2D/Renderer2D.h"
 #include "3D/SceneRenderer.h"
+#include "3D/DeferredRenderer.h"
+#include "GLStateCache.h"
 
 namespace graphics {
 
@@ -11,6 +14,7 @@ namespace graphics {
 	class Renderable2D;
 	class Camera;
 	class PointLight;
+	class SpotLight;
 
 
 	/**
@@ -18,22 +22,46 @@ namespace graphics {
 	 */
 	class GraphicsSystem
 	{
+	public:		// Nested types
+		/** The renderers that can be used for rendering the 3D scene */
+		enum RenderingMode
+		{
+			FORWARD_RENDERING,
+			DEFERRED_RENDERING
+		};
+
 	private:	// Attributes
-		static const unsigned int WIDTH = 640;
-		static const unsigned int HEIGHT = 480;
 		static const float FOV;
 		static const float Z_NEAR;
 		static const float Z_FAR;
 
+		/** The size of the viewport */
+		unsigned int mWidth, mHeight;
+
+		/** The JobSystem used for preparing the frames in parallel */
+		JobSystem& mJobSystem;
+
 		glm::mat4 mProjectionMatrix;
 
 		Renderer2D mRenderer2D;
 
 		SceneRenderer mSceneRenderer;
 
+		/** The renderer used in DEFERRED_RENDERING mode, it's created the
+		 * first time that the mode is selected */
+		std::unique_ptr<DeferredRenderer> mDeferredRenderer;
+
+		/** The renderer currently used for rendering the 3D scene */
+		RenderingMode mRenderingMode;
+
 	public:		// Functions
-		/** Creates a new Graphics System */
-		GraphicsSystem();
+		/** Creates a new Graphics System
+		 *
+		 * @param	width the width of the viewport
+		 * @param	height the height of the viewport
+		 * @param	jobSystem the JobSystem used by the renderers for
+		 *			preparing the frames in parallel */
+		GraphicsSystem(unsigned int width, unsigned int height, JobSystem& jobSystem);
 
 		/** Class destructor */
 		~GraphicsSystem() {};
@@ -43,8 +71,25 @@ namespace graphics {
 			const Camera* camera,
 			const std::vector<const Renderable3D*>& renderable3Ds,
 			const std::vector<const Renderable2D*>& renderable2Ds,
-			const std::vector<const PointLight*>& pointLights
+			const std::vector<const PointLight*>& pointLights,
+			const std::vector<const SpotLight*>& spotLights
 		);
+
+		/** Selects the renderer used for rendering the 3D scene
+		 *
+		 * @param	renderingMode the new RenderingMode */
+		void setRenderingMode(RenderingMode renderingMode);
+
+		/** @return	the renderer used for rendering the 3D scene */
+		inline RenderingMode getRenderingMode() const
+		{ return mRenderingMode; };
+
+		/** @return	the statistics of the last rendered 3D scene */
+		SceneBatcher::Statistics getSceneStatistics() const;
+
+		/** @return	the statistics of the GL state changes of the last
+		 *			rendered frame */
+		GLStateCache::Statistics getGLStatistics() const;
 	};
 
 }
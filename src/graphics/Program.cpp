@@ -1,49 +1,71 @@
 #include "Program.h"
-#include <string>
+#include <chrono>
+#include <cstdio>
+#include <memory>
 #include <stdexcept>
 #include <glm/gtc/type_ptr.hpp>
-#include "Shader.h"
+#include "../utils/Logger.h"
+#include "GLStateCache.h"
+#include "ProgramCache.h"
 
 namespace graphics {
 
 	Program::Program(const std::vector<const Shader*>& shaders)
 	{
-		// 1. Create the program
 		mProgramID = glCreateProgram();
+		link(shaders);
+	}
 
-		// 2. Attach the shaders to the program
-		for (const Shader* shader : shaders) {
-			glAttachShader(mProgramID, shader->getShaderID());
-		}
-
-		glLinkProgram(mProgramID);
-
-		// 3. Check program related errors
-		GLint status;
-		glGetProgramiv(mProgramID, GL_LINK_STATUS, &status);
-		if (status == GL_FALSE) {
-			GLint infoLogLength;
-			glGetProgramiv(mProgramID, GL_INFO_LOG_LENGTH, &infoLogLength);
-
-			GLchar* infoLog = new GLchar[infoLogLength + 1];
-			glGetProgramInfoLog(mProgramID, infoLogLength, NULL, infoLog);
-
-			std::string strInfoLog = "Failed to compile the program\n" + std::string(infoLog);
-			delete[] infoLog;
 
-			throw std::runtime_error(strInfoLog);
+	Program::Program(
+		const std::vector<ShaderSource>& sources,
+		const std::string& defines
+	) {
+		auto start = std::chrono::steady_clock::now();
+
+		// 1. Load the program from the cache
+		std::uint64_t key = ProgramCache::getKey(sources, defines);
+		mProgramID = ProgramCache::load(key);
+		bool loaded = (mProgramID != 0);
+
+		// 2. Compile it if it wasn't in the cache or the driver rejected
+		// its binary
+		if (!loaded) {
+			std::vector<std::unique_ptr<Shader>> shaders;
+			std::vector<const Shader*> shaderPointers;
+			for (const ShaderSource& source : sources) {
+				std::string text = defines.empty()? source.mText : injectDefines(source.mText, defines);
+				shaders.push_back(std::make_unique<Shader>(text.c_str(), source.mType));
+				shaderPointers.push_back(shaders.back().get());
+			}
+
+			mProgramID = glCreateProgram();
+			if (ProgramCache::isEnabled()) {
+				glProgramParameteri(mProgramID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
+
+			link(shaderPointers);
+			ProgramCache::save(key, mProgramID);
 		}
 
-		// 4. Remove the shaders from the program
-		for (const Shader* shader: shaders) {
-			glDetachShader(mProgramID, shader->getShaderID());
-		}
+		// 3. Log the time spent creating it, so the cold and warm starts
+		// can be compared
+		std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+		ProgramCache::addProgram(loaded, elapsed.count());
+
+		char keyText[17];
+		std::snprintf(keyText, sizeof(keyText), "%016llx", static_cast<unsigned long long>(key));
+		Logger::writeLog(
+			LogType::DEBUG,
+			std::string("Program ") + keyText + (loaded? " loaded from the cache in " : " compiled in ")
+				+ std::to_string(elapsed.count()) + " ms"
+		);
 	}
 	
 
 	Program::~Program()
 	{
-		disable();
+		GLStateCache::removeProgram(mProgramID);
 		glDeleteProgram(mProgramID);
 	}
 
@@ -54,6 +76,18 @@ namespace graphics {
 	}
 
 
+	bool Program::setUniformBlockBinding(const char* name, GLuint bindingPoint) const
+	{
+		GLuint blockIndex = glGetUniformBlockIndex(mProgramID, name);
+		if (blockIndex == GL_INVALID_INDEX) {
+			return false;
+		}
+
+		glUniformBlockBinding(mProgramID, blockIndex, bindingPoint);
+		return true;
+	}
+
+
 	void Program::setUniform(const char* name, int value) const
 	{
 		glUniform1i(glGetUniformLocation(mProgramID, name), value);
@@ -171,13 +205,71 @@ namespace graphics {
 
 	void Program::enable() const
 	{
-		glUseProgram(mProgramID);
+		GLStateCache::useProgram(mProgramID);
 	}
 	
 
 	void Program::disable()
 	{
-		glUseProgram(0);
+		GLStateCache::useProgram(0);
+	}
+
+
+// Private functions
+	void Program::link(const std::vector<const Shader*>& shaders)
+	{
+		// 1. Attach the shaders to the program
+		for (const Shader* shader : shaders) {
+			glAttachShader(mProgramID, shader->getShaderID());
+		}
+
+		glLinkProgram(mProgramID);
+
+		// 2. Check program related errors
+		GLint status;
+		glGetProgramiv(mProgramID, GL_LINK_STATUS, &status);
+		if (status == GL_FALSE) {
+			GLint infoLogLength;
+			glGetProgramiv(mProgramID, GL_INFO_LOG_LENGTH, &infoLogLength);
+
+			GLchar* infoLog = new GLchar[infoLogLength + 1];
+			glGetProgramInfoLog(mProgramID, infoLogLength, NULL, infoLog);
+
+			std::string strInfoLog = "Failed to compile the program\n" + std::string(infoLog);
+			delete[] infoLog;
+
+			throw std::runtime_error(strInfoLog);
+		}
+
+		// 3. Remove the shaders from the program
+		for (const Shader* shader: shaders) {
+			glDetachShader(mProgramID, shader->getShaderID());
+		}
+	}
+
+
+	std::string Program::injectDefines(
+		const std::string& text, const std::string& defines
+	) {
+		// The #version directive must be the first one of the shader
+		std::string::size_type position = 0;
+		std::string::size_type versionPosition = text.find("#version");
+		if (versionPosition != std::string::npos) {
+			position = text.find('\n', versionPosition);
+			position = (position != std::string::npos)? position + 1 : text.size();
+		}
+
+		std::string result = text.substr(0, position);
+		if (!result.empty() && (result.back() != '\n')) {
+			result += '\n';
+		}
+		result += defines;
+		if (!defines.empty() && (defines.back() != '\n')) {
+			result += '\n';
+		}
+		result += text.substr(position);
+
+		return result;
 	}
 
 }
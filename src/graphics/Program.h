@@ -1,19 +1,21 @@
 #ifndef PROGRAM_H
 #define PROGRAM_H
 
+#include <string>
 #include <vector>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include "PrimitiveTypes.h"
+#include "Shader.h"
 
 namespace graphics {
 
-	class Shader;
-
-
 	/**
 	 * Program Class, the program class is used to load the GLSL programs
-	 * and access to its uniform variables
+	 * and access to its uniform variables.
+	 * <br>The Programs created from source code are stored in the
+	 * ProgramCache, so they aren't compiled again in the following
+	 * launches
 	 */
 	class Program
 	{
@@ -28,6 +30,20 @@ namespace graphics {
 		 *			Program */
 		Program(const std::vector<const Shader*>& shaders);
 
+		/** Creates a OpenGL program from the specified source code. The
+		 * program is loaded from the ProgramCache if it's there, otherwise
+		 * the shaders are compiled and linked and the program is stored
+		 * in the ProgramCache
+		 *
+		 * @param	sources the source code of the shaders that compose the
+		 *			GLSL Program
+		 * @param	defines the preprocessor definitions injected after the
+		 *			#version directive of each shader, one per line */
+		Program(
+			const std::vector<ShaderSource>& sources,
+			const std::string& defines = ""
+		);
+
 		/** Class destructor */
 		~Program();
 
@@ -38,6 +54,14 @@ namespace graphics {
 		 * @return	the location of the uniform variable */
 		GLuint getUniformLocation(const char* name) const;
 
+		/** Binds the given uniform block to the given binding point, so it
+		 * reads its data from the buffer bound to that binding point
+		 *
+		 * @param	name the name of the uniform block
+		 * @param	bindingPoint the index of the binding point
+		 * @return	true if the uniform block was found, false otherwise */
+		bool setUniformBlockBinding(const char* name, GLuint bindingPoint) const;
+
 		void setUniform(const char* name,	int value) const;
 		void setUniform(GLuint location,	int value) const;
 		
@@ -71,6 +95,22 @@ namespace graphics {
 		
 		/** Resets the current shader object */
 		static void disable();
+	private:
+		/** Links the program from the specified shaders
+		 *
+		 * @param	shaders a list with the shaders that compose the GLSL
+		 *			Program */
+		void link(const std::vector<const Shader*>& shaders);
+
+		/** Injects the given defines in the given source code
+		 *
+		 * @param	text the GLSL source code of a shader
+		 * @param	defines the preprocessor definitions to inject
+		 * @return	the source code with the defines after its #version
+		 *			directive, or at the start if it doesn't have one */
+		static std::string injectDefines(
+			const std::string& text, const std::string& defines
+		);
 	};
 
 }
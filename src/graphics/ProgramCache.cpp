@@ -0,0 +1,225 @@
+#include "ProgramCache.h"
+#include <cstdio>
+#include <fstream>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+	#include <direct.h>
+#endif
+#include "../utils/Logger.h"
+#include "../utils/MappedFile.h"
+
+namespace graphics {
+
+// Static variables definition
+	const char* ProgramCache::PROGRAM_FILE_EXTENSION = ".fzpb";
+	ProgramCache ProgramCache::mInstance;
+
+// Public functions
+	void ProgramCache::setDirectory(const std::string& directory)
+	{
+		mInstance.mDirectory = directory;
+	}
+
+
+	bool ProgramCache::isEnabled()
+	{
+		mInstance.initialize();
+		return !mInstance.mDirectory.empty() && mInstance.mSupported;
+	}
+
+
+	std::uint64_t ProgramCache::getKey(
+		const std::vector<ShaderSource>& sources,
+		const std::string& defines
+	) {
+		mInstance.initialize();
+
+		// FNV-1a hash of all the strings, including their null
+		// terminators so the boundaries between them are also hashed
+		std::uint64_t key = 14695981039346656037ull;
+		auto hash = [&key](const char* data, std::size_t size) {
+			for (std::size_t i = 0; i < size; ++i) {
+				key ^= static_cast<unsigned char>(data[i]);
+				key *= 1099511628211ull;
+			}
+		};
+
+		hash(mInstance.mDriver.c_str(), mInstance.mDriver.size() + 1);
+		hash(defines.c_str(), defines.size() + 1);
+		for (const ShaderSource& source : sources) {
+			hash(reinterpret_cast<const char*>(&source.mType), sizeof(GLenum));
+			hash(source.mText.c_str(), source.mText.size() + 1);
+		}
+
+		return key;
+	}
+
+
+	GLuint ProgramCache::load(std::uint64_t key)
+	{
+		if (!isEnabled()) {
+			return 0;
+		}
+
+		const std::string path = mInstance.getPath(key);
+		MappedFile file(path);
+		if (!file.isOpen()) {
+			return 0;
+		}
+
+		const unsigned char* data = file.getData();
+		const std::uint64_t size = file.getSize();
+		const ProgramFileHeader* header = reinterpret_cast<const ProgramFileHeader*>(data);
+
+		// Validate the header before reading any data through it
+		const char* error = nullptr;
+		if (size < sizeof(ProgramFileHeader)) {
+			error = "truncated header";
+		}
+		else if (header->mMagic != PROGRAM_FILE_MAGIC) {
+			error = "it isn't a program binary file";
+		}
+		else if (header->mVersion != PROGRAM_FILE_VERSION) {
+			error = "unsupported version";
+		}
+		else if (header->mKey != key) {
+			error = "different key";
+		}
+		else if (size - sizeof(ProgramFileHeader) < header->mBinarySize) {
+			error = "truncated binary";
+		}
+
+		if (error) {
+			Logger::writeLog(LogType::WARNING, "Error loading the program binary file " + path + ": " + error);
+			return 0;
+		}
+
+		// The driver can reject the binary even if it was created with
+		// the same driver strings, like after an update of the driver
+		// that didn't change them
+		GLuint programID = glCreateProgram();
+		glProgramBinary(programID, header->mBinaryFormat, data + sizeof(ProgramFileHeader), header->mBinarySize);
+
+		GLint status;
+		glGetProgramiv(programID, GL_LINK_STATUS, &status);
+		if (status == GL_FALSE) {
+			Logger::writeLog(LogType::WARNING, "The driver rejected the program binary file " + path);
+			glDeleteProgram(programID);
+			return 0;
+		}
+
+		return programID;
+	}
+
+
+	bool ProgramCache::save(std::uint64_t key, GLuint programID)
+	{
+		if (!isEnabled()) {
+			return false;
+		}
+
+		GLint binarySize = 0;
+		glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+		if (binarySize <= 0) {
+			return false;
+		}
+
+		ProgramFileHeader header = {};
+		header.mMagic		= PROGRAM_FILE_MAGIC;
+		header.mVersion		= PROGRAM_FILE_VERSION;
+		header.mKey			= key;
+
+		std::vector<char> binary(binarySize);
+		GLenum binaryFormat;
+		GLsizei length = 0;
+		glGetProgramBinary(programID, binarySize, &length, &binaryFormat, binary.data());
+		header.mBinaryFormat	= binaryFormat;
+		header.mBinarySize		= length;
+
+		// Create the directory if it doesn't exist yet, ignoring the
+		// errors since opening the file will also fail
+		std::string directory = mInstance.mDirectory;
+		if (!directory.empty() && ((directory.back() == '/') || (directory.back() == '\\'))) {
+			directory.pop_back();
+		}
+#ifdef _WIN32
+		_mkdir(directory.c_str());
+#else
+		mkdir(directory.c_str(), 0755);
+#endif
+
+		const std::string path = mInstance.getPath(key);
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(ProgramFileHeader));
+		file.write(binary.data(), length);
+
+		if (!file.good()) {
+			Logger::writeLog(LogType::ERROR, "Error writing the program binary file " + path);
+			return false;
+		}
+
+		return true;
+	}
+
+
+	void ProgramCache::addProgram(bool loaded, float time)
+	{
+		Statistics& statistics = mInstance.mStatistics;
+		if (loaded) {
+			++statistics.mNumLoaded;
+			statistics.mLoadTime += time;
+		}
+		else {
+			++statistics.mNumCompiled;
+			statistics.mCompileTime += time;
+		}
+	}
+
+
+	ProgramCache::Statistics ProgramCache::getStatistics()
+	{
+		return mInstance.mStatistics;
+	}
+
+// Private functions
+	ProgramCache::ProgramCache() :
+		mDirectory("res/shaders/cache/"),
+		mInitialized(false), mSupported(false),
+		mStatistics{ 0, 0, 0.0f, 0.0f } {}
+
+
+	void ProgramCache::initialize()
+	{
+		if (mInitialized) {
+			return;
+		}
+
+		// The driver can support the extension without any binary format
+		GLint numFormats = 0;
+		if (GLEW_ARB_get_program_binary) {
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+		}
+		mSupported = (numFormats > 0);
+
+		const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+		for (GLenum name : names) {
+			const GLubyte* value = glGetString(name);
+			if (value) {
+				mDriver += reinterpret_cast<const char*>(value);
+			}
+			mDriver += '\n';
+		}
+
+		mInitialized = true;
+	}
+
+
+	std::string ProgramCache::getPath(std::uint64_t key) const
+	{
+		char name[17];
+		std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+		return mDirectory + name + PROGRAM_FILE_EXTENSION;
+	}
+
+}
@@ -0,0 +1,171 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <GL/glew.h>
+#include "Shader.h"
+
+namespace graphics {
+
+	/**
+	 * Class ProgramCache, it stores the binaries of the linked Programs in
+	 * program binary files, so the following launches can load them
+	 * instead of compiling and linking their shaders again. It follows
+	 * the Singleton pattern, since there is only one GL context.
+	 * <br>The binaries are identified by a key, a hash of the GLSL source
+	 * code, the defines and the vendor, renderer and version strings of
+	 * the driver, so they are compiled again when any of them changes. The
+	 * files are named with the key in hexadecimal followed by the
+	 * PROGRAM_FILE_EXTENSION, and start with a ProgramFileHeader followed
+	 * by the binary. The drivers can still reject a binary, in that case
+	 * the Program must be compiled from its source code.
+	 * <br>If the driver doesn't support program binaries the cache is
+	 * disabled
+	 */
+	class ProgramCache
+	{
+	public:		// Nested types
+		/** Struct Statistics, it holds the number of Programs created
+		 * since the start and the time spent creating them */
+		struct Statistics
+		{
+			/** The number of Programs loaded from the cache */
+			unsigned int mNumLoaded;
+
+			/** The number of Programs compiled from their source code */
+			unsigned int mNumCompiled;
+
+			/** The time in milliseconds spent loading and compiling
+			 * them */
+			float mLoadTime, mCompileTime;
+		};
+
+	private:	// Nested types
+		/** Struct ProgramFileHeader, it's stored at the start of the
+		 * program binary files */
+		struct ProgramFileHeader
+		{
+			/** The PROGRAM_FILE_MAGIC number */
+			std::uint32_t mMagic;
+
+			/** The PROGRAM_FILE_VERSION of the file */
+			std::uint32_t mVersion;
+
+			/** The key of the Program */
+			std::uint64_t mKey;
+
+			/** The format of the binary returned by the driver */
+			std::uint32_t mBinaryFormat;
+
+			/** The size in bytes of the binary */
+			std::uint32_t mBinarySize;
+		};
+
+	private:	// Attributes
+		/** The identifier of the program binary files, "FZPB" in little
+		 * endian */
+		static const std::uint32_t PROGRAM_FILE_MAGIC = 0x42505A46;
+
+		/** The version of the format of the program binary files */
+		static const std::uint32_t PROGRAM_FILE_VERSION = 1;
+
+		/** The extension of the program binary files */
+		static const char* PROGRAM_FILE_EXTENSION;
+
+		/** The only posible instance of the ProgramCache class */
+		static ProgramCache mInstance;
+
+		/** The directory of the program binary files, if it's empty the
+		 * cache is disabled */
+		std::string mDirectory;
+
+		/** If the driver information has been read */
+		bool mInitialized;
+
+		/** If the driver supports program binaries */
+		bool mSupported;
+
+		/** The vendor, renderer and version strings of the driver */
+		std::string mDriver;
+
+		/** The Statistics of the created Programs */
+		Statistics mStatistics;
+
+	public:		// Functions
+		/** Class destructor */
+		~ProgramCache() {};
+
+		/** Sets the directory where the program binary files are stored,
+		 * it's created when the first file is saved
+		 *
+		 * @param	directory the path of the directory ending with a
+		 *			separator, an empty path disables the cache */
+		static void setDirectory(const std::string& directory);
+
+		/** @return	true if the Programs can be stored in the cache, false
+		 *			if it's disabled or the driver doesn't support
+		 *			program binaries. It must be called from the thread of
+		 *			the GL context */
+		static bool isEnabled();
+
+		/** Calculates the key of a Program
+		 *
+		 * @param	sources the source code of the shaders of the Program
+		 * @param	defines the defines injected in the source code
+		 * @return	the key of the Program */
+		static std::uint64_t getKey(
+			const std::vector<ShaderSource>& sources,
+			const std::string& defines
+		);
+
+		/** Creates a Program from its program binary file
+		 *
+		 * @param	key the key of the Program
+		 * @return	the ID of the new Program, 0 if the file doesn't exist,
+		 *			it isn't valid or the driver rejected the binary */
+		static GLuint load(std::uint64_t key);
+
+		/** Stores the binary of the given Program in its program binary
+		 * file
+		 *
+		 * @param	key the key of the Program
+		 * @param	programID the ID of the Program, it must have been
+		 *			linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+		 * @return	true if the file was saved, false otherwise */
+		static bool save(std::uint64_t key, GLuint programID);
+
+		/** Registers the creation of a Program in the Statistics
+		 *
+		 * @param	loaded if the Program was loaded from the cache or
+		 *			compiled from its source code
+		 * @param	time the time in milliseconds spent creating it */
+		static void addProgram(bool loaded, float time);
+
+		/** @return	the Statistics of the Programs created since the
+		 *			start */
+		static Statistics getStatistics();
+	private:
+		/** Class constructor, it's private for preventing construction */
+		ProgramCache();
+
+		/** Constructor-Copy object, it's private for preventing
+		 * construction by copy */
+		ProgramCache(const ProgramCache&);
+
+		/** Reads the information of the driver the first time it's
+		 * called */
+		void initialize();
+
+		/** Returns the path of the program binary file of the Program
+		 * with the given key
+		 *
+		 * @param	key the key of the Program
+		 * @return	the path of the file */
+		std::string getPath(std::uint64_t key) const;
+	};
+
+}
+
+#endif		// PROGRAM_CACHE_H
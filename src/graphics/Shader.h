@@ -1,10 +1,26 @@
 #ifndef SHADER_H
 #define SHADER_H
 
+#include <string>
 #include <GL/glew.h>
 
 namespace graphics {
 
+	/**
+	 * Struct ShaderSource, it holds the GLSL source code of one of the
+	 * shaders of a Program, so it can be compiled only when needed
+	 */
+	struct ShaderSource
+	{
+		/** The type of the shader (Usually GL_VERTEX_SHADER or
+		 * GL_FRAGMENT_SHADER) */
+		GLenum mType;
+
+		/** The GLSL source code of the shader */
+		std::string mText;
+	};
+
+
 	/**
 	 * Class Shader, it represents a GLSL shader. A shader is one of the
 	 * programable stages of the OpenGL pipeline
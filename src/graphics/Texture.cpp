@@ -1,10 +1,14 @@
 #include "Texture.h"
 #include <FreeImage.h>
+#include "../utils/IDGenerator.h"
+#include "GLStateCache.h"
 
 namespace graphics {
 
 	Texture::Texture(const std::string& texturePath, GLuint textureTarget) :
-		mTexturePath(texturePath), mTextureTarget(textureTarget)
+		mID(IDGenerator<Texture>::nextID()),
+		mTexturePath(texturePath), mTextureTarget(textureTarget),
+		mWidth(0), mHeight(0), mGPUSize(0)
 	{
 		const char* path = texturePath.c_str();
 
@@ -27,35 +31,123 @@ namespace graphics {
 		BYTE* pixels = FreeImage_GetBits(bitmap);
 
 		// Create the texture from the image
+		mWidth = width;
+		mHeight = height;
+		mGPUSize = 4 * static_cast<std::size_t>(width) * height;
 		glGenTextures(1, &mTextureID);
 
-		glBindTexture(mTextureTarget, mTextureID);	// Bind texture
+		GLStateCache::bindTexture(0, mTextureTarget, mTextureID);
 
 		glTexImage2D(mTextureTarget, 0, GL_RGBA, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
 		glTexParameteri(mTextureTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(mTextureTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 
-		glBindTexture(mTextureTarget, 0);			// Unbind texture
-
 		FreeImage_Unload(bitmap);
 	}
 
 
+	Texture::Texture(
+		const std::string& name, GLuint textureTarget,
+		const GLubyte* pixels, GLsizei width, GLsizei height
+	) : mID(IDGenerator<Texture>::nextID()),
+		mTexturePath(name), mTextureTarget(textureTarget),
+		mWidth(width), mHeight(height),
+		mGPUSize(4 * static_cast<std::size_t>(width) * height)
+	{
+		glGenTextures(1, &mTextureID);
+		GLStateCache::bindTexture(0, mTextureTarget, mTextureID);
+
+		glTexImage2D(mTextureTarget, 0, GL_RGBA, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
+		glTexParameteri(mTextureTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(mTextureTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	}
+
+
+	Texture::Texture(
+		const std::string& name, GLuint textureTarget,
+		std::shared_ptr<Texture> placeholder
+	) : mID(IDGenerator<Texture>::nextID()),
+		mTexturePath(name), mTextureTarget(textureTarget),
+		mWidth(0), mHeight(0), mGPUSize(0),
+		mPlaceholder(std::move(placeholder))
+	{
+		glGenTextures(1, &mTextureID);
+		GLStateCache::bindTexture(0, mTextureTarget, mTextureID);
+
+		glTexParameteri(mTextureTarget, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(mTextureTarget, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	}
+
+
 	Texture::~Texture()
 	{
+		GLStateCache::removeTexture(mTextureID);
 		glDeleteTextures(1, &mTextureID);
 	}
 
 
-	void Texture::bind() const
+	void Texture::allocate(
+		GLint level, GLenum internalFormat,
+		GLsizei width, GLsizei height, GLsizei imageSize
+	) {
+		if (level == 0) {
+			mWidth = width;
+			mHeight = height;
+		}
+
+		GLStateCache::bindTexture(0, mTextureTarget, mTextureID);
+		if (internalFormat == GL_RGBA) {
+			glTexImage2D(mTextureTarget, level, GL_RGBA, width, height, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+			mGPUSize += 4 * static_cast<std::size_t>(width) * height;
+		}
+		else {
+			glCompressedTexImage2D(mTextureTarget, level, internalFormat, width, height, 0, imageSize, nullptr);
+			mGPUSize += imageSize;
+		}
+	}
+
+
+	void Texture::setRows(
+		GLint level, GLenum internalFormat,
+		GLint firstRow, GLsizei width, GLsizei numRows,
+		GLsizei imageSize, const GLvoid* pixels
+	) {
+		GLStateCache::bindTexture(0, mTextureTarget, mTextureID);
+		if (internalFormat == GL_RGBA) {
+			glTexSubImage2D(mTextureTarget, level, 0, firstRow, width, numRows, GL_BGRA, GL_UNSIGNED_BYTE, pixels);
+		}
+		else {
+			glCompressedTexSubImage2D(mTextureTarget, level, 0, firstRow, width, numRows, internalFormat, imageSize, pixels);
+		}
+	}
+
+
+	void Texture::setLevelRange(GLint baseLevel, GLint maxLevel)
 	{
-		glBindTexture(mTextureTarget, mTextureID);
+		GLStateCache::bindTexture(0, mTextureTarget, mTextureID);
+		glTexParameteri(mTextureTarget, GL_TEXTURE_BASE_LEVEL, baseLevel);
+		glTexParameteri(mTextureTarget, GL_TEXTURE_MAX_LEVEL, maxLevel);
+		if (maxLevel > 0) {
+			glTexParameteri(mTextureTarget, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(mTextureTarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		}
+	}
+
+
+	void Texture::bind(GLuint unit) const
+	{
+		if (mPlaceholder) {
+			mPlaceholder->bind(unit);
+		}
+		else {
+			GLStateCache::bindTexture(unit, mTextureTarget, mTextureID);
+		}
 	}
 
 
-	void Texture::unbind() const
+	void Texture::unbind(GLuint unit) const
 	{
-		glBindTexture(mTextureTarget, 0);
+		GLStateCache::bindTexture(unit, mTextureTarget, 0);
 	}
 
 }
@@ -2,16 +2,25 @@
 #define TEXTURE_H
 
 #include <string>
+#include <memory>
+#include <cstddef>
 #include <GL/glew.h>
 
 namespace graphics {
 
 	/**
 	 * Texture Class
+	 * <br>The Textures can also be created without pixels and filled
+	 * later by mip levels and rows, compressed or not, like the ones
+	 * streamed by the AsyncTextureLoader. Meanwhile they bind a
+	 * placeholder Texture instead of themselves
 	 */
 	class Texture
 	{
 	private:	// Attributes
+		/** The unique identifier of the Texture */
+		const unsigned int mID;
+
 		/** The path to the vertex shader file */
 		const std::string mTexturePath;
 
@@ -21,6 +30,17 @@ namespace graphics {
 		/** The target to which the texture is bound */
 		const GLuint mTextureTarget;
 
+		/** The size of the Texture in pixels, zero if it doesn't have
+		 * pixels yet */
+		GLsizei mWidth, mHeight;
+
+		/** The size in bytes of all the allocated mip levels */
+		std::size_t mGPUSize;
+
+		/** The Texture that is bound instead of this one until its pixels
+		 * are loaded, nullptr if it's already loaded */
+		std::shared_ptr<Texture> mPlaceholder;
+
 	public:		// Functions
 		/** Creates a new Texture
 		 * 
@@ -28,17 +48,113 @@ namespace graphics {
 		 * @param	textureTarget the target to which the Texture is bound */
 		Texture(const std::string& texturePath, GLuint textureTarget);
 
+		/** Creates a new Texture from the given pixels
+		 *
+		 * @param	name the name of the Texture, returned as its path
+		 * @param	textureTarget the target to which the Texture is bound
+		 * @param	pixels a pointer to the pixels of the Texture in BGRA
+		 *			format with 8 bits per channel, from the bottom row to
+		 *			the top one
+		 * @param	width the width of the Texture in pixels
+		 * @param	height the height of the Texture in pixels */
+		Texture(
+			const std::string& name, GLuint textureTarget,
+			const GLubyte* pixels, GLsizei width, GLsizei height
+		);
+
+		/** Creates a new Texture without pixels, they must be set with
+		 * allocate, setRows and setLevelRange
+		 *
+		 * @param	name the name of the Texture, returned as its path
+		 * @param	textureTarget the target to which the Texture is bound
+		 * @param	placeholder the Texture that will be bound instead of
+		 *			this one until setPlaceholder is called with nullptr */
+		Texture(
+			const std::string& name, GLuint textureTarget,
+			std::shared_ptr<Texture> placeholder
+		);
+
 		/** Class destructor */
 		~Texture();
 
+		/** @return	the unique identifier of the Texture */
+		inline unsigned int getID() const { return mID; };
+
 		/** @return	the path of the Texture */
-		inline std::string getTexturePath() const { return mTexturePath; };
+		inline const std::string& getTexturePath() const { return mTexturePath; };
+
+		/** @return	the width of the Texture in pixels */
+		inline GLsizei getWidth() const { return mWidth; };
+
+		/** @return	the height of the Texture in pixels */
+		inline GLsizei getHeight() const { return mHeight; };
+
+		/** @return	the size in bytes of the pixels of the Texture in the
+		 *			GPU */
+		inline std::size_t getGPUSize() const { return mGPUSize; };
+
+		/** @return	true if the Texture doesn't use a placeholder, false
+		 *			otherwise */
+		inline bool isLoaded() const { return !mPlaceholder; };
+
+		/** Sets the Texture that is bound instead of this one
+		 *
+		 * @param	placeholder the new placeholder, nullptr for binding
+		 *			this Texture */
+		inline void setPlaceholder(std::shared_ptr<Texture> placeholder)
+		{ mPlaceholder = std::move(placeholder); };
+
+		/** Allocates the storage of a mip level of the Texture, with
+		 * undefined content
+		 *
+		 * @param	level the mip level, 0 is the biggest one
+		 * @param	internalFormat GL_RGBA for BGRA pixels with 8 bits per
+		 *			channel, or a compressed internal format
+		 * @param	width the width of the level in pixels
+		 * @param	height the height of the level in pixels
+		 * @param	imageSize the size in bytes of the level if it's
+		 *			compressed, it's ignored otherwise */
+		void allocate(
+			GLint level, GLenum internalFormat,
+			GLsizei width, GLsizei height, GLsizei imageSize = 0
+		);
+
+		/** Replaces some rows of a mip level of the Texture
+		 *
+		 * @param	level the mip level, 0 is the biggest one
+		 * @param	internalFormat the internal format used in allocate
+		 * @param	firstRow the first row to replace, counting from the
+		 *			bottom one. If the level is compressed it must be a
+		 *			multiple of the height of the blocks
+		 * @param	width the width of the level in pixels
+		 * @param	numRows the number of rows to replace
+		 * @param	imageSize the size in bytes of the rows if the level is
+		 *			compressed, it's ignored otherwise
+		 * @param	pixels a pointer to the new pixels, or an offset into
+		 *			the bound GL_PIXEL_UNPACK_BUFFER */
+		void setRows(
+			GLint level, GLenum internalFormat,
+			GLint firstRow, GLsizei width, GLsizei numRows,
+			GLsizei imageSize, const GLvoid* pixels
+		);
+
+		/** Sets the range of mip levels that can be sampled, they must
+		 * have been uploaded. The Textures with more than one level are
+		 * filtered trilinearly
+		 *
+		 * @param	baseLevel the biggest level that can be sampled
+		 * @param	maxLevel the smallest level that can be sampled */
+		void setLevelRange(GLint baseLevel, GLint maxLevel);
 
-		/** Binds the Texture */
-		void bind() const;
+		/** Binds the Texture
+		 *
+		 * @param	unit the texture unit where the Texture will be bound */
+		void bind(GLuint unit = 0) const;
 
-		/** Unbinds the Texture */
-		void unbind() const;
+		/** Unbinds the Texture
+		 *
+		 * @param	unit the texture unit where the Texture is bound */
+		void unbind(GLuint unit = 0) const;
 	};
 
 }
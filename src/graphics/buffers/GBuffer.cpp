@@ -1,42 +1,58 @@
 #include "GBuffer.h"
+#include <string>
+#include <stdexcept>
+#include "../GLStateCache.h"
 
 namespace graphics {
 
-	GBuffer::GBuffer(GLuint width, GLuint height)
+	GBuffer::GBuffer(GLuint width, GLuint height) :
+		mWidth(width), mHeight(height)
 	{
 		// Create the FBO
 		glGenFramebuffers(1, &mFrameBufferID);
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFrameBufferID);
+		GLStateCache::bindFramebuffer(GL_DRAW_FRAMEBUFFER, mFrameBufferID);
 
 		// Create the GBuffer textures
 		glGenTextures(GBUFFER_NUM_TEXTURES, mTextureIDs);
 		for (unsigned int i = 0; i < GBUFFER_NUM_TEXTURES; ++i) {
-			glBindTexture(GL_TEXTURE_2D, mTextureIDs[i]);
+			GLStateCache::bindTexture(0, GL_TEXTURE_2D, mTextureIDs[i]);
 			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, nullptr);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, mTextureIDs[i], 0);
 		}
 
 		glGenTextures(1, &mDepthTextureID);
-		glBindTexture(GL_TEXTURE_2D, mDepthTextureID);
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, mDepthTextureID);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, width, height, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mDepthTextureID, 0);
 
 		GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
 		glDrawBuffers(4, drawBuffers);
 
-		GLenum Status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+		GLStateCache::bindTexture(0, GL_TEXTURE_2D, 0);
 
-		if (Status != GL_FRAMEBUFFER_COMPLETE) {
-			throw ("FB error, status: 0x%x\n", Status);
-		}
+		GLenum Status = glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER);
 
 		// restore default FBO
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		GLStateCache::bindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+
+		if (Status != GL_FRAMEBUFFER_COMPLETE) {
+			throw std::runtime_error("FB error, status: " + std::to_string(Status));
+		}
 	}
 
 
 	GBuffer::~GBuffer()
 	{
+		GLStateCache::removeTexture(mDepthTextureID);
+		for (GLuint textureID : mTextureIDs) {
+			GLStateCache::removeTexture(textureID);
+		}
+		GLStateCache::removeFramebuffer(mFrameBufferID);
+
 		glDeleteTextures(1, &mDepthTextureID);
 		glDeleteTextures(GBUFFER_NUM_TEXTURES, mTextureIDs);
 		glDeleteFramebuffers(1, &mFrameBufferID);
@@ -45,13 +61,31 @@ namespace graphics {
 
 	void GBuffer::bindForReading() const
 	{
-		glBindFramebuffer(GL_READ_FRAMEBUFFER, mFrameBufferID);
+		GLStateCache::bindFramebuffer(GL_READ_FRAMEBUFFER, mFrameBufferID);
 	}
 
 
 	void GBuffer::bindForWriting() const
 	{
-		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mFrameBufferID);
+		GLStateCache::bindFramebuffer(GL_DRAW_FRAMEBUFFER, mFrameBufferID);
+	}
+
+
+	void GBuffer::unbind() const
+	{
+		GLStateCache::bindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+
+	void GBuffer::bindTexture(GBUFFER_TEXTURE_TYPE textureType, GLuint unit) const
+	{
+		GLStateCache::bindTexture(unit, GL_TEXTURE_2D, mTextureIDs[textureType]);
+	}
+
+
+	void GBuffer::bindDepthTexture(GLuint unit) const
+	{
+		GLStateCache::bindTexture(unit, GL_TEXTURE_2D, mDepthTextureID);
 	}
 
 
@@ -27,11 +27,16 @@ namespace graphics {
 		/** The ID of the depth	render buffer */
 		GLuint mTextureIDs[GBUFFER_NUM_TEXTURES];
 
+		/** The size of the textures of the GBuffer */
+		GLuint mWidth, mHeight;
+
 	public:		// Functions
 		/** Creates a new GBuffer
 		 * 
 		 * @param	width the width of the texture of the GBuffer
-		 * @param	height the height of the texture of the GBuffer */
+		 * @param	height the height of the texture of the GBuffer
+		 * @throw	std::runtime_error if the Frame Buffer Object couldn't
+		 *			be completed */
 		GBuffer(GLuint width, GLuint height);
 
 		/** Class destructor */
@@ -43,6 +48,28 @@ namespace graphics {
 		/** Binds the Frame Buffer Object */
 		void bindForWriting() const;
 
+		/** Binds the default Frame Buffer Object */
+		void unbind() const;
+
+		/** @return	the width of the textures of the GBuffer */
+		inline GLuint getWidth() const { return mWidth; };
+
+		/** @return	the height of the textures of the GBuffer */
+		inline GLuint getHeight() const { return mHeight; };
+
+		/** Binds the given texture of the GBuffer to the given texture unit
+		 * so it can be read from the shaders
+		 *
+		 * @param	textureType the type of the texture to bind
+		 * @param	unit the index of the texture unit */
+		void bindTexture(GBUFFER_TEXTURE_TYPE textureType, GLuint unit) const;
+
+		/** Binds the depth texture of the GBuffer to the given texture unit
+		 * so it can be read from the shaders
+		 *
+		 * @param	unit the index of the texture unit */
+		void bindDepthTexture(GLuint unit) const;
+
 		/** Sets the texture of the frame buffer from which we are going to
 		 * read from
 		 * 
@@ -1,4 +1,5 @@
 #include "IndexBuffer.h"
+#include "../GLStateCache.h"
 
 namespace graphics {
 
@@ -7,6 +8,9 @@ namespace graphics {
 	{
 		glGenBuffers(1, &mBufferID);
 
+		// The GL_ELEMENT_ARRAY_BUFFER binding is stored in the bound VAO,
+		// so we must unbind it first for not modifying it
+		GLStateCache::bindVertexArray(0);
 		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mBufferID);
 		glBufferData(
 			GL_ELEMENT_ARRAY_BUFFER,
@@ -20,6 +24,7 @@ namespace graphics {
 
 	IndexBuffer::~IndexBuffer()
 	{
+		GLStateCache::removeBuffer(mBufferID);
 		glDeleteBuffers(1, &mBufferID);
 	}
 
@@ -0,0 +1,40 @@
+#include "IndirectBuffer.h"
+#include "../GLStateCache.h"
+
+namespace graphics {
+
+	IndirectBuffer::IndirectBuffer() : mSize(0)
+	{
+		glGenBuffers(1, &mBufferID);
+	}
+
+
+	IndirectBuffer::~IndirectBuffer()
+	{
+		GLStateCache::removeBuffer(mBufferID);
+		glDeleteBuffers(1, &mBufferID);
+	}
+
+
+	void IndirectBuffer::setData(const GLvoid* data, GLuint size)
+	{
+		mSize = size;
+
+		GLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, mBufferID);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, mSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, mSize, data);
+	}
+
+
+	void IndirectBuffer::bind() const
+	{
+		GLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, mBufferID);
+	}
+
+
+	void IndirectBuffer::unbind() const
+	{
+		GLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+}
@@ -0,0 +1,51 @@
+#ifndef INDIRECT_BUFFER_H
+#define INDIRECT_BUFFER_H
+
+#include <GL/glew.h>
+
+namespace graphics {
+
+	/**
+	 * Class IndirectBuffer, it's used for creating, binding and unbinding a
+	 * Draw Indirect Buffer.
+	 * <br>A Draw Indirect Buffer is a buffer that holds the parameters of
+	 * draw calls, so multiple draws can be issued with a single multi draw
+	 * indirect call
+	 */
+	class IndirectBuffer
+	{
+	private:	// Attributes
+		/** The ID of the indirect buffer */
+		GLuint mBufferID;
+
+		/** The size in bytes of the buffer */
+		GLuint mSize;
+
+	public:		// Functions
+		/** Creates a new empty IndirectBuffer */
+		IndirectBuffer();
+
+		/** Class destructor */
+		~IndirectBuffer();
+
+		/** @return	the size in bytes of the buffer */
+		inline GLuint getSize() const { return mSize; };
+
+		/** Replaces all the data of the IndirectBuffer with the given one.
+		 * The old data is orphaned so the update doesn't have to wait for
+		 * the draws that are still using it
+		 *
+		 * @param	data a pointer to the new data of the buffer
+		 * @param	size the size in bytes of the new data */
+		void setData(const GLvoid* data, GLuint size);
+
+		/** Binds the Draw Indirect Buffer */
+		void bind() const;
+
+		/** Unbinds the Draw Indirect Buffer */
+		void unbind() const;
+	};
+
+}
+
+#endif		// INDIRECT_BUFFER_H
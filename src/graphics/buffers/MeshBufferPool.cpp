@@ -0,0 +1,289 @@
+#include "MeshBufferPool.h"
+#include <cstdint>
+#include <algorithm>
+#include "../GLStateCache.h"
+
+namespace graphics {
+
+	MeshBufferPool::MeshBufferPool(
+		const VertexFormat& format,
+		GLuint vertexCapacity, GLuint indexCapacity
+	) : mFormat(format),
+		mVertexAllocator(vertexCapacity), mIndexAllocator(indexCapacity)
+	{
+		glGenVertexArrays(1, &mArrayID);
+
+		// The instance attribute values are their own indices, the base
+		// instance of the draw calls is added to them by the GL
+		std::vector<GLuint> instances(MAX_INSTANCES);
+		for (GLuint i = 0; i < MAX_INSTANCES; ++i) {
+			instances[i] = i;
+		}
+
+		glGenBuffers(1, &mInstanceBufferID);
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, mInstanceBufferID);
+		glBufferData(GL_ARRAY_BUFFER, MAX_INSTANCES * sizeof(GLuint), instances.data(), GL_STATIC_DRAW);
+
+		// Create the vertex and index buffers
+		mVertexBufferID = createBuffer(vertexCapacity * mFormat.mStride);
+		mIndexBufferID = createBuffer(indexCapacity * sizeof(GLushort));
+
+		setupVertexArray();
+	}
+
+
+	MeshBufferPool::~MeshBufferPool()
+	{
+		deleteBuffer(mVertexBufferID);
+		deleteBuffer(mIndexBufferID);
+		deleteBuffer(mInstanceBufferID);
+
+		GLStateCache::removeVertexArray(mArrayID);
+		glDeleteVertexArrays(1, &mArrayID);
+	}
+
+
+	unsigned int MeshBufferPool::addMesh(
+		const GLvoid* vertices, GLuint numVertices,
+		const GLushort* indices, GLuint indexCount
+	) {
+		Range range;
+		if (!allocate(numVertices, indexCount, range)) {
+			// Compact the data if the free space is enough but it's split
+			// in multiple ranges, move it to bigger buffers otherwise
+			GLuint vertexCapacity	= mVertexAllocator.getSize();
+			GLuint indexCapacity	= mIndexAllocator.getSize();
+			bool verticesFit		= (vertexCapacity - mVertexAllocator.getUsedSize() >= numVertices);
+			bool indicesFit			= (indexCapacity - mIndexAllocator.getUsedSize() >= indexCount);
+
+			if (verticesFit && indicesFit) {
+				defragment();
+			}
+			else {
+				grow(
+					verticesFit? vertexCapacity : std::max(2 * vertexCapacity, vertexCapacity + numVertices),
+					indicesFit? indexCapacity : std::max(2 * indexCapacity, indexCapacity + indexCount)
+				);
+			}
+
+			if (!allocate(numVertices, indexCount, range)) {
+				defragment();
+				allocate(numVertices, indexCount, range);
+			}
+		}
+
+		// The copy write target isn't stored in the VAOs nor in the
+		// GLStateCache, so it can be used for uploading any buffer
+		glBindBuffer(GL_COPY_WRITE_BUFFER, mVertexBufferID);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, range.mBaseVertex * mFormat.mStride, numVertices * mFormat.mStride, vertices);
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, mIndexBufferID);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, range.mFirstIndex * sizeof(GLushort), indexCount * sizeof(GLushort), indices);
+
+		// Store the Range with a free ID if there is any
+		unsigned int rangeID;
+		if (!mFreeRangeIDs.empty()) {
+			rangeID = mFreeRangeIDs.back();
+			mFreeRangeIDs.pop_back();
+			mRanges[rangeID] = range;
+		}
+		else {
+			rangeID = mRanges.size();
+			mRanges.push_back(range);
+		}
+
+		return rangeID;
+	}
+
+
+	void MeshBufferPool::removeMesh(unsigned int rangeID)
+	{
+		Range& range = mRanges[rangeID];
+		mVertexAllocator.release(range.mBaseVertex, range.mNumVertices);
+		mIndexAllocator.release(range.mFirstIndex, range.mIndexCount);
+
+		range = { 0, 0, 0, 0 };
+		mFreeRangeIDs.push_back(rangeID);
+	}
+
+
+	void MeshBufferPool::defragment()
+	{
+		std::vector<Range*> usedRanges;
+		for (Range& range : mRanges) {
+			if ((range.mNumVertices > 0) || (range.mIndexCount > 0)) {
+				usedRanges.push_back(&range);
+			}
+		}
+
+		// Copy the vertices of each Mesh to a new buffer in order, the
+		// indices are relative to the base vertices so they don't change
+		std::sort(usedRanges.begin(), usedRanges.end(), [](const Range* r1, const Range* r2) {
+			return r1->mBaseVertex < r2->mBaseVertex;
+		});
+
+		GLuint vertexBufferID = createBuffer(mVertexAllocator.getSize() * mFormat.mStride);
+		glBindBuffer(GL_COPY_READ_BUFFER, mVertexBufferID);
+
+		GLuint numVertices = 0;
+		for (Range* range : usedRanges) {
+			if (range->mNumVertices > 0) {
+				glCopyBufferSubData(
+					GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+					range->mBaseVertex * mFormat.mStride, numVertices * mFormat.mStride,
+					range->mNumVertices * mFormat.mStride
+				);
+			}
+			range->mBaseVertex = numVertices;
+			numVertices += range->mNumVertices;
+		}
+		mVertexAllocator.reset(numVertices);
+
+		deleteBuffer(mVertexBufferID);
+		mVertexBufferID = vertexBufferID;
+
+		// Copy the indices of each Mesh to a new buffer in order
+		std::sort(usedRanges.begin(), usedRanges.end(), [](const Range* r1, const Range* r2) {
+			return r1->mFirstIndex < r2->mFirstIndex;
+		});
+
+		GLuint indexBufferID = createBuffer(mIndexAllocator.getSize() * sizeof(GLushort));
+		glBindBuffer(GL_COPY_READ_BUFFER, mIndexBufferID);
+
+		GLuint numIndices = 0;
+		for (Range* range : usedRanges) {
+			if (range->mIndexCount > 0) {
+				glCopyBufferSubData(
+					GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+					range->mFirstIndex * sizeof(GLushort), numIndices * sizeof(GLushort),
+					range->mIndexCount * sizeof(GLushort)
+				);
+			}
+			range->mFirstIndex = numIndices;
+			numIndices += range->mIndexCount;
+		}
+		mIndexAllocator.reset(numIndices);
+
+		deleteBuffer(mIndexBufferID);
+		mIndexBufferID = indexBufferID;
+
+		setupVertexArray();
+	}
+
+
+	MeshBufferPool::Statistics MeshBufferPool::getStatistics() const
+	{
+		return {
+			static_cast<unsigned int>(mRanges.size() - mFreeRangeIDs.size()),
+			mVertexAllocator.getSize(), mVertexAllocator.getUsedSize(),
+			mVertexAllocator.getNumFreeRanges(), mVertexAllocator.getLargestFreeRange(),
+			mIndexAllocator.getSize(), mIndexAllocator.getUsedSize(),
+			mIndexAllocator.getNumFreeRanges(), mIndexAllocator.getLargestFreeRange()
+		};
+	}
+
+
+	void MeshBufferPool::bind() const
+	{
+		GLStateCache::bindVertexArray(mArrayID);
+	}
+
+// Private functions
+	bool MeshBufferPool::allocate(GLuint numVertices, GLuint indexCount, Range& range)
+	{
+		GLuint baseVertex, firstIndex;
+		if (!mVertexAllocator.allocate(numVertices, baseVertex)) {
+			return false;
+		}
+		if (!mIndexAllocator.allocate(indexCount, firstIndex)) {
+			mVertexAllocator.release(baseVertex, numVertices);
+			return false;
+		}
+
+		range = { static_cast<GLint>(baseVertex), numVertices, firstIndex, indexCount };
+		return true;
+	}
+
+
+	void MeshBufferPool::grow(GLuint vertexCapacity, GLuint indexCapacity)
+	{
+		// Create the new buffers and copy all the data of the old ones
+		if (vertexCapacity > mVertexAllocator.getSize()) {
+			GLuint vertexBufferID = createBuffer(vertexCapacity * mFormat.mStride);
+
+			glBindBuffer(GL_COPY_READ_BUFFER, mVertexBufferID);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, mVertexAllocator.getSize() * mFormat.mStride);
+
+			deleteBuffer(mVertexBufferID);
+			mVertexBufferID = vertexBufferID;
+			mVertexAllocator.grow(vertexCapacity);
+		}
+
+		if (indexCapacity > mIndexAllocator.getSize()) {
+			GLuint indexBufferID = createBuffer(indexCapacity * sizeof(GLushort));
+
+			glBindBuffer(GL_COPY_READ_BUFFER, mIndexBufferID);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, mIndexAllocator.getSize() * sizeof(GLushort));
+
+			deleteBuffer(mIndexBufferID);
+			mIndexBufferID = indexBufferID;
+			mIndexAllocator.grow(indexCapacity);
+		}
+
+		setupVertexArray();
+	}
+
+
+	void MeshBufferPool::setupVertexArray()
+	{
+		bind();
+
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, mVertexBufferID);
+		for (const VertexFormat::Attribute& attribute : mFormat.mAttributes) {
+			const GLvoid* offset = reinterpret_cast<const GLvoid*>(static_cast<std::uintptr_t>(attribute.mOffset));
+
+			glEnableVertexAttribArray(attribute.mIndex);
+			if (attribute.mInteger) {
+				glVertexAttribIPointer(attribute.mIndex, attribute.mComponentSize, attribute.mType, mFormat.mStride, offset);
+			}
+			else {
+				glVertexAttribPointer(attribute.mIndex, attribute.mComponentSize, attribute.mType, attribute.mNormalized, mFormat.mStride, offset);
+			}
+		}
+
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, mInstanceBufferID);
+		glEnableVertexAttribArray(INSTANCE_ATTRIBUTE);
+		glVertexAttribIPointer(INSTANCE_ATTRIBUTE, 1, GL_UNSIGNED_INT, 0, 0);
+		glVertexAttribDivisor(INSTANCE_ATTRIBUTE, 1);
+
+		// The element array buffer binding is stored in the VAO
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBufferID);
+	}
+
+
+	GLuint MeshBufferPool::createBuffer(GLuint size)
+	{
+		GLuint bufferID;
+		glGenBuffers(1, &bufferID);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, bufferID);
+
+		// The immutable buffers can't be resized or orphaned, but their
+		// data can still be updated with glBufferSubData
+		if (GLEW_ARB_buffer_storage) {
+			glBufferStorage(GL_COPY_WRITE_BUFFER, std::max(size, 1u), nullptr, GL_DYNAMIC_STORAGE_BIT);
+		}
+		else {
+			glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STATIC_DRAW);
+		}
+
+		return bufferID;
+	}
+
+
+	void MeshBufferPool::deleteBuffer(GLuint bufferID)
+	{
+		GLStateCache::removeBuffer(bufferID);
+		glDeleteBuffers(1, &bufferID);
+	}
+
+}
@@ -0,0 +1,212 @@
+#ifndef MESH_BUFFER_POOL_H
+#define MESH_BUFFER_POOL_H
+
+#include <vector>
+#include <GL/glew.h>
+#include "VertexLayout.h"
+#include "../../utils/FreeListAllocator.h"
+
+namespace graphics {
+
+	/**
+	 * Class MeshBufferPool, it holds the vertices and indices of multiple
+	 * Meshes with the same vertex format in shared buffers, so all of them
+	 * can be drawn with the same Vertex Array Object.
+	 * <br>The vertices are interleaved in a single buffer with the layout
+	 * of a VertexFormat, and the indices of each Mesh are relative to its
+	 * base vertex, so they can still be stored as unsigned shorts. The
+	 * ranges of vertices and indices of the Meshes are suballocated with
+	 * FreeListAllocators, so the space of the removed Meshes can be
+	 * reused. When a Mesh doesn't fit, the
+	 * MeshBufferPool is defragmented if it has enough free space, or its
+	 * data is moved to bigger buffers otherwise. The buffers are immutable
+	 * if ARB_buffer_storage is supported.
+	 * <br>The VAO also has an instanced integer attribute at
+	 * INSTANCE_ATTRIBUTE with the index of each instance plus the base
+	 * instance of the draw call, so the shaders can locate the per object
+	 * data of the draws of a multi draw call
+	 */
+	class MeshBufferPool
+	{
+	public:		// Nested types
+		/** The index of the instance attribute */
+		static const GLuint INSTANCE_ATTRIBUTE = 5;
+
+		/** The number of values of the instance attribute, the instances
+		 * of a draw call plus its base instance can't exceed it */
+		static const GLuint MAX_INSTANCES = 1024;
+
+		/** Struct Range, it holds the location of the data of a Mesh
+		 * inside the MeshBufferPool */
+		struct Range
+		{
+			/** The index of the first vertex of the Mesh */
+			GLint mBaseVertex;
+
+			/** The number of vertices of the Mesh */
+			GLuint mNumVertices;
+
+			/** The index of the first index of the Mesh */
+			GLuint mFirstIndex;
+
+			/** The number of indices of the Mesh */
+			GLuint mIndexCount;
+		};
+
+		/** Struct Statistics, it holds the occupancy of the
+		 * MeshBufferPool */
+		struct Statistics
+		{
+			/** The number of Meshes stored */
+			unsigned int mNumMeshes;
+
+			/** The number of vertices that fit in the vertex buffers and
+			 * the number of them that are used */
+			unsigned int mVertexCapacity, mNumVertices;
+
+			/** The number of free ranges of vertices and the size of the
+			 * biggest one */
+			unsigned int mNumFreeVertexRanges, mLargestFreeVertexRange;
+
+			/** The number of indices that fit in the index buffer and the
+			 * number of them that are used */
+			unsigned int mIndexCapacity, mNumIndices;
+
+			/** The number of free ranges of indices and the size of the
+			 * biggest one */
+			unsigned int mNumFreeIndexRanges, mLargestFreeIndexRange;
+		};
+
+	private:	// Attributes
+		/** The format of the vertices of the Meshes */
+		VertexFormat mFormat;
+
+		/** The ID of the buffer with the vertices */
+		GLuint mVertexBufferID;
+
+		/** The ID of the buffer with the indices */
+		GLuint mIndexBufferID;
+
+		/** The ID of the buffer with the values of the instance attribute */
+		GLuint mInstanceBufferID;
+
+		/** The ID of the Vertex Array Object */
+		GLuint mArrayID;
+
+		/** The allocator of the ranges of vertices */
+		FreeListAllocator mVertexAllocator;
+
+		/** The allocator of the ranges of indices */
+		FreeListAllocator mIndexAllocator;
+
+		/** The Ranges of the Meshes, indexed by their range IDs */
+		std::vector<Range> mRanges;
+
+		/** The IDs of mRanges that aren't used by any Mesh */
+		std::vector<unsigned int> mFreeRangeIDs;
+
+	public:		// Functions
+		/** Creates a new MeshBufferPool
+		 *
+		 * @param	format the format of the interleaved vertices
+		 * @param	vertexCapacity the initial number of vertices that can
+		 *			be stored
+		 * @param	indexCapacity the initial number of indices that can
+		 *			be stored */
+		MeshBufferPool(
+			const VertexFormat& format,
+			GLuint vertexCapacity, GLuint indexCapacity
+		);
+
+		/** Class destructor */
+		~MeshBufferPool();
+
+		/** @return	the format of the vertices of the Meshes */
+		inline const VertexFormat& getFormat() const { return mFormat; };
+
+		/** Adds the data of a Mesh to the MeshBufferPool, defragmenting
+		 * or growing the buffers if there isn't a free range big enough
+		 *
+		 * @param	vertices a pointer to the interleaved vertices, with the
+		 *			VertexFormat of the MeshBufferPool
+		 * @param	numVertices the number of vertices of the Mesh
+		 * @param	indices a pointer to the indices of the faces of the
+		 *			Mesh
+		 * @param	indexCount the number of indices of the Mesh
+		 * @return	the ID of the Range of the Mesh */
+		unsigned int addMesh(
+			const GLvoid* vertices, GLuint numVertices,
+			const GLushort* indices, GLuint indexCount
+		);
+
+		/** Adds a range of indices without vertices to the
+		 * MeshBufferPool, used for the LODs of the Meshes, whose indices
+		 * are relative to the base vertex of another Range
+		 *
+		 * @param	indices a pointer to the indices
+		 * @param	indexCount the number of indices
+		 * @return	the ID of the Range of the indices */
+		inline unsigned int addIndices(const GLushort* indices, GLuint indexCount)
+		{ return addMesh(nullptr, 0, indices, indexCount); };
+
+		/** Removes the data of a Mesh from the MeshBufferPool, so its
+		 * space can be reused
+		 *
+		 * @param	rangeID the ID of the Range of the Mesh */
+		void removeMesh(unsigned int rangeID);
+
+		/** Returns the location of the data of a Mesh, it can change
+		 * when the MeshBufferPool is defragmented
+		 *
+		 * @param	rangeID the ID of the Range of the Mesh
+		 * @return	the Range of the Mesh */
+		inline const Range& getRange(unsigned int rangeID) const
+		{ return mRanges[rangeID]; };
+
+		/** Moves the data of all the Meshes to the start of the buffers,
+		 * so all the free space becomes a single range */
+		void defragment();
+
+		/** @return	the occupancy of the MeshBufferPool */
+		Statistics getStatistics() const;
+
+		/** Binds the Vertex Array Object of the MeshBufferPool */
+		void bind() const;
+	private:
+		/** Allocates the ranges of vertices and indices of a Mesh
+		 *
+		 * @param	numVertices the number of vertices of the Mesh
+		 * @param	indexCount the number of indices of the Mesh
+		 * @param	range where the location of the Mesh data will be
+		 *			stored
+		 * @return	true if both ranges were allocated, false otherwise */
+		bool allocate(GLuint numVertices, GLuint indexCount, Range& range);
+
+		/** Moves the data of the MeshBufferPool to new buffers with the
+		 * given capacities
+		 *
+		 * @param	vertexCapacity the new number of vertices that can be
+		 *			stored
+		 * @param	indexCapacity the new number of indices that can be
+		 *			stored */
+		void grow(GLuint vertexCapacity, GLuint indexCapacity);
+
+		/** Points the attributes of the VAO to the current buffers */
+		void setupVertexArray();
+
+		/** Creates a new buffer with uninitialized data, leaving it bound
+		 * to GL_COPY_WRITE_BUFFER
+		 *
+		 * @param	size the size in bytes of the buffer
+		 * @return	the ID of the new buffer */
+		static GLuint createBuffer(GLuint size);
+
+		/** Deletes the given buffer
+		 *
+		 * @param	bufferID the ID of the buffer */
+		static void deleteBuffer(GLuint bufferID);
+	};
+
+}
+
+#endif		// MESH_BUFFER_POOL_H
@@ -0,0 +1,49 @@
+#include "PixelBuffer.h"
+#include "../GLStateCache.h"
+
+namespace graphics {
+
+	PixelBuffer::PixelBuffer(GLuint size) : mSize(size)
+	{
+		glGenBuffers(1, &mBufferID);
+		GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, mBufferID);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, mSize, nullptr, GL_STREAM_DRAW);
+		GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+
+	PixelBuffer::~PixelBuffer()
+	{
+		GLStateCache::removeBuffer(mBufferID);
+		glDeleteBuffers(1, &mBufferID);
+	}
+
+
+	GLubyte* PixelBuffer::map()
+	{
+		GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, mBufferID);
+		return static_cast<GLubyte*>(glMapBufferRange(
+			GL_PIXEL_UNPACK_BUFFER, 0, mSize,
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT
+		));
+	}
+
+
+	void PixelBuffer::unmap()
+	{
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+
+
+	void PixelBuffer::bind() const
+	{
+		GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, mBufferID);
+	}
+
+
+	void PixelBuffer::unbind() const
+	{
+		GLStateCache::bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+}
@@ -0,0 +1,57 @@
+#ifndef PIXEL_BUFFER_H
+#define PIXEL_BUFFER_H
+
+#include <GL/glew.h>
+
+namespace graphics {
+
+	/**
+	 * Class PixelBuffer, it's used for creating, mapping, binding and
+	 * unbinding a Pixel Unpack Buffer.
+	 * <br>A Pixel Unpack Buffer holds pixels that are going to be copied
+	 * to a Texture, so the copy is done by the GPU asynchronously instead
+	 * of reading them from the client memory during the GL call
+	 */
+	class PixelBuffer
+	{
+	private:	// Attributes
+		/** The ID of the pixel buffer */
+		GLuint mBufferID;
+
+		/** The size in bytes of the buffer */
+		GLuint mSize;
+
+	public:		// Functions
+		/** Creates a new PixelBuffer
+		 *
+		 * @param	size the size in bytes of the buffer */
+		PixelBuffer(GLuint size);
+
+		/** Class destructor */
+		~PixelBuffer();
+
+		/** @return	the size in bytes of the buffer */
+		inline GLuint getSize() const { return mSize; };
+
+		/** Binds the PixelBuffer and maps all of it for writing. The old
+		 * data is invalidated so the mapping doesn't have to wait for the
+		 * copies that are still reading it
+		 *
+		 * @return	a pointer to the mapped memory, nullptr if it couldn't
+		 *			be mapped */
+		GLubyte* map();
+
+		/** Unmaps the PixelBuffer, it must be bound */
+		void unmap();
+
+		/** Binds the Pixel Unpack Buffer */
+		void bind() const;
+
+		/** Unbinds the Pixel Unpack Buffer, so the pixels of the other
+		 * Texture calls are read again from the client memory */
+		void unbind() const;
+	};
+
+}
+
+#endif		// PIXEL_BUFFER_H
@@ -0,0 +1,48 @@
+#include "TextureBuffer.h"
+#include "../GLStateCache.h"
+
+namespace graphics {
+
+	TextureBuffer::TextureBuffer(GLenum internalFormat) : mSize(0)
+	{
+		glGenBuffers(1, &mBufferID);
+		GLStateCache::bindBuffer(GL_TEXTURE_BUFFER, mBufferID);
+		glBufferData(GL_TEXTURE_BUFFER, mSize, nullptr, GL_STREAM_DRAW);
+
+		glGenTextures(1, &mTextureID);
+		GLStateCache::bindTexture(0, GL_TEXTURE_BUFFER, mTextureID);
+		glTexBuffer(GL_TEXTURE_BUFFER, internalFormat, mBufferID);
+	}
+
+
+	TextureBuffer::~TextureBuffer()
+	{
+		GLStateCache::removeTexture(mTextureID);
+		GLStateCache::removeBuffer(mBufferID);
+		glDeleteTextures(1, &mTextureID);
+		glDeleteBuffers(1, &mBufferID);
+	}
+
+
+	void TextureBuffer::setData(const GLvoid* data, GLuint size)
+	{
+		mSize = size;
+
+		GLStateCache::bindBuffer(GL_TEXTURE_BUFFER, mBufferID);
+		glBufferData(GL_TEXTURE_BUFFER, mSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, mSize, data);
+	}
+
+
+	void TextureBuffer::bind(GLuint unit) const
+	{
+		GLStateCache::bindTexture(unit, GL_TEXTURE_BUFFER, mTextureID);
+	}
+
+
+	void TextureBuffer::unbind(GLuint unit) const
+	{
+		GLStateCache::bindTexture(unit, GL_TEXTURE_BUFFER, 0);
+	}
+
+}
@@ -0,0 +1,62 @@
+#ifndef TEXTURE_BUFFER_H
+#define TEXTURE_BUFFER_H
+
+#include <GL/glew.h>
+
+namespace graphics {
+
+	/**
+	 * Class TextureBuffer, it's used for creating, binding and unbinding a
+	 * Buffer Texture.
+	 * <br>A Buffer Texture is a one dimensional texture whose texels are
+	 * stored in a buffer object, so the shaders can read large arrays of
+	 * data with texelFetch that don't fit in an uniform block
+	 */
+	class TextureBuffer
+	{
+	private:	// Attributes
+		/** The ID of the buffer that holds the texels */
+		GLuint mBufferID;
+
+		/** The ID of the texture */
+		GLuint mTextureID;
+
+		/** The size in bytes of the buffer */
+		GLuint mSize;
+
+	public:		// Functions
+		/** Creates a new TextureBuffer
+		 *
+		 * @param	internalFormat the sized internal format of the texels
+		 *			of the buffer (GL_R16UI, GL_RG32UI...) */
+		TextureBuffer(GLenum internalFormat);
+
+		/** Class destructor */
+		~TextureBuffer();
+
+		/** @return	the size in bytes of the buffer */
+		inline GLuint getSize() const { return mSize; };
+
+		/** Replaces all the data of the TextureBuffer with the given one.
+		 * The old data is orphaned so the update doesn't have to wait for
+		 * the draws that are still using it
+		 *
+		 * @param	data a pointer to the new data of the buffer
+		 * @param	size the size in bytes of the new data */
+		void setData(const GLvoid* data, GLuint size);
+
+		/** Binds the texture of the TextureBuffer to the given texture unit
+		 *
+		 * @param	unit the index of the texture unit */
+		void bind(GLuint unit) const;
+
+		/** Unbinds the texture of the TextureBuffer from the given texture
+		 * unit
+		 *
+		 * @param	unit the index of the texture unit */
+		void unbind(GLuint unit) const;
+	};
+
+}
+
+#endif		// TEXTURE_BUFFER_H
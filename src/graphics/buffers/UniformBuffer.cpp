@@ -0,0 +1,83 @@
+#include "UniformBuffer.h"
+#include "../GLStateCache.h"
+
+namespace graphics {
+
+	UniformBuffer::UniformBuffer(const GLvoid* data, GLuint size) :
+		mSize(size)
+	{
+		glGenBuffers(1, &mBufferID);
+
+		GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, mBufferID);
+		glBufferData(GL_UNIFORM_BUFFER, mSize, data, GL_STREAM_DRAW);
+	}
+
+
+	UniformBuffer::~UniformBuffer()
+	{
+		GLStateCache::removeBuffer(mBufferID);
+		glDeleteBuffers(1, &mBufferID);
+	}
+
+
+	void UniformBuffer::setData(const GLvoid* data, GLuint size)
+	{
+		mSize = size;
+
+		GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, mBufferID);
+		glBufferData(GL_UNIFORM_BUFFER, mSize, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, mSize, data);
+	}
+
+
+	void UniformBuffer::resize(GLuint size)
+	{
+		mSize = size;
+
+		GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, mBufferID);
+		glBufferData(GL_UNIFORM_BUFFER, mSize, nullptr, GL_STREAM_DRAW);
+	}
+
+
+	void UniformBuffer::setSubData(const GLvoid* data, GLuint offset, GLuint size)
+	{
+		GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, mBufferID);
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+	}
+
+
+	void UniformBuffer::bind() const
+	{
+		GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, mBufferID);
+	}
+
+
+	void UniformBuffer::unbind() const
+	{
+		GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+
+	void UniformBuffer::bindBase(GLuint bindingPoint) const
+	{
+		GLStateCache::bindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, mBufferID);
+	}
+
+
+	void UniformBuffer::bindRange(GLuint bindingPoint, GLuint offset, GLuint size) const
+	{
+		GLStateCache::bindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, mBufferID, offset, size);
+	}
+
+
+	GLuint UniformBuffer::getOffsetAlignment()
+	{
+		static GLint sAlignment = 0;
+		if (sAlignment == 0) {
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &sAlignment);
+		}
+
+		return sAlignment;
+	}
+
+}
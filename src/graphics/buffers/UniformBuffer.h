@@ -0,0 +1,89 @@
+#ifndef UNIFORM_BUFFER_H
+#define UNIFORM_BUFFER_H
+
+#include <GL/glew.h>
+
+namespace graphics {
+
+	/**
+	 * Class UniformBuffer, it's used for creating, binding and unbinding an
+	 * Uniform Buffer Object.
+	 * <br>An Uniform Buffer Object is a buffer that holds the data of the
+	 * uniform blocks of the shaders, so it can be shared between programs
+	 * and updated with a single call
+	 */
+	class UniformBuffer
+	{
+	private:	// Attributes
+		/** The ID of the uniform buffer */
+		GLuint mBufferID;
+
+		/** The size in bytes of the buffer */
+		GLuint mSize;
+
+	public:		// Functions
+		/** Creates a new UniformBuffer
+		 *
+		 * @param	data a pointer to the initial data of the buffer, it can
+		 *			be nullptr
+		 * @param	size the size in bytes of the data */
+		UniformBuffer(const GLvoid* data, GLuint size);
+
+		/** Class destructor */
+		~UniformBuffer();
+
+		/** @return	the size in bytes of the buffer */
+		inline GLuint getSize() const { return mSize; };
+
+		/** Replaces all the data of the UniformBuffer with the given one.
+		 * The old data is orphaned so the update doesn't have to wait for
+		 * the draws that are still using it
+		 *
+		 * @param	data a pointer to the new data of the buffer
+		 * @param	size the size in bytes of the new data */
+		void setData(const GLvoid* data, GLuint size);
+
+		/** Orphans the data of the UniformBuffer and allocates new storage
+		 * for it with the given size. The contents of the new storage are
+		 * undefined
+		 *
+		 * @param	size the new size in bytes of the buffer */
+		void resize(GLuint size);
+
+		/** Replaces a part of the data of the UniformBuffer with the given
+		 * one
+		 *
+		 * @param	data a pointer to the new data
+		 * @param	offset the offset in bytes where the new data starts
+		 * @param	size the size in bytes of the new data */
+		void setSubData(const GLvoid* data, GLuint offset, GLuint size);
+
+		/** Binds the Uniform Buffer Object */
+		void bind() const;
+
+		/** Unbinds the Uniform Buffer Object */
+		void unbind() const;
+
+		/** Binds the whole Uniform Buffer Object to the given uniform block
+		 * binding point
+		 *
+		 * @param	bindingPoint the index of the binding point */
+		void bindBase(GLuint bindingPoint) const;
+
+		/** Binds a range of the Uniform Buffer Object to the given uniform
+		 * block binding point
+		 *
+		 * @param	bindingPoint the index of the binding point
+		 * @param	offset the offset in bytes of the range, it must be a
+		 *			multiple of getOffsetAlignment()
+		 * @param	size the size in bytes of the range */
+		void bindRange(GLuint bindingPoint, GLuint offset, GLuint size) const;
+
+		/** @return	the alignment in bytes that the offsets of the ranges
+		 *			must have */
+		static GLuint getOffsetAlignment();
+	};
+
+}
+
+#endif		// UNIFORM_BUFFER_H
@@ -1,5 +1,6 @@
 #include "VertexArray.h"
 #include "VertexBuffer.h"
+#include "../GLStateCache.h"
 
 namespace graphics {
 
@@ -11,6 +12,7 @@ namespace graphics {
 
 	VertexArray::~VertexArray()
 	{
+		GLStateCache::removeVertexArray(mArrayID);
 		glDeleteVertexArrays(1, &mArrayID);
 	}
 
@@ -21,7 +23,14 @@ namespace graphics {
 			
 		vertexBuffer->bind();
 		glEnableVertexAttribArray(index);
-		glVertexAttribPointer(index, vertexBuffer->getComponentSize(), GL_FLOAT, GL_FALSE, 0, 0);
+
+		// The unsigned short buffers hold integer data like joint indices
+		if (vertexBuffer->getComponentType() == GL_FLOAT) {
+			glVertexAttribPointer(index, vertexBuffer->getComponentSize(), GL_FLOAT, GL_FALSE, 0, 0);
+		}
+		else {
+			glVertexAttribIPointer(index, vertexBuffer->getComponentSize(), vertexBuffer->getComponentType(), 0, 0);
+		}
 
 		unbind();
 	}
@@ -29,13 +38,13 @@ namespace graphics {
 
 	void VertexArray::bind() const
 	{
-		glBindVertexArray(mArrayID);
+		GLStateCache::bindVertexArray(mArrayID);
 	}
 
 
 	void VertexArray::unbind() const
 	{
-		glBindVertexArray(0);
+		GLStateCache::bindVertexArray(0);
 	}
 
 }
@@ -1,54 +1,62 @@
 #include "VertexBuffer.h"
+#include "../GLStateCache.h"
 
 namespace graphics {
 
 	VertexBuffer::VertexBuffer(const GLfloat* data, GLuint count, GLuint componentSize) :
-		mComponentSize(componentSize)
+		mComponentSize(componentSize), mComponentType(GL_FLOAT)
 	{
 		glGenBuffers(1, &mBufferID);
 
-		glBindBuffer(GL_ARRAY_BUFFER, mBufferID);
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, mBufferID);
 		glBufferData(
 			GL_ARRAY_BUFFER,
 			count * sizeof(GLfloat),
 			data,
 			GL_STATIC_DRAW
 		);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
 
 	VertexBuffer::VertexBuffer(const GLushort* data, GLuint count, GLuint componentSize) :
-		mComponentSize(componentSize)
+		mComponentSize(componentSize), mComponentType(GL_UNSIGNED_SHORT)
 	{
 		glGenBuffers(1, &mBufferID);
 
-		glBindBuffer(GL_ARRAY_BUFFER, mBufferID);
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, mBufferID);
 		glBufferData(
 			GL_ARRAY_BUFFER,
 			count * sizeof(GLushort),
 			data,
 			GL_STATIC_DRAW
 		);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
 
 	VertexBuffer::~VertexBuffer()
 	{
+		GLStateCache::removeBuffer(mBufferID);
 		glDeleteBuffers(1, &mBufferID);
 	}
 
 
+	void VertexBuffer::setData(const GLfloat* data, GLuint count)
+	{
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, mBufferID);
+		glBufferData(GL_ARRAY_BUFFER, count * sizeof(GLfloat), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(GLfloat), data);
+	}
+
+
 	void VertexBuffer::bind() const
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, mBufferID);
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, mBufferID);
 	}
 
 
 	void VertexBuffer::unbind() const
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		GLStateCache::bindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
 }
@@ -20,6 +20,9 @@ namespace graphics {
 		/** The number of components per generic Vertex Attribute */
 		GLuint mComponentSize;
 
+		/** The type of the components (GL_FLOAT or GL_UNSIGNED_SHORT) */
+		GLenum mComponentType;
+
 	public:		// Functions
 		/** Creates a new VertexBuffer
 		 * 
@@ -40,9 +43,21 @@ namespace graphics {
 		/** Class destructor */
 		~VertexBuffer();
 
+		/** Replaces all the data of the VertexBuffer with the given one. The
+		 * old data is orphaned so the update doesn't have to wait for the
+		 * draws that are still using it
+		 *
+		 * @param	data a pointer to the new data of the buffer (float)
+		 * @param	count the number of components in the data array
+		 * @note	the buffer is going to be used as a stream buffer */
+		void setData(const GLfloat* data, GLuint count);
+
 		/** @return	the number of components per generic Vertex Attribute */
 		inline GLuint getComponentSize() const { return mComponentSize; };
 
+		/** @return	the type of the components of the VertexBuffer */
+		inline GLenum getComponentType() const { return mComponentType; };
+
 		/** Binds the Vertex Buffer Object */
 		void bind() const;
 
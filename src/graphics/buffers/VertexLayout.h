@@ -0,0 +1,334 @@
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+#include <array>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <algorithm>
+#include <GL/glew.h>
+
+namespace graphics {
+
+	/**
+	 * Struct VertexFormat, it holds the runtime description of the
+	 * attributes of an interleaved vertex buffer
+	 */
+	struct VertexFormat
+	{
+		/** Struct Attribute, it holds the format of a vertex attribute */
+		struct Attribute
+		{
+			/** The index of the attribute */
+			GLuint mIndex;
+
+			/** The number of components of the attribute */
+			GLint mComponentSize;
+
+			/** The type of the components (GL_FLOAT, GL_HALF_FLOAT...) */
+			GLenum mType;
+
+			/** If the fixed point components must be normalized or not */
+			GLboolean mNormalized;
+
+			/** If the components must be read as integers in the shaders
+			 * or not */
+			bool mInteger;
+
+			/** The offset in bytes of the attribute inside each vertex */
+			GLuint mOffset;
+		};
+
+		/** The attributes of each vertex */
+		std::vector<Attribute> mAttributes;
+
+		/** The size in bytes of each vertex */
+		GLuint mStride;
+	};
+
+
+	/**
+	 * The formats of the vertex attributes. Each one has:
+	 * <br>- Input: the type of the unpacked components
+	 * <br>- Type: the type of the packed attribute
+	 * <br>- NUM_INPUTS: the number of unpacked components
+	 * <br>- COMPONENT_SIZE, TYPE, NORMALIZED and INTEGER: the
+	 * parameters of the attribute pointer
+	 * <br>- pack: a function that converts the unpacked components to the
+	 * packed attribute
+	 */
+	template <GLint N>
+	struct FloatFormat
+	{
+		typedef GLfloat Input;
+		typedef std::array<GLfloat, N> Type;
+		static const unsigned int NUM_INPUTS = N;
+		static const GLint COMPONENT_SIZE = N;
+		static const GLenum TYPE = GL_FLOAT;
+		static const GLboolean NORMALIZED = GL_FALSE;
+		static const bool INTEGER = false;
+
+		static void pack(const Input* input, Type& output)
+		{ std::copy(input, input + N, output.begin()); };
+	};
+
+
+	/** Two half floats, used for the texture coordinates */
+	struct Half2Format
+	{
+		typedef GLfloat Input;
+		typedef std::array<GLushort, 2> Type;
+		static const unsigned int NUM_INPUTS = 2;
+		static const GLint COMPONENT_SIZE = 2;
+		static const GLenum TYPE = GL_HALF_FLOAT;
+		static const GLboolean NORMALIZED = GL_FALSE;
+		static const bool INTEGER = false;
+
+		static void pack(const Input* input, Type& output)
+		{
+			output[0] = toHalf(input[0]);
+			output[1] = toHalf(input[1]);
+		};
+
+		/** Converts the given float to a half float, rounding to the
+		 * nearest value */
+		static GLushort toHalf(GLfloat value)
+		{
+			std::uint32_t bits;
+			std::memcpy(&bits, &value, sizeof(GLfloat));
+
+			std::uint32_t sign		= (bits >> 16) & 0x8000;
+			std::int32_t exponent	= static_cast<std::int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+			std::uint32_t mantissa	= bits & 0x7FFFFF;
+
+			if (((bits >> 23) & 0xFF) == 0xFF) {
+				// Infinity or NaN
+				return static_cast<GLushort>(sign | 0x7C00 | ((mantissa != 0)? 0x200 : 0));
+			}
+			if (exponent >= 31) {
+				// Overflow
+				return static_cast<GLushort>(sign | 0x7C00);
+			}
+			if (exponent <= 0) {
+				// Denormal or underflow
+				if (exponent < -10) {
+					return static_cast<GLushort>(sign);
+				}
+
+				mantissa |= 0x800000;
+				std::uint32_t shift = 14 - exponent;
+				std::uint32_t half = mantissa >> shift;
+				if ((mantissa >> (shift - 1)) & 1) {
+					++half;
+				}
+				return static_cast<GLushort>(sign | half);
+			}
+
+			// The rounding carry can overflow to the exponent, which is
+			// still the nearest value
+			std::uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+			if (mantissa & 0x1000) {
+				++half;
+			}
+			return static_cast<GLushort>(half);
+		};
+	};
+
+
+	/** Three signed normalized components packed in 10 bits each, used
+	 * for the normals. The fourth component is always zero */
+	struct Int2101010Format
+	{
+		typedef GLfloat Input;
+		typedef GLuint Type;
+		static const unsigned int NUM_INPUTS = 3;
+		static const GLint COMPONENT_SIZE = 4;
+		static const GLenum TYPE = GL_INT_2_10_10_10_REV;
+		static const GLboolean NORMALIZED = GL_TRUE;
+		static const bool INTEGER = false;
+
+		static void pack(const Input* input, Type& output)
+		{
+			// OpenGL 3.3 converts the components with f = (2c + 1) / 1023,
+			// so -1, 0 and 1 can't be represented exactly. Each value is
+			// encoded with the inverse conversion
+			output = 0;
+			for (unsigned int i = 0; i < 3; ++i) {
+				GLfloat clamped = std::min(std::max(input[i], -1.0f), 1.0f);
+				GLfloat rounded = std::round(0.5f * (clamped * 1023.0f - 1.0f));
+				std::int32_t component = static_cast<std::int32_t>(std::min(std::max(rounded, -512.0f), 511.0f));
+				output |= (static_cast<GLuint>(component) & 0x3FF) << (10 * i);
+			}
+		};
+	};
+
+
+	/** Four unsigned normalized bytes, used for the joint weights */
+	struct UByte4NormFormat
+	{
+		typedef GLfloat Input;
+		typedef std::array<GLubyte, 4> Type;
+		static const unsigned int NUM_INPUTS = 4;
+		static const GLint COMPONENT_SIZE = 4;
+		static const GLenum TYPE = GL_UNSIGNED_BYTE;
+		static const GLboolean NORMALIZED = GL_TRUE;
+		static const bool INTEGER = false;
+
+		static void pack(const Input* input, Type& output)
+		{
+			for (unsigned int i = 0; i < 4; ++i) {
+				GLfloat clamped = std::min(std::max(input[i], 0.0f), 1.0f);
+				output[i] = static_cast<GLubyte>(std::round(clamped * 255.0f));
+			}
+		};
+	};
+
+
+	/** Four unsigned shorts read as integers, used for the joint
+	 * indices */
+	struct UShort4IntFormat
+	{
+		typedef GLushort Input;
+		typedef std::array<GLushort, 4> Type;
+		static const unsigned int NUM_INPUTS = 4;
+		static const GLint COMPONENT_SIZE = 4;
+		static const GLenum TYPE = GL_UNSIGNED_SHORT;
+		static const GLboolean NORMALIZED = GL_FALSE;
+		static const bool INTEGER = true;
+
+		static void pack(const Input* input, Type& output)
+		{ std::copy(input, input + 4, output.begin()); };
+	};
+
+
+	/**
+	 * Struct VertexAttribute, it binds an attribute index to one of the
+	 * vertex attribute formats
+	 */
+	template <GLuint I, typename F>
+	struct VertexAttribute
+	{
+		typedef F Format;
+		static const GLuint INDEX = I;
+	};
+
+
+	/** Returns the sum of the given sizes
+	 *
+	 * @param	sizes the sizes in bytes to add
+	 * @return	the total size in bytes */
+	constexpr GLuint addSizes(std::initializer_list<GLuint> sizes)
+	{
+		GLuint total = 0;
+		for (GLuint size : sizes) {
+			total += size;
+		}
+		return total;
+	}
+
+
+	/**
+	 * Class VertexLayout, it describes at compile time the attributes of
+	 * an interleaved vertex, so their stride, offsets and GL types are
+	 * calculated by the compiler. The attributes are stored in the same
+	 * order than the template parameters
+	 */
+	template <typename... Attributes>
+	class VertexLayout
+	{
+	public:		// Attributes
+		/** The number of attributes of each vertex */
+		static const unsigned int NUM_ATTRIBUTES = sizeof...(Attributes);
+
+		/** The size in bytes of each vertex */
+		static constexpr GLuint STRIDE = addSizes({ sizeof(typename Attributes::Format::Type)... });
+
+		static_assert(STRIDE % 4 == 0, "The attributes must be aligned to 4 bytes");
+
+	public:		// Functions
+		/** @return	the runtime description of the VertexLayout */
+		static VertexFormat getFormat()
+		{
+			VertexFormat format = { {
+				{
+					Attributes::INDEX,
+					Attributes::Format::COMPONENT_SIZE,
+					Attributes::Format::TYPE,
+					Attributes::Format::NORMALIZED,
+					Attributes::Format::INTEGER,
+					0
+				}...
+			}, STRIDE };
+
+			for (unsigned int i = 0; i < NUM_ATTRIBUTES; ++i) {
+				format.mAttributes[i].mOffset = getOffset(i);
+			}
+
+			return format;
+		};
+
+		/** Packs the given attribute data in interleaved vertices
+		 *
+		 * @param	numVertices the number of vertices to pack
+		 * @param	inputs a pointer to the unpacked data of each
+		 *			attribute, with Format::NUM_INPUTS components per
+		 *			vertex
+		 * @return	the packed vertices */
+		static std::vector<GLubyte> pack(
+			unsigned int numVertices,
+			const typename Attributes::Format::Input*... inputs
+		) {
+			std::vector<GLubyte> vertices(numVertices * STRIDE);
+			for (unsigned int i = 0; i < numVertices; ++i) {
+				GLubyte* vertex = vertices.data() + i * STRIDE;
+				unsigned int iAttribute = 0;
+
+				int expander[] = { 0, (packAttribute<typename Attributes::Format>(
+					inputs + i * Attributes::Format::NUM_INPUTS,
+					vertex + getOffset(iAttribute++)
+				), 0)... };
+				(void) expander;
+			}
+
+			return vertices;
+		};
+
+		/** Returns the offset in bytes of an attribute inside each vertex
+		 *
+		 * @param	iAttribute the index of the attribute in the template
+		 *			parameters
+		 * @return	the offset of the attribute */
+		static constexpr GLuint getOffset(unsigned int iAttribute)
+		{
+			const GLuint sizes[] = { sizeof(typename Attributes::Format::Type)... };
+
+			GLuint offset = 0;
+			for (unsigned int i = 0; i < iAttribute; ++i) {
+				offset += sizes[i];
+			}
+			return offset;
+		};
+	private:
+		/** Packs the data of an attribute of a vertex
+		 *
+		 * @param	input a pointer to the unpacked components
+		 * @param	output a pointer to the location of the attribute in
+		 *			the packed vertex */
+		template <typename Format>
+		static void packAttribute(const typename Format::Input* input, GLubyte* output)
+		{
+			typename Format::Type packed;
+			Format::pack(input, packed);
+			std::memcpy(output, &packed, sizeof(packed));
+		};
+	};
+
+
+	template <typename... Attributes>
+	constexpr GLuint VertexLayout<Attributes...>::STRIDE;
+
+}
+
+#endif		// VERTEX_LAYOUT_H
@@ -0,0 +1,198 @@
+#include "AsyncTextureLoader.h"
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include "../utils/Logger.h"
+#include "../graphics/Texture.h"
+
+namespace graphics {
+
+	const char* AsyncTextureLoader::BAKED_TEXTURE_EXTENSION = ".fztx";
+
+// Public Functions
+	AsyncTextureLoader::AsyncTextureLoader(
+		JobSystem& jobSystem, GLuint uploadBudget, float timeBudget,
+		bool bakeTextures
+	) : mJobSystem(jobSystem), mNextPixelBuffer(0),
+		mUploadBudget(uploadBudget), mTimeBudget(timeBudget),
+		mBakeTextures(bakeTextures),
+		mCompressionSupported(GLEW_EXT_texture_compression_s3tc),
+		mNumPending(0)
+	{
+		if (mBakeTextures && !mCompressionSupported) {
+			Logger::writeLog(LogType::WARNING, "S3TC texture compression isn't supported, the images won't be baked");
+		}
+
+		// A grey 2x2 Texture, so the placeholder doesn't stand out
+		const GLubyte placeholderPixels[] = {
+			128, 128, 128, 255,		128, 128, 128, 255,
+			128, 128, 128, 255,		128, 128, 128, 255
+		};
+		mPlaceholder = std::make_shared<Texture>(
+			"placeholder", GL_TEXTURE_2D, placeholderPixels, 2, 2
+		);
+
+		for (auto& pixelBuffer : mPixelBuffers) {
+			pixelBuffer = std::make_unique<PixelBuffer>(mUploadBudget);
+		}
+	}
+
+
+	AsyncTextureLoader::~AsyncTextureLoader()
+	{
+		mJobSystem.wait(mCounter);
+	}
+
+
+	AsyncTextureLoader::TextureSPtr AsyncTextureLoader::loadTexture(
+		const std::string& path, GLuint textureTarget
+	) {
+		auto texture = std::make_shared<Texture>(path, textureTarget, mPlaceholder);
+
+		auto request = std::make_shared<Request>();
+		request->mTexture = texture;
+		request->mPath = path;
+		request->mFailed = false;
+		request->mLevel = 0;
+		request->mNextRow = 0;
+		++mNumPending;
+
+		mJobSystem.run([this, request]() {
+			loadLevels(*request);
+
+			std::lock_guard<std::mutex> lock(mMutex);
+			mDecodedRequests.push_back(request);
+		}, &mCounter);
+
+		return texture;
+	}
+
+
+	void AsyncTextureLoader::update()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mUploadRequests.insert(mUploadRequests.end(), mDecodedRequests.begin(), mDecodedRequests.end());
+			mDecodedRequests.clear();
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		GLuint uploadedBytes = 0;
+		while (!mUploadRequests.empty()) {
+			Request& request = *mUploadRequests.front();
+
+			// Skip the failed Requests and the Textures that aren't used
+			// anymore
+			if (request.mFailed || (request.mTexture.use_count() == 1)) {
+				if (request.mFailed) {
+					Logger::writeLog(LogType::WARNING, "Failed to load the image " + request.mPath);
+				}
+				mUploadRequests.pop_front();
+				--mNumPending;
+				continue;
+			}
+
+			std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			if ((uploadedBytes > 0)
+				&& ((uploadedBytes >= mUploadBudget) || (elapsed.count() >= mTimeBudget))
+			) {
+				break;
+			}
+
+			GLuint maxBytes = (uploadedBytes < mUploadBudget)? mUploadBudget - uploadedBytes : 0;
+			uploadedBytes += uploadRows(request, maxBytes);
+
+			// Sample the uploaded levels as soon as each one is complete
+			const BakedTexture::Level& level = request.mBaked.mLevels[request.mLevel];
+			if (request.mNextRow >= level.mHeight) {
+				request.mTexture->setLevelRange(request.mLevel, request.mBaked.mLevels.size() - 1);
+				request.mTexture->setPlaceholder(nullptr);
+
+				if (request.mLevel == 0) {
+					mUploadRequests.pop_front();
+					--mNumPending;
+				}
+				else {
+					--request.mLevel;
+					request.mNextRow = 0;
+				}
+			}
+		}
+	}
+
+// Private functions
+	void AsyncTextureLoader::loadLevels(Request& request) const
+	{
+		// The compressed levels can't be uploaded without S3TC support,
+		// so the baked texture files are ignored and the images are
+		// decoded without compression
+		const bool bakeTextures = mBakeTextures && mCompressionSupported;
+		const std::string bakedPath = request.mPath + BAKED_TEXTURE_EXTENSION;
+		if (!bakeTextures || !TextureBaker::load(bakedPath, request.mPath, request.mBaked)) {
+			DecodedImage image;
+			if (!ImageDecoder::decode(request.mPath, image) || image.mPixels.empty()) {
+				request.mFailed = true;
+				return;
+			}
+
+			if (bakeTextures) {
+				TextureBaker::bake(image, request.mBaked);
+				TextureBaker::save(bakedPath, request.mPath, request.mBaked);
+			}
+			else {
+				TextureBaker::wrap(image, request.mBaked);
+			}
+		}
+
+		// Start from the smallest level
+		request.mLevel = request.mBaked.mLevels.size() - 1;
+	}
+
+
+	GLuint AsyncTextureLoader::uploadRows(Request& request, GLuint maxBytes)
+	{
+		const BakedTexture& baked = request.mBaked;
+		const BakedTexture::Level& level = baked.mLevels[request.mLevel];
+		const GLenum format = baked.getGLFormat();
+		if (request.mNextRow == 0) {
+			request.mTexture->allocate(request.mLevel, format, level.mWidth, level.mHeight, level.mSize);
+		}
+
+		// The rows are uploaded by rows of blocks
+		const unsigned int blockSize = baked.getBlockSize();
+		const GLuint rowSize = (level.mWidth + blockSize - 1) / blockSize * baked.getBlockBytes();
+		const unsigned int remainingRows = (level.mHeight - request.mNextRow + blockSize - 1) / blockSize;
+		const unsigned int numBlockRows = std::min(remainingRows, std::max(1u, maxBytes / rowSize));
+		const unsigned int numRows = std::min(numBlockRows * blockSize, level.mHeight - request.mNextRow);
+		const GLuint numBytes = numBlockRows * rowSize;
+		const GLubyte* pixels = level.mData + request.mNextRow / blockSize * rowSize;
+
+		// Copy the rows to the next PixelBuffer so the GPU reads them
+		// asynchronously. The rows that don't fit in it are read from the
+		// client memory instead
+		PixelBuffer& pixelBuffer = *mPixelBuffers[mNextPixelBuffer];
+		mNextPixelBuffer = (mNextPixelBuffer + 1) % NUM_PIXEL_BUFFERS;
+
+		GLubyte* mappedPixels = (numBytes <= pixelBuffer.getSize())? pixelBuffer.map() : nullptr;
+		if (mappedPixels) {
+			std::memcpy(mappedPixels, pixels, numBytes);
+			pixelBuffer.unmap();
+			request.mTexture->setRows(
+				request.mLevel, format, request.mNextRow, level.mWidth, numRows,
+				numBytes, nullptr
+			);
+		}
+		else {
+			pixelBuffer.unbind();
+			request.mTexture->setRows(
+				request.mLevel, format, request.mNextRow, level.mWidth, numRows,
+				numBytes, pixels
+			);
+		}
+		pixelBuffer.unbind();
+
+		request.mNextRow += numRows;
+		return numBytes;
+	}
+
+}
@@ -0,0 +1,182 @@
+#ifndef ASYNC_TEXTURE_LOADER_H
+#define ASYNC_TEXTURE_LOADER_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <GL/glew.h>
+#include "../utils/JobSystem.h"
+#include "../graphics/buffers/PixelBuffer.h"
+#include "TextureBaker.h"
+
+namespace graphics {
+
+	class Texture;
+
+
+	/**
+	 * Class AsyncTextureLoader, it loads Textures from image files without
+	 * stalling the GL thread.
+	 * <br>The images are decoded by the workers of the JobSystem, and the
+	 * Textures are returned immediately bound to a placeholder Texture.
+	 * Each frame, update streams the decoded pixels to the Textures
+	 * through a ring of PixelBuffers, by chunks of rows, until the upload
+	 * budget in bytes or in milliseconds is spent.
+	 * <br>If baking is enabled, the images are stored with all their mip
+	 * levels compressed in a baked texture file next to them, with the
+	 * BAKED_TEXTURE_EXTENSION, and the following loads read that file
+	 * instead of decoding the image. The levels are uploaded from the
+	 * smallest to the biggest one, so the Textures stop using the
+	 * placeholder as soon as their smallest level is uploaded and they
+	 * gain detail as the rest of them arrive
+	 */
+	class AsyncTextureLoader
+	{
+	private:	// Nested types
+		typedef std::shared_ptr<Texture> TextureSPtr;
+
+		/** Struct Request, it holds the state of a Texture that is being
+		 * loaded */
+		struct Request
+		{
+			/** The Texture where the image will be uploaded */
+			TextureSPtr mTexture;
+
+			/** The path of the image */
+			std::string mPath;
+
+			/** The levels of the image */
+			BakedTexture mBaked;
+
+			/** If the image couldn't be loaded */
+			bool mFailed;
+
+			/** The level that is being uploaded and its next row */
+			unsigned int mLevel, mNextRow;
+		};
+
+		typedef std::shared_ptr<Request> RequestSPtr;
+
+	private:	// Attributes
+		/** The extension appended to the path of the images for getting
+		 * the path of their baked texture files */
+		static const char* BAKED_TEXTURE_EXTENSION;
+
+		/** The number of PixelBuffers used for streaming the pixels */
+		static const unsigned int NUM_PIXEL_BUFFERS = 3;
+
+		/** The JobSystem used for decoding the images */
+		JobSystem& mJobSystem;
+
+		/** The Counter of the decoding Jobs */
+		JobSystem::Counter mCounter;
+
+		/** The Texture bound instead of the ones that aren't loaded yet */
+		TextureSPtr mPlaceholder;
+
+		/** The PixelBuffers used for streaming the pixels, they are used
+		 * in a round robin */
+		std::unique_ptr<PixelBuffer> mPixelBuffers[NUM_PIXEL_BUFFERS];
+
+		/** The index of the next PixelBuffer to use */
+		unsigned int mNextPixelBuffer;
+
+		/** The maximum number of bytes uploaded in each update */
+		GLuint mUploadBudget;
+
+		/** The maximum time in milliseconds spent in each update */
+		float mTimeBudget;
+
+		/** If the images must be baked or not */
+		bool mBakeTextures;
+
+		/** If the driver supports the S3TC compressed formats of the
+		 * baked textures, it's queried from the GL thread at
+		 * construction */
+		bool mCompressionSupported;
+
+		/** The mutex of mDecodedRequests */
+		std::mutex mMutex;
+
+		/** The Requests decoded by the workers that haven't been taken by
+		 * the GL thread yet */
+		std::deque<RequestSPtr> mDecodedRequests;
+
+		/** The Requests that are being uploaded by the GL thread, in the
+		 * order in which they were decoded */
+		std::deque<RequestSPtr> mUploadRequests;
+
+		/** The number of Textures that aren't loaded yet */
+		std::atomic<unsigned int> mNumPending;
+
+	public:		// Functions
+		/** Creates a new AsyncTextureLoader, it must be created in the
+		 * GL thread
+		 *
+		 * @param	jobSystem the JobSystem used for decoding the images
+		 * @param	uploadBudget the maximum number of bytes uploaded in
+		 *			each update, it's also the size of the PixelBuffers
+		 * @param	timeBudget the maximum time in milliseconds spent
+		 *			uploading in each update
+		 * @param	bakeTextures if the images must be loaded from their
+		 *			baked texture files, baking them first if they don't
+		 *			exist or they are outdated, or decoded without mip
+		 *			levels nor compression. The images are always decoded
+		 *			if the driver doesn't support S3TC compression */
+		AsyncTextureLoader(
+			JobSystem& jobSystem,
+			GLuint uploadBudget = 4 * 1024 * 1024, float timeBudget = 2.0f,
+			bool bakeTextures = true
+		);
+
+		/** Class destructor, it waits until the decoding Jobs have
+		 * finished. The Textures that haven't been uploaded yet keep
+		 * using the placeholder */
+		~AsyncTextureLoader();
+
+		/** @return	the Texture bound instead of the ones that aren't
+		 *			loaded yet */
+		inline TextureSPtr getPlaceholder() const { return mPlaceholder; };
+
+		/** @return	the number of Textures that aren't loaded yet */
+		inline unsigned int getNumPending() const { return mNumPending; };
+
+		/** Starts loading a Texture from the given image file
+		 *
+		 * @param	path the path of the image, it's also used as the path
+		 *			of the Texture
+		 * @param	textureTarget the target to which the Texture is bound
+		 * @return	the new Texture, it will use the placeholder until its
+		 *			pixels are uploaded, or forever if the image can't be
+		 *			decoded */
+		TextureSPtr loadTexture(
+			const std::string& path, GLuint textureTarget = GL_TEXTURE_2D
+		);
+
+		/** Uploads the pixels of the decoded images until the upload
+		 * budgets are spent. It must be called from the GL thread once
+		 * per frame. At least one chunk of rows is uploaded in each call,
+		 * so the Textures are always loaded eventually */
+		void update();
+	private:
+		/** Loads the levels of the image of the given Request, from its
+		 * baked texture file or decoding it. It's called from the
+		 * workers
+		 *
+		 * @param	request the Request to load */
+		void loadLevels(Request& request) const;
+
+		/** Uploads the next chunk of rows of the given Request
+		 *
+		 * @param	request the Request to upload
+		 * @param	maxBytes the maximum number of bytes to upload, at
+		 *			least one row of blocks is uploaded
+		 * @return	the number of uploaded bytes */
+		GLuint uploadRows(Request& request, GLuint maxBytes);
+	};
+
+}
+
+#endif		// ASYNC_TEXTURE_LOADER_H
@@ -0,0 +1,44 @@
+#include "ImageDecoder.h"
+#include <cstring>
+#include <FreeImage.h>
+
+namespace graphics {
+
+	bool ImageDecoder::decode(const std::string& path, DecodedImage& image)
+	{
+		// The image format
+		FREE_IMAGE_FORMAT format = FreeImage_GetFileType(path.c_str(), 0);
+		if (format == FIF_UNKNOWN) {
+			if ((format = FreeImage_GetFIFFromFilename(path.c_str())) == FIF_UNKNOWN) {
+				return false;
+			}
+		}
+
+		FIBITMAP* bitmap = FreeImage_Load(format, path.c_str());
+		if (!bitmap) {
+			return false;
+		}
+
+		// Convert the image to 32 bits per pixel BGRA
+		FIBITMAP* bitmap32 = FreeImage_ConvertTo32Bits(bitmap);
+		FreeImage_Unload(bitmap);
+		if (!bitmap32) {
+			return false;
+		}
+
+		image.mWidth = FreeImage_GetWidth(bitmap32);
+		image.mHeight = FreeImage_GetHeight(bitmap32);
+		image.mPixels.resize(4 * image.mWidth * image.mHeight);
+		for (unsigned int row = 0; row < image.mHeight; ++row) {
+			std::memcpy(
+				image.mPixels.data() + 4 * row * image.mWidth,
+				FreeImage_GetScanLine(bitmap32, row),
+				4 * image.mWidth
+			);
+		}
+
+		FreeImage_Unload(bitmap32);
+		return true;
+	}
+
+}
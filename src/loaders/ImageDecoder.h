@@ -0,0 +1,41 @@
+#ifndef IMAGE_DECODER_H
+#define IMAGE_DECODER_H
+
+#include <string>
+#include <vector>
+#include <GL/glew.h>
+
+namespace graphics {
+
+	/** Struct DecodedImage, it holds the pixels of a decoded image file */
+	struct DecodedImage
+	{
+		/** The pixels of the image in BGRA format, from the bottom row to
+		 * the top one */
+		std::vector<GLubyte> mPixels;
+
+		/** The size of the image in pixels */
+		unsigned int mWidth, mHeight;
+	};
+
+
+	/**
+	 * Class ImageDecoder, it decodes image files with FreeImage to 32 bits
+	 * per pixel BGRA. It doesn't use the GL context, so it can be used
+	 * from any thread
+	 */
+	class ImageDecoder
+	{
+	public:		// Functions
+		/** Decodes the given image file
+		 *
+		 * @param	path the path of the image
+		 * @param	image where the pixels and size of the image will be
+		 *			stored
+		 * @return	true if the image was decoded, false otherwise */
+		static bool decode(const std::string& path, DecodedImage& image);
+	};
+
+}
+
+#endif		// IMAGE_DECODER_H
@@ -1,16 +1,40 @@
 #include "MeshLoader.h"
 #include <map>
 #include <string>
+#include <limits>
 #include <sstream>
+#include <fstream>
+#include <algorithm>
 #include <glm/glm.hpp>
+#include "../utils/Logger.h"
+#include "../utils/MappedFile.h"
 #include "../graphics/3D/Mesh.h"
-#include "../graphics/buffers/VertexBuffer.h"
-#include "../graphics/buffers/IndexBuffer.h"
-#include "../graphics/buffers/VertexArray.h"
 
 namespace graphics {
 
+// Static attributes
+	const float MeshLoader::LOD_REDUCTION		= 0.5f;
+	const float MeshLoader::LOD_MIN_REDUCTION	= 0.8f;
+	const float MeshLoader::LOD_SCREEN_ERROR	= 0.002f;
+
 // Public Functions
+	MeshLoader::MeshLoader(
+		JobSystem& jobSystem,
+		bool optimizeMeshes, unsigned int numLODs
+	) : mStaticPool(StaticVertexLayout::getFormat(), POOL_VERTEX_CAPACITY, POOL_INDEX_CAPACITY),
+		mSkinnedPool(SkinnedVertexLayout::getFormat(), POOL_VERTEX_CAPACITY, POOL_INDEX_CAPACITY),
+		mNormalGenerator(jobSystem), mOptimizeMeshes(optimizeMeshes)
+	{
+		setNumLODs(numLODs);
+	}
+
+
+	void MeshLoader::setNumLODs(unsigned int numLODs)
+	{
+		mNumLODs = (numLODs > Mesh::MAX_LODS)? Mesh::MAX_LODS : std::max(numLODs, 1u);
+	}
+
+
 	MeshLoader::MeshUPtr MeshLoader::createMesh(
 		const std::string& name,
 		const std::vector<GLfloat>& positions,
@@ -18,28 +42,17 @@ namespace graphics {
 		const std::vector<GLfloat>& uvs,
 		const std::vector<GLushort>& faceIndices
 	) {
-		auto vao = std::make_unique<VertexArray>();
-		auto ibo = std::make_unique<IndexBuffer>(faceIndices.data(), faceIndices.size());
-		std::vector<std::unique_ptr<VertexBuffer>> vbos;
-		std::unique_ptr<VertexBuffer> tmp;
-
-		tmp = std::make_unique<VertexBuffer>(positions.data(), positions.size(), 3);
-		vao->addBuffer(tmp.get(), POSITION_ATTRIBUTE);
-		vbos.push_back(std::move(tmp));
+		const unsigned int numVertices = positions.size() / 3;
+		std::vector<GLubyte> vertices = StaticVertexLayout::pack(
+			numVertices, positions.data(), normals.data(), uvs.data()
+		);
 
-		tmp = std::make_unique<VertexBuffer>(normals.data(), normals.size(), 3);
-		vao->addBuffer(tmp.get(), NORMAL_ATTRIBUTE);
-		vbos.push_back(std::move(tmp));
+		std::vector<std::vector<GLushort>> lods;
+		std::vector<float> screenSizes;
+		AABB bounds;
+		prepareMesh(name, positions, faceIndices, StaticVertexLayout::STRIDE, vertices, lods, screenSizes, bounds);
 
-		tmp = std::make_unique<VertexBuffer>(uvs.data(), uvs.size(), 2);
-		vao->addBuffer(tmp.get(), UV_ATTRIBUTE);
-		vbos.push_back(std::move(tmp));
-
-		vao->bind();
-		ibo->bind();
-		vao->unbind();
-
-		return std::make_unique<Mesh>(name, std::move(vbos), std::move(ibo), std::move(vao));
+		return uploadMesh(name, mStaticPool, vertices.data(), numVertices, getLODViews(lods, screenSizes), bounds);
 	}
 
 
@@ -52,84 +65,357 @@ namespace graphics {
 		const std::vector<GLushort>& jointIndices,
 		const std::vector<GLushort>& faceIndices
 	) {
-		std::vector<std::unique_ptr<VertexBuffer>> vbos;
-		auto ibo = std::make_unique<IndexBuffer>(faceIndices.data(), faceIndices.size());
-		auto vao = std::make_unique<VertexArray>();
-
-		std::unique_ptr<VertexBuffer> tmp;
-		tmp = std::make_unique<VertexBuffer>(positions.data(), positions.size(), 3);
-		vao->addBuffer(tmp.get(), POSITION_ATTRIBUTE);
-		vbos.push_back(std::move(tmp));
+		const unsigned int numVertices = positions.size() / 3;
+		std::vector<GLubyte> vertices = SkinnedVertexLayout::pack(
+			numVertices, positions.data(), normals.data(), uvs.data(),
+			jointWeights.data(), jointIndices.data()
+		);
 
-		tmp = std::make_unique<VertexBuffer>(normals.data(), normals.size(), 3);
-		vao->addBuffer(tmp.get(), NORMAL_ATTRIBUTE);
-		vbos.push_back(std::move(tmp));
+		std::vector<std::vector<GLushort>> lods;
+		std::vector<float> screenSizes;
+		AABB bounds;
+		prepareMesh(name, positions, faceIndices, SkinnedVertexLayout::STRIDE, vertices, lods, screenSizes, bounds);
 
-		tmp = std::make_unique<VertexBuffer>(uvs.data(), uvs.size(), 2);
-		vao->addBuffer(tmp.get(), UV_ATTRIBUTE);
-		vbos.push_back(std::move(tmp));
+		return uploadMesh(name, mSkinnedPool, vertices.data(), numVertices, getLODViews(lods, screenSizes), bounds);
+	}
 
-		tmp = std::make_unique<VertexBuffer>(jointWeights.data(), jointWeights.size(), 4);
-		vao->addBuffer(tmp.get(), JOINT_WEIGHT_ATTRIBUTE);
-		vbos.push_back(std::move(tmp));
 
-		tmp = std::make_unique<VertexBuffer>(jointIndices.data(), jointIndices.size(), 4);
-		vao->addBuffer(tmp.get(), JOINT_INDEX_ATTRIBUTE);
-		vbos.push_back(std::move(tmp));
+	bool MeshLoader::saveMesh(
+		const std::string& path,
+		const std::vector<GLfloat>& positions,
+		const std::vector<GLfloat>& normals,
+		const std::vector<GLfloat>& uvs,
+		const std::vector<GLushort>& faceIndices
+	) const
+	{
+		const unsigned int numVertices = positions.size() / 3;
+		std::vector<GLubyte> vertices = StaticVertexLayout::pack(
+			numVertices, positions.data(), normals.data(), uvs.data()
+		);
 
-		vao->bind();
-		ibo->bind();
-		vao->unbind();
+		std::vector<std::vector<GLushort>> lods;
+		std::vector<float> screenSizes;
+		AABB bounds;
+		prepareMesh(path, positions, faceIndices, StaticVertexLayout::STRIDE, vertices, lods, screenSizes, bounds);
 
-		return std::make_unique<Mesh>(name, std::move(vbos), std::move(ibo), std::move(vao));
+		return writeMeshFile(
+			path, STATIC_LAYOUT, StaticVertexLayout::STRIDE,
+			vertices, numVertices, lods, screenSizes, bounds
+		);
 	}
 
 
-	std::vector<GLfloat> MeshLoader::calculateNormals(
+	bool MeshLoader::saveMesh(
+		const std::string& path,
 		const std::vector<GLfloat>& positions,
+		const std::vector<GLfloat>& normals,
+		const std::vector<GLfloat>& uvs,
+		const std::vector<GLfloat>& jointWeights,
+		const std::vector<GLushort>& jointIndices,
 		const std::vector<GLushort>& faceIndices
 	) const
 	{
-		std::vector<GLfloat> normals(positions.size(), 0);
+		const unsigned int numVertices = positions.size() / 3;
+		std::vector<GLubyte> vertices = SkinnedVertexLayout::pack(
+			numVertices, positions.data(), normals.data(), uvs.data(),
+			jointWeights.data(), jointIndices.data()
+		);
+
+		std::vector<std::vector<GLushort>> lods;
+		std::vector<float> screenSizes;
+		AABB bounds;
+		prepareMesh(path, positions, faceIndices, SkinnedVertexLayout::STRIDE, vertices, lods, screenSizes, bounds);
+
+		return writeMeshFile(
+			path, SKINNED_LAYOUT, SkinnedVertexLayout::STRIDE,
+			vertices, numVertices, lods, screenSizes, bounds
+		);
+	}
+
+
+	MeshLoader::MeshUPtr MeshLoader::loadMesh(const std::string& path)
+	{
+		MappedFile file(path);
+		const unsigned char* data = file.getData();
+		const std::uint64_t size = file.getSize();
 
-		// Sum to the normal of every vertex, the normal of the faces 
-		// which it belongs
-		for (unsigned int i = 0; i < faceIndices.size(); i+=3) {
-			// Get the normal of triangle
-			GLfloat v1_x = positions[3 * faceIndices[i]]		- positions[3 * faceIndices[i+1]];
-			GLfloat v1_y = positions[3 * faceIndices[i] + 1]	- positions[3 * faceIndices[i+1] + 1];
-			GLfloat v1_z = positions[3 * faceIndices[i] + 2]	- positions[3 * faceIndices[i+1] + 2];
-			glm::vec3 v1(v1_x, v1_y, v1_z);
+		// Validate the header before reading any data through it
+		const char* error = nullptr;
+		const MeshFileHeader* header = nullptr;
+		const MeshFileLOD* lodTable = nullptr;
+		if (!file.isOpen()) {
+			error = "can't map the file";
+		}
+		else if (size < sizeof(MeshFileHeader)) {
+			error = "truncated header";
+		}
+		else {
+			header = reinterpret_cast<const MeshFileHeader*>(data);
+			lodTable = reinterpret_cast<const MeshFileLOD*>(data + sizeof(MeshFileHeader));
 
-			GLfloat v2_x = positions[3 * faceIndices[i]]		- positions[3 * faceIndices[i+2]];
-			GLfloat v2_y = positions[3 * faceIndices[i] + 1]	- positions[3 * faceIndices[i+2] + 1];
-			GLfloat v2_z = positions[3 * faceIndices[i] + 2]	- positions[3 * faceIndices[i+2] + 2];
-			glm::vec3 v2(v2_x, v2_y, v1_z);
+			if (header->mMagic != MESH_FILE_MAGIC) {
+				error = "it isn't a mesh file";
+			}
+			else if (header->mVersion != MESH_FILE_VERSION) {
+				error = "unsupported version";
+			}
+			else if (
+				!((header->mLayout == STATIC_LAYOUT) && (header->mStride == StaticVertexLayout::STRIDE))
+				&& !((header->mLayout == SKINNED_LAYOUT) && (header->mStride == SkinnedVertexLayout::STRIDE))
+			) {
+				error = "unknown vertex layout";
+			}
+			else if ((header->mNumVertices == 0) || (header->mNumVertices - 1 > std::numeric_limits<GLushort>::max())) {
+				error = "invalid number of vertices";
+			}
+			else if ((header->mNumLODs == 0) || (header->mNumLODs > Mesh::MAX_LODS)) {
+				error = "invalid number of LODs";
+			}
+			else if (size < sizeof(MeshFileHeader) + header->mNumLODs * sizeof(MeshFileLOD)) {
+				error = "truncated LOD table";
+			}
+			else if (
+				(header->mVertexOffset % MESH_FILE_ALIGNMENT != 0)
+				|| (header->mVertexOffset > size)
+				|| (size - header->mVertexOffset < static_cast<std::uint64_t>(header->mNumVertices) * header->mStride)
+			) {
+				error = "truncated vertices";
+			}
+		}
+
+		std::vector<LODView> lods;
+		for (unsigned int i = 0; !error && (i < header->mNumLODs); ++i) {
+			const MeshFileLOD& lod = lodTable[i];
+			if ((lod.mIndexCount == 0) || (lod.mIndexCount % 3 != 0)
+				|| (lod.mIndexOffset % MESH_FILE_ALIGNMENT != 0)
+				|| (lod.mIndexOffset > size)
+				|| (size - lod.mIndexOffset < static_cast<std::uint64_t>(lod.mIndexCount) * sizeof(GLushort))
+			) {
+				error = "truncated indices";
+			}
+			else {
+				lods.push_back({
+					reinterpret_cast<const GLushort*>(data + lod.mIndexOffset),
+					lod.mIndexCount, lod.mScreenSize
+				});
+			}
+		}
 
-			glm::vec3 normal = glm::cross(v1, v2);
+		if (error) {
+			Logger::writeLog(LogType::ERROR, "Error loading the mesh file " + path + ": " + error);
+			return nullptr;
+		}
+
+		AABB bounds;
+		bounds.mMinimum = glm::vec3(header->mMinimum[0], header->mMinimum[1], header->mMinimum[2]);
+		bounds.mMaximum = glm::vec3(header->mMaximum[0], header->mMaximum[1], header->mMaximum[2]);
 
-			normals[3 * faceIndices[i]]			+= normal.x;
-			normals[3 * faceIndices[i] + 1]		+= normal.y;
-			normals[3 * faceIndices[i] + 2]		+= normal.z;
+		MeshBufferPool& pool = (header->mLayout == STATIC_LAYOUT)? mStaticPool : mSkinnedPool;
+		return uploadMesh(path, pool, data + header->mVertexOffset, header->mNumVertices, lods, bounds);
+	}
 
-			normals[3 * faceIndices[i+1]]		+= normal.x;
-			normals[3 * faceIndices[i+1] + 1]	+= normal.y;
-			normals[3 * faceIndices[i+1] + 2]	+= normal.z;
 
-			normals[3 * faceIndices[i+2]]		+= normal.x;
-			normals[3 * faceIndices[i+2] + 1]	+= normal.y;
-			normals[3 * faceIndices[i+2] + 2]	+= normal.z;
+	AABB MeshLoader::calculateBounds(const std::vector<GLfloat>& positions) const
+	{
+		AABB bounds = { glm::vec3(0.0f), glm::vec3(0.0f) };
+
+		if (positions.size() >= 3) {
+			bounds.mMaximum = bounds.mMinimum = glm::vec3(positions[0], positions[1], positions[2]);
+			for (unsigned int i = 3; i + 2 < positions.size(); i+=3) {
+				glm::vec3 position(positions[i], positions[i+1], positions[i+2]);
+				bounds.mMaximum = glm::max(bounds.mMaximum, position);
+				bounds.mMinimum = glm::min(bounds.mMinimum, position);
+			}
 		}
 
-		// Normalize the normal vector of every vertex
-		for (unsigned int i = 0; i < normals.size(); i+=3) {
-			GLfloat length	= sqrt( pow(normals[i], 2) + pow(normals[i+1], 2) + pow(normals[i+2], 2) );
-			normals[i]		/= length;
-			normals[i+1]	/= length;
-			normals[i+2]	/= length;
+		return bounds;
+	}
+
+// Private functions
+	void MeshLoader::createLODs(
+		const std::vector<GLfloat>& positions,
+		const std::vector<GLushort>& faceIndices,
+		const AABB& bounds,
+		std::vector<std::vector<GLushort>>& lods,
+		std::vector<float>& screenSizes
+	) const
+	{
+		lods.assign(1, faceIndices);
+		screenSizes.assign(1, std::numeric_limits<float>::max());
+
+		// The SceneBatcher selects the LODs with the same radius, scaled by
+		// the model matrix of each Renderable3D
+		const float radius = bounds.getRadius();
+		unsigned int targetIndexCount = faceIndices.size();
+		for (unsigned int i = 1; i < mNumLODs; ++i) {
+			targetIndexCount = 3 * static_cast<unsigned int>(LOD_REDUCTION * targetIndexCount / 3);
+
+			// Each LOD is simplified from the original indices, so its
+			// error is measured against the original surface
+			float error;
+			std::vector<GLushort> lod = mSimplifier.simplify(faceIndices, positions, targetIndexCount, error);
+			if (lod.empty() || (lod.size() > LOD_MIN_REDUCTION * lods.back().size())) {
+				break;
+			}
+
+			// When the bounding sphere of the Mesh covers s screen heights,
+			// the error covers error * s / (2 * radius) screen heights
+			screenSizes.push_back((error > 0.0f)?
+				2.0f * radius * LOD_SCREEN_ERROR / error :
+				std::numeric_limits<float>::max()
+			);
+			lods.push_back(std::move(lod));
 		}
+	}
+
 
-		return normals;
+	void MeshLoader::prepareMesh(
+		const std::string& name,
+		const std::vector<GLfloat>& positions,
+		const std::vector<GLushort>& faceIndices,
+		GLuint stride, std::vector<GLubyte>& vertices,
+		std::vector<std::vector<GLushort>>& lods,
+		std::vector<float>& screenSizes,
+		AABB& bounds
+	) const
+	{
+		bounds = calculateBounds(positions);
+		createLODs(positions, faceIndices, bounds, lods, screenSizes);
+		if (mOptimizeMeshes) {
+			optimizeMesh(name, positions, vertices, stride, lods);
+		}
+	}
+
+
+	void MeshLoader::optimizeMesh(
+		const std::string& name,
+		const std::vector<GLfloat>& positions,
+		std::vector<GLubyte>& vertices, GLuint stride,
+		std::vector<std::vector<GLushort>>& lods
+	) const
+	{
+		const unsigned int numVertices = positions.size() / 3;
+		MeshOptimizer::Statistics before = mOptimizer.analyzeVertexCache(lods.front(), numVertices);
+
+		for (std::vector<GLushort>& lod : lods) {
+			lod = mOptimizer.optimizeVertexCache(lod, numVertices);
+			lod = mOptimizer.optimizeOverdraw(lod, positions);
+		}
+
+		// The vertices are ordered by the first LOD, the other ones share
+		// them
+		std::vector<unsigned int> remap = mOptimizer.optimizeVertexFetch(lods.front(), numVertices);
+		for (unsigned int i = 1; i < lods.size(); ++i) {
+			for (GLushort& index : lods[i]) {
+				index = static_cast<GLushort>(remap[index]);
+			}
+		}
+		MeshOptimizer::remapVertices(vertices, stride, remap);
+
+		MeshOptimizer::Statistics after = mOptimizer.analyzeVertexCache(lods.front(), numVertices);
+
+		std::ostringstream message;
+		message << "Optimized the Mesh " << name
+			<< ": ACMR " << before.mACMR << " -> " << after.mACMR
+			<< ", ATVR " << before.mATVR << " -> " << after.mATVR;
+		Logger::writeLog(LogType::DEBUG, message.str());
+	}
+
+
+	MeshLoader::MeshUPtr MeshLoader::uploadMesh(
+		const std::string& name, MeshBufferPool& pool,
+		const GLvoid* vertices, unsigned int numVertices,
+		const std::vector<LODView>& lods,
+		const AABB& bounds
+	) {
+		unsigned int rangeID = pool.addMesh(
+			vertices, numVertices,
+			lods.front().mIndices, lods.front().mIndexCount
+		);
+
+		auto mesh = std::make_unique<Mesh>(name, pool, rangeID);
+		for (unsigned int i = 1; i < lods.size(); ++i) {
+			mesh->addLOD(pool.addIndices(lods[i].mIndices, lods[i].mIndexCount), lods[i].mScreenSize);
+		}
+		mesh->setBounds(bounds);
+
+		return mesh;
+	}
+
+
+	bool MeshLoader::writeMeshFile(
+		const std::string& path,
+		MeshFileLayout layout, GLuint stride,
+		const std::vector<GLubyte>& vertices, unsigned int numVertices,
+		const std::vector<std::vector<GLushort>>& lods,
+		const std::vector<float>& screenSizes,
+		const AABB& bounds
+	) {
+		// Locate the data after the header and the LOD table
+		MeshFileHeader header = {};
+		header.mMagic		= MESH_FILE_MAGIC;
+		header.mVersion		= MESH_FILE_VERSION;
+		header.mLayout		= layout;
+		header.mStride		= stride;
+		header.mNumVertices	= numVertices;
+		header.mNumLODs		= lods.size();
+		for (unsigned int i = 0; i < 3; ++i) {
+			header.mMinimum[i] = bounds.mMinimum[i];
+			header.mMaximum[i] = bounds.mMaximum[i];
+		}
+
+		std::uint64_t offset = alignFileOffset(sizeof(MeshFileHeader) + lods.size() * sizeof(MeshFileLOD));
+		header.mVertexOffset = offset;
+		offset = alignFileOffset(offset + vertices.size());
+
+		std::vector<MeshFileLOD> lodTable;
+		for (unsigned int i = 0; i < lods.size(); ++i) {
+			lodTable.push_back({ offset, static_cast<std::uint32_t>(lods[i].size()), screenSizes[i] });
+			offset = alignFileOffset(offset + lods[i].size() * sizeof(GLushort));
+		}
+
+		// Write the data with zero padding up to each offset
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		const char padding[MESH_FILE_ALIGNMENT] = {};
+		auto pad = [&]() {
+			std::uint64_t position = file.tellp();
+			file.write(padding, alignFileOffset(position) - position);
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(MeshFileHeader));
+		file.write(reinterpret_cast<const char*>(lodTable.data()), lodTable.size() * sizeof(MeshFileLOD));
+		pad();
+		file.write(reinterpret_cast<const char*>(vertices.data()), vertices.size());
+		for (const std::vector<GLushort>& lod : lods) {
+			pad();
+			file.write(reinterpret_cast<const char*>(lod.data()), lod.size() * sizeof(GLushort));
+		}
+
+		if (!file.good()) {
+			Logger::writeLog(LogType::ERROR, "Error writing the mesh file " + path);
+			return false;
+		}
+
+		return true;
+	}
+
+
+	std::vector<MeshLoader::LODView> MeshLoader::getLODViews(
+		const std::vector<std::vector<GLushort>>& lods,
+		const std::vector<float>& screenSizes
+	) {
+		std::vector<LODView> views;
+		for (unsigned int i = 0; i < lods.size(); ++i) {
+			views.push_back({ lods[i].data(), static_cast<GLuint>(lods[i].size()), screenSizes[i] });
+		}
+
+		return views;
+	}
+
+
+	std::uint64_t MeshLoader::alignFileOffset(std::uint64_t offset)
+	{
+		return (offset + MESH_FILE_ALIGNMENT - 1) / MESH_FILE_ALIGNMENT * MESH_FILE_ALIGNMENT;
 	}
 
 }
@@ -2,9 +2,16 @@
 #define MESH_LOADER_H
 
 #include <memory>
+#include <string>
 #include <vector>
+#include <cstdint>
 #include <GL/glew.h>
 #include "../graphics/3D/AABB.h"
+#include "../graphics/buffers/VertexLayout.h"
+#include "../graphics/buffers/MeshBufferPool.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "NormalGenerator.h"
 
 namespace graphics {
 
@@ -13,9 +20,36 @@ namespace graphics {
 
 	/**
 	 * Class MeshLoader, it's used to create meshes from raw data
+	 * <br>The data of the Meshes is stored in the MeshBufferPools of the
+	 * MeshLoader, one for the static Meshes and another one for the
+	 * skinned ones, so all the Meshes with the same vertex format can be
+	 * drawn without changing the bound VAO. The vertices are interleaved
+	 * and packed: the normals as 10_10_10_2 signed normalized integers,
+	 * the UVs as half floats, the joint weights as normalized bytes and the
+	 * joint indices as integer shorts
+	 * <br>The triangles and vertices of the Meshes can optionally be
+	 * reordered with a MeshOptimizer before they are uploaded, and a chain
+	 * of LODs can be generated for each Mesh with a MeshSimplifier. Each
+	 * LOD halves the triangles of the previous one, and its screen size is
+	 * the one at which its simplification error projects to
+	 * LOD_SCREEN_ERROR screen heights
+	 * <br>The normals and tangents are calculated in parallel with the
+	 * JobSystem by a NormalGenerator
+	 * <br>The processed Meshes can also be saved to binary mesh files,
+	 * with the packed vertices and the indices of the LODs already in the
+	 * format of the MeshBufferPools. When they are loaded, the files are
+	 * memory mapped and their data is uploaded straight from the mapping
+	 * without parsing it nor copying it to intermediate buffers. The files
+	 * start with a MeshFileHeader followed by a MeshFileLOD per LOD, and
+	 * the vertex and index data are aligned to MESH_FILE_ALIGNMENT bytes.
+	 * They are stored with the byte order of the machine that saved them
 	 */
 	class MeshLoader
 	{
+	public:		// Nested types
+		/** The weights of the face normals used by calculateNormals */
+		typedef NormalGenerator::NormalWeight NormalWeight;
+
 	private:	// Nested types
 		/** The attribute indices of the Meshes */
 		enum ATTRIBUTES
@@ -27,14 +61,176 @@ namespace graphics {
 			JOINT_INDEX_ATTRIBUTE
 		};
 
+		/** The vertex layouts of the mesh files */
+		enum MeshFileLayout
+		{
+			STATIC_LAYOUT,
+			SKINNED_LAYOUT
+		};
+
+		/** Struct MeshFileHeader, it's stored at the start of the mesh
+		 * files */
+		struct MeshFileHeader
+		{
+			/** The MESH_FILE_MAGIC number */
+			std::uint32_t mMagic;
+
+			/** The MESH_FILE_VERSION of the file */
+			std::uint32_t mVersion;
+
+			/** The MeshFileLayout of the vertices */
+			std::uint32_t mLayout;
+
+			/** The size in bytes of each vertex */
+			std::uint32_t mStride;
+
+			/** The number of vertices of the Mesh */
+			std::uint32_t mNumVertices;
+
+			/** The number of LODs of the Mesh, including the first one */
+			std::uint32_t mNumLODs;
+
+			/** The minimum and maximum coordinates of the vertices */
+			float mMinimum[3], mMaximum[3];
+
+			/** The offset in bytes of the vertices from the start of the
+			 * file */
+			std::uint64_t mVertexOffset;
+		};
+
+		/** Struct MeshFileLOD, it holds the location of the indices of a
+		 * LOD inside the mesh files */
+		struct MeshFileLOD
+		{
+			/** The offset in bytes of the indices from the start of the
+			 * file */
+			std::uint64_t mIndexOffset;
+
+			/** The number of indices of the LOD */
+			std::uint32_t mIndexCount;
+
+			/** The screen size of the LOD */
+			float mScreenSize;
+		};
+
+		/** Struct LODView, it points to the indices of a LOD that must be
+		 * uploaded, stored in vectors or in a mapped mesh file */
+		struct LODView
+		{
+			/** A pointer to the indices of the LOD */
+			const GLushort* mIndices;
+
+			/** The number of indices of the LOD */
+			GLuint mIndexCount;
+
+			/** The screen size of the LOD */
+			float mScreenSize;
+		};
+
 		typedef std::unique_ptr<Mesh> MeshUPtr;
 
+		/** The layouts of the vertices of the static and skinned Meshes */
+		typedef VertexLayout<
+			VertexAttribute<POSITION_ATTRIBUTE, FloatFormat<3>>,
+			VertexAttribute<NORMAL_ATTRIBUTE, Int2101010Format>,
+			VertexAttribute<UV_ATTRIBUTE, Half2Format>
+		> StaticVertexLayout;
+
+		typedef VertexLayout<
+			VertexAttribute<POSITION_ATTRIBUTE, FloatFormat<3>>,
+			VertexAttribute<NORMAL_ATTRIBUTE, Int2101010Format>,
+			VertexAttribute<UV_ATTRIBUTE, Half2Format>,
+			VertexAttribute<JOINT_WEIGHT_ATTRIBUTE, UByte4NormFormat>,
+			VertexAttribute<JOINT_INDEX_ATTRIBUTE, UShort4IntFormat>
+		> SkinnedVertexLayout;
+
+	private:	// Attributes
+		/** The initial number of vertices and indices of the
+		 * MeshBufferPools */
+		static const GLuint POOL_VERTEX_CAPACITY = 65536;
+		static const GLuint POOL_INDEX_CAPACITY = 196608;
+
+		/** The identifier of the mesh files, "FZMS" in little endian */
+		static const std::uint32_t MESH_FILE_MAGIC = 0x534D5A46;
+
+		/** The version of the format of the mesh files */
+		static const std::uint32_t MESH_FILE_VERSION = 1;
+
+		/** The alignment in bytes of the data of the mesh files */
+		static const std::uint32_t MESH_FILE_ALIGNMENT = 16;
+
+		/** The ratio of indices of each LOD relative to the previous one */
+		static const float LOD_REDUCTION;
+
+		/** The LOD chain stops when a LOD can't be reduced below this ratio
+		 * of indices of the previous one */
+		static const float LOD_MIN_REDUCTION;
+
+		/** The maximum simplification error of the LODs relative to the
+		 * height of the screen */
+		static const float LOD_SCREEN_ERROR;
+
+		/** The MeshBufferPool with the data of the static Meshes */
+		MeshBufferPool mStaticPool;
+
+		/** The MeshBufferPool with the data of the skinned Meshes */
+		MeshBufferPool mSkinnedPool;
+
+		/** The MeshOptimizer used for reordering the Meshes data */
+		MeshOptimizer mOptimizer;
+
+		/** The MeshSimplifier used for generating the LODs */
+		MeshSimplifier mSimplifier;
+
+		/** The NormalGenerator used for calculating the normals and
+		 * tangents */
+		NormalGenerator mNormalGenerator;
+
+		/** If the Meshes data must be optimized before uploading it or
+		 * not */
+		bool mOptimizeMeshes;
+
+		/** The number of LODs to generate for each Mesh, including the
+		 * original one */
+		unsigned int mNumLODs;
+
 	public:		// Functions
-		/** Creates a new MeshLoader */
-		MeshLoader() {};
+		/** Creates a new MeshLoader
+		 *
+		 * @param	jobSystem the JobSystem used for calculating the normals
+		 *			and tangents
+		 * @param	optimizeMeshes if the triangles and vertices of the
+		 *			Meshes must be reordered for the vertex cache, the
+		 *			overdraw and the vertex fetch before uploading them
+		 * @param	numLODs the number of LODs to generate for each Mesh,
+		 *			including the original one, up to Mesh::MAX_LODS
+		 * @note	the MeshLoader must outlive the Meshes that it creates */
+		MeshLoader(
+			JobSystem& jobSystem,
+			bool optimizeMeshes = false, unsigned int numLODs = 1
+		);
 
 		/** Class destructor */
 		~MeshLoader() {};
+
+		/** @return	the MeshBufferPool with the data of the static Meshes */
+		inline MeshBufferPool& getStaticPool() { return mStaticPool; };
+
+		/** @return	the MeshBufferPool with the data of the skinned
+		 *			Meshes */
+		inline MeshBufferPool& getSkinnedPool() { return mSkinnedPool; };
+
+		/** Sets if the Meshes data must be optimized before uploading it
+		 *
+		 * @param	optimizeMeshes the new value */
+		inline void setOptimizeMeshes(bool optimizeMeshes)
+		{ mOptimizeMeshes = optimizeMeshes; };
+
+		/** Sets the number of LODs to generate for each Mesh
+		 *
+		 * @param	numLODs the number of LODs, including the original
+		 *			one, up to Mesh::MAX_LODS */
+		void setNumLODs(unsigned int numLODs);
 		
 		/** creates a Mesh with the given mesh data
 		 *
@@ -44,7 +240,9 @@ namespace graphics {
 		 * @param	uvs the texture coordinates of the vertices
 		 * @param	faceIndices the indices of the vertices that form the
 		 *			faces of the Mesh
-		 * @return	a pointer to the new created Mesh */
+		 * @return	a pointer to the new created Mesh
+		 * @note	all the vectors of vertex data must have the data of the
+		 *			same number of vertices */
 		MeshUPtr createMesh(
 			const std::string& name,
 			const std::vector<GLfloat>& positions,
@@ -64,7 +262,9 @@ namespace graphics {
 		 * @param	jointIndices the indices of the joints
 		 * @param	weights the weights of the joint in each vertex
 		 * @return	a pointer to the new created Mesh
-		 * @note	one vertex can be influenced by a maximum of 4 joints */
+		 * @note	one vertex can be influenced by a maximum of 4 joints,
+		 *			and all the vectors of vertex data must have the data
+		 *			of the same number of vertices */
 		MeshUPtr createMesh(
 			const std::string& name,
 			const std::vector<GLfloat>& positions,
@@ -74,17 +274,217 @@ namespace graphics {
 			const std::vector<GLushort>& jointIndices,
 			const std::vector<GLushort>& faceIndices
 		);
+
+		/** Processes the given mesh data like createMesh and saves it to a
+		 * mesh file instead of uploading it
+		 *
+		 * @param	path the path of the file
+		 * @param	positions the coordinates of the vertices of the Mesh
+		 * @param	normals the normals of the vertices of the Mesh
+		 * @param	uvs the texture coordinates of the vertices
+		 * @param	faceIndices the indices of the vertices that form the
+		 *			faces of the Mesh
+		 * @return	true if the file was saved, false otherwise */
+		bool saveMesh(
+			const std::string& path,
+			const std::vector<GLfloat>& positions,
+			const std::vector<GLfloat>& normals,
+			const std::vector<GLfloat>& uvs,
+			const std::vector<GLushort>& faceIndices
+		) const;
+
+		/** Processes the given skinned mesh data like createMesh and saves
+		 * it to a mesh file instead of uploading it
+		 *
+		 * @param	path the path of the file
+		 * @param	positions the coordinates of the vertices of the Mesh
+		 * @param	normals the normals of the vertices of the Mesh
+		 * @param	uvs the texture coordinates of the vertices
+		 * @param	jointWeights the weights of the joint in each vertex
+		 * @param	jointIndices the indices of the joints
+		 * @param	faceIndices the indices of the vertices that form the
+		 *			faces of the Mesh
+		 * @return	true if the file was saved, false otherwise */
+		bool saveMesh(
+			const std::string& path,
+			const std::vector<GLfloat>& positions,
+			const std::vector<GLfloat>& normals,
+			const std::vector<GLfloat>& uvs,
+			const std::vector<GLfloat>& jointWeights,
+			const std::vector<GLushort>& jointIndices,
+			const std::vector<GLushort>& faceIndices
+		) const;
+
+		/** Creates a Mesh from a mesh file saved with saveMesh. The file is
+		 * memory mapped and its data is uploaded to the MeshBufferPool
+		 * of its vertex layout directly from the mapping
+		 *
+		 * @param	path the path of the file, it's also used as the name
+		 *			of the Mesh
+		 * @return	a pointer to the new created Mesh, nullptr if the file
+		 *			couldn't be read or it isn't a valid mesh file
+		 * @note	the indices aren't validated against the number of
+		 *			vertices, so the files must come from a trusted
+		 *			source */
+		MeshUPtr loadMesh(const std::string& path);
 		
 		/** Calculates the Normals of the given vertices
 		 * 
 		 * @param	positions a vector with the positions of the vertices
 		 * @param	faceIndices a vector with indices of the vertices that
 		 *			compose the faces of a Mesh
-		 * @return	a vector with the normals of the vertices */
-		std::vector<GLfloat> calculateNormals(
+		 * @param	weight how the normals of the faces are weighted, by
+		 *			their area or by the angle of the face at each vertex
+		 * @return	a vector with the normals of the vertices, the ones of
+		 *			the vertices without faces are zero */
+		inline std::vector<GLfloat> calculateNormals(
+			const std::vector<GLfloat>& positions,
+			const std::vector<GLushort>& faceIndices,
+			NormalWeight weight = NormalGenerator::AREA_WEIGHT
+		) const
+		{ return mNormalGenerator.calculateNormals(positions, faceIndices, weight); };
+
+		/** Calculates the Tangents of the given vertices from the
+		 * directions in which their texture coordinates increase
+		 *
+		 * @param	positions a vector with the positions of the vertices
+		 * @param	normals a vector with the normals of the vertices
+		 * @param	uvs a vector with the texture coordinates of the
+		 *			vertices
+		 * @param	faceIndices a vector with indices of the vertices that
+		 *			compose the faces of a Mesh
+		 * @return	a vector with the tangents of the vertices, 4 floats
+		 *			per vertex: the tangent orthogonalized against the
+		 *			normal, and the handedness of the bitangent (1 or -1) */
+		inline std::vector<GLfloat> calculateTangents(
 			const std::vector<GLfloat>& positions,
+			const std::vector<GLfloat>& normals,
+			const std::vector<GLfloat>& uvs,
 			const std::vector<GLushort>& faceIndices
+		) const
+		{ return mNormalGenerator.calculateTangents(positions, normals, uvs, faceIndices); };
+
+		/** Calculates the bounds of the given vertices
+		 *
+		 * @param	positions a vector with the positions of the vertices
+		 * @return	an AABB with the maximum and minimum coordinates of the
+		 *			vertices in each axis */
+		AABB calculateBounds(const std::vector<GLfloat>& positions) const;
+	private:
+		/** Generates the LODs of a Mesh with the MeshSimplifier
+		 *
+		 * @param	positions the coordinates of the vertices of the Mesh
+		 * @param	faceIndices the indices of the vertices that form the
+		 *			faces of the Mesh
+		 * @param	bounds the bounds of the Mesh
+		 * @param	lods where the indices of each LOD will be stored, the
+		 *			first one is faceIndices
+		 * @param	screenSizes where the screen size of each LOD will be
+		 *			stored */
+		void createLODs(
+			const std::vector<GLfloat>& positions,
+			const std::vector<GLushort>& faceIndices,
+			const AABB& bounds,
+			std::vector<std::vector<GLushort>>& lods,
+			std::vector<float>& screenSizes
+		) const;
+
+		/** Processes the packed vertices of a Mesh before saving or
+		 * uploading them: calculates its bounds, generates its LODs and
+		 * optimizes them if it's enabled
+		 *
+		 * @param	name the name of the Mesh
+		 * @param	positions the coordinates of the vertices of the Mesh
+		 * @param	faceIndices the indices of the vertices that form the
+		 *			faces of the Mesh
+		 * @param	stride the size in bytes of each packed vertex
+		 * @param	vertices the packed vertices of the Mesh, they will be
+		 *			reordered if the Mesh is optimized
+		 * @param	lods where the indices of each LOD will be stored
+		 * @param	screenSizes where the screen size of each LOD will be
+		 *			stored
+		 * @param	bounds where the bounds of the Mesh will be stored */
+		void prepareMesh(
+			const std::string& name,
+			const std::vector<GLfloat>& positions,
+			const std::vector<GLushort>& faceIndices,
+			GLuint stride, std::vector<GLubyte>& vertices,
+			std::vector<std::vector<GLushort>>& lods,
+			std::vector<float>& screenSizes,
+			AABB& bounds
 		) const;
+
+		/** Reorders the triangles and the vertices of a Mesh with the
+		 * MeshOptimizer, logging the vertex cache statistics of the first
+		 * LOD before and after the optimization
+		 *
+		 * @param	name the name of the Mesh
+		 * @param	positions the coordinates of the vertices of the Mesh
+		 * @param	vertices the packed vertices of the Mesh, they will be
+		 *			reordered
+		 * @param	stride the size in bytes of each packed vertex
+		 * @param	lods the indices of the LODs of the Mesh, they will be
+		 *			reordered */
+		void optimizeMesh(
+			const std::string& name,
+			const std::vector<GLfloat>& positions,
+			std::vector<GLubyte>& vertices, GLuint stride,
+			std::vector<std::vector<GLushort>>& lods
+		) const;
+
+		/** Uploads the data of a Mesh and its LODs to the given
+		 * MeshBufferPool and creates the Mesh
+		 *
+		 * @param	name the name of the Mesh
+		 * @param	pool the MeshBufferPool where the data will be stored
+		 * @param	vertices a pointer to the packed vertices of the Mesh
+		 * @param	numVertices the number of vertices of the Mesh
+		 * @param	lods the indices of the LODs of the Mesh
+		 * @param	bounds the bounds of the Mesh
+		 * @return	a pointer to the new created Mesh */
+		MeshUPtr uploadMesh(
+			const std::string& name, MeshBufferPool& pool,
+			const GLvoid* vertices, unsigned int numVertices,
+			const std::vector<LODView>& lods,
+			const AABB& bounds
+		);
+
+		/** Saves the processed data of a Mesh to a mesh file
+		 *
+		 * @param	path the path of the file
+		 * @param	layout the MeshFileLayout of the vertices
+		 * @param	stride the size in bytes of each packed vertex
+		 * @param	vertices the packed vertices of the Mesh
+		 * @param	numVertices the number of vertices of the Mesh
+		 * @param	lods the indices of the LODs of the Mesh
+		 * @param	screenSizes the screen size of each LOD
+		 * @param	bounds the bounds of the Mesh
+		 * @return	true if the file was saved, false otherwise */
+		static bool writeMeshFile(
+			const std::string& path,
+			MeshFileLayout layout, GLuint stride,
+			const std::vector<GLubyte>& vertices, unsigned int numVertices,
+			const std::vector<std::vector<GLushort>>& lods,
+			const std::vector<float>& screenSizes,
+			const AABB& bounds
+		);
+
+		/** Returns the LODViews of the given LODs
+		 *
+		 * @param	lods the indices of the LODs of a Mesh
+		 * @param	screenSizes the screen size of each LOD
+		 * @return	the LODViews that point to the indices */
+		static std::vector<LODView> getLODViews(
+			const std::vector<std::vector<GLushort>>& lods,
+			const std::vector<float>& screenSizes
+		);
+
+		/** Rounds up the given offset of a mesh file to
+		 * MESH_FILE_ALIGNMENT
+		 *
+		 * @param	offset the offset in bytes
+		 * @return	the aligned offset */
+		static std::uint64_t alignFileOffset(std::uint64_t offset);
 	};
 
 }
@@ -0,0 +1,384 @@
+#include "MeshOptimizer.h"
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace graphics {
+
+	const float MeshOptimizer::CACHE_DECAY_POWER	= 1.5f;
+	const float MeshOptimizer::LAST_TRIANGLE_SCORE	= 0.75f;
+	const float MeshOptimizer::VALENCE_BOOST_SCALE	= 2.0f;
+	const float MeshOptimizer::VALENCE_BOOST_POWER	= 0.5f;
+
+// Public functions
+	std::vector<GLushort> MeshOptimizer::optimizeVertexCache(
+		const std::vector<GLushort>& indices, unsigned int numVertices
+	) const
+	{
+		const unsigned int numTriangles = indices.size() / 3;
+		const unsigned int noTriangle = std::numeric_limits<unsigned int>::max();
+
+		// 1. Store the triangles of each vertex contiguously
+		std::vector<unsigned int> numRemaining(numVertices, 0);
+		for (unsigned int i = 0; i < 3 * numTriangles; ++i) {
+			++numRemaining[indices[i]];
+		}
+
+		std::vector<unsigned int> triangleOffsets(numVertices + 1, 0);
+		for (unsigned int i = 0; i < numVertices; ++i) {
+			triangleOffsets[i + 1] = triangleOffsets[i] + numRemaining[i];
+		}
+
+		std::vector<unsigned int> vertexTriangles(3 * numTriangles);
+		std::vector<unsigned int> cursors(triangleOffsets.begin(), triangleOffsets.end() - 1);
+		for (unsigned int i = 0; i < 3 * numTriangles; ++i) {
+			vertexTriangles[cursors[indices[i]]++] = i / 3;
+		}
+
+		// 2. Calculate the initial scores
+		std::vector<int> cachePositions(numVertices, -1);
+		std::vector<float> vertexScores(numVertices);
+		for (unsigned int i = 0; i < numVertices; ++i) {
+			vertexScores[i] = calculateVertexScore(-1, numRemaining[i]);
+		}
+
+		std::vector<float> triangleScores(numTriangles);
+		std::vector<bool> addedTriangles(numTriangles, false);
+		unsigned int bestTriangle = noTriangle;
+		float bestScore = -1.0f;
+		for (unsigned int i = 0; i < numTriangles; ++i) {
+			triangleScores[i] = vertexScores[indices[3*i]] + vertexScores[indices[3*i + 1]] + vertexScores[indices[3*i + 2]];
+			if (triangleScores[i] > bestScore) {
+				bestTriangle = i;
+				bestScore = triangleScores[i];
+			}
+		}
+
+		// 3. Add the triangle with the highest score until there are no
+		// triangles left
+		std::vector<GLushort> output;
+		output.reserve(3 * numTriangles);
+
+		std::vector<unsigned int> cache, newCache;
+		cache.reserve(SCORE_CACHE_SIZE + 3);
+		newCache.reserve(SCORE_CACHE_SIZE + 3);
+
+		unsigned int nextTriangle = 0;
+		for (unsigned int n = 0; n < numTriangles; ++n) {
+			// If none of the triangles of the cached vertices is left, take
+			// the next one in the input order
+			if (bestTriangle == noTriangle) {
+				while (addedTriangles[nextTriangle]) {
+					++nextTriangle;
+				}
+				bestTriangle = nextTriangle;
+			}
+
+			const GLushort* triangle = &indices[3 * bestTriangle];
+			output.insert(output.end(), triangle, triangle + 3);
+			addedTriangles[bestTriangle] = true;
+
+			// Remove the triangle from its vertices
+			for (unsigned int i = 0; i < 3; ++i) {
+				unsigned int* first = &vertexTriangles[triangleOffsets[triangle[i]]];
+				unsigned int* last = first + numRemaining[triangle[i]];
+				std::iter_swap(std::find(first, last, bestTriangle), last - 1);
+				--numRemaining[triangle[i]];
+			}
+
+			// Move the vertices of the triangle to the front of the cache
+			newCache.assign(triangle, triangle + 3);
+			for (unsigned int vertex : cache) {
+				if ((vertex != triangle[0]) && (vertex != triangle[1]) && (vertex != triangle[2])) {
+					newCache.push_back(vertex);
+				}
+			}
+
+			// Update the scores of the cached vertices, including the ones
+			// that have been evicted
+			for (unsigned int i = 0; i < newCache.size(); ++i) {
+				unsigned int vertex = newCache[i];
+				cachePositions[vertex] = (i < SCORE_CACHE_SIZE)? static_cast<int>(i) : -1;
+				vertexScores[vertex] = calculateVertexScore(cachePositions[vertex], numRemaining[vertex]);
+			}
+
+			// Update the scores of their triangles and select the next one
+			bestTriangle = noTriangle;
+			bestScore = -1.0f;
+			for (unsigned int i = 0; i < newCache.size(); ++i) {
+				unsigned int vertex = newCache[i];
+				for (unsigned int j = 0; j < numRemaining[vertex]; ++j) {
+					unsigned int iTriangle = vertexTriangles[triangleOffsets[vertex] + j];
+					const GLushort* t = &indices[3 * iTriangle];
+					triangleScores[iTriangle] = vertexScores[t[0]] + vertexScores[t[1]] + vertexScores[t[2]];
+
+					if ((i < SCORE_CACHE_SIZE) && (triangleScores[iTriangle] > bestScore)) {
+						bestTriangle = iTriangle;
+						bestScore = triangleScores[iTriangle];
+					}
+				}
+			}
+
+			if (newCache.size() > SCORE_CACHE_SIZE) {
+				newCache.resize(SCORE_CACHE_SIZE);
+			}
+			std::swap(cache, newCache);
+		}
+
+		return output;
+	}
+
+
+	std::vector<GLushort> MeshOptimizer::optimizeOverdraw(
+		const std::vector<GLushort>& indices,
+		const std::vector<GLfloat>& positions,
+		float threshold
+	) const
+	{
+		const unsigned int numTriangles = indices.size() / 3;
+		const unsigned int numVertices = positions.size() / 3;
+
+		std::vector<unsigned int> timestamps(numVertices, 0);
+		unsigned int time = 0;
+
+		// 1. Split the triangles where all the vertices of a triangle miss
+		// the cache, so the clusters can be reordered without
+		// changing the ACMR
+		std::vector<unsigned int> misses(numTriangles);
+		countCacheMisses(indices, 0, numTriangles, timestamps, time, misses.data());
+
+		std::vector<unsigned int> hardBoundaries;
+		for (unsigned int i = 0; i < numTriangles; ++i) {
+			if ((i == 0) || (misses[i] == 3)) {
+				hardBoundaries.push_back(i);
+			}
+		}
+		hardBoundaries.push_back(numTriangles);
+
+		// 2. Split the clusters further at the triangles where their ACMR
+		// so far doesn't exceed the threshold
+		std::vector<unsigned int> boundaries;
+		for (unsigned int i = 0; i + 1 < hardBoundaries.size(); ++i) {
+			unsigned int first = hardBoundaries[i], last = hardBoundaries[i + 1];
+			float clusterACMR = countCacheMisses(indices, first, last, timestamps, time, nullptr) / static_cast<float>(last - first);
+
+			// The cache is simulated one triangle at a time, so it can be
+			// restarted at each new cluster without processing the rest
+			// of the hard cluster again
+			unsigned int start = first, clusterMisses = 0;
+			boundaries.push_back(start);
+			time += mCacheSize + 1;
+			for (unsigned int j = first; j + 1 < last; ++j) {
+				clusterMisses += countTriangleMisses(indices, j, timestamps, time);
+				if (clusterMisses <= threshold * clusterACMR * (j + 1 - start)) {
+					start = j + 1;
+					boundaries.push_back(start);
+
+					// The cache is restarted at the new cluster
+					clusterMisses = 0;
+					time += mCacheSize + 1;
+				}
+			}
+		}
+		boundaries.push_back(numTriangles);
+
+		// 3. Calculate the centroid and the area weighted normal of each
+		// cluster
+		struct Cluster
+		{
+			unsigned int mFirst, mLast;
+			glm::vec3 mCentroid, mNormal;
+			float mArea, mSortKey;
+		};
+
+		std::vector<Cluster> clusters(boundaries.size() - 1);
+		glm::vec3 meshCentroid(0.0f);
+		float meshArea = 0.0f;
+		for (unsigned int i = 0; i < clusters.size(); ++i) {
+			Cluster& cluster = clusters[i];
+			cluster = { boundaries[i], boundaries[i + 1], glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 0.0f };
+
+			for (unsigned int j = cluster.mFirst; j < cluster.mLast; ++j) {
+				glm::vec3 v0 = glm::vec3(positions[3*indices[3*j]], positions[3*indices[3*j] + 1], positions[3*indices[3*j] + 2]);
+				glm::vec3 v1 = glm::vec3(positions[3*indices[3*j + 1]], positions[3*indices[3*j + 1] + 1], positions[3*indices[3*j + 1] + 2]);
+				glm::vec3 v2 = glm::vec3(positions[3*indices[3*j + 2]], positions[3*indices[3*j + 2] + 1], positions[3*indices[3*j + 2] + 2]);
+
+				// The length of the cross product is twice the area
+				glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+				float area = 0.5f * glm::length(normal);
+
+				cluster.mCentroid += area * (v0 + v1 + v2) / 3.0f;
+				cluster.mNormal += normal;
+				cluster.mArea += area;
+			}
+
+			meshCentroid += cluster.mCentroid;
+			meshArea += cluster.mArea;
+			if (cluster.mArea > 0.0f) {
+				cluster.mCentroid /= cluster.mArea;
+			}
+		}
+
+		if (meshArea > 0.0f) {
+			meshCentroid /= meshArea;
+		}
+
+		// 4. Draw first the clusters that are further from the centroid in
+		// the direction of their normals, they are the ones that are more
+		// likely to occlude the others
+		for (Cluster& cluster : clusters) {
+			float normalLength = glm::length(cluster.mNormal);
+			if (normalLength > 0.0f) {
+				cluster.mSortKey = glm::dot(cluster.mCentroid - meshCentroid, cluster.mNormal / normalLength);
+			}
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& c1, const Cluster& c2) {
+			return c1.mSortKey > c2.mSortKey;
+		});
+
+		std::vector<GLushort> output;
+		output.reserve(indices.size());
+		for (const Cluster& cluster : clusters) {
+			output.insert(output.end(), indices.begin() + 3 * cluster.mFirst, indices.begin() + 3 * cluster.mLast);
+		}
+
+		return output;
+	}
+
+
+	std::vector<unsigned int> MeshOptimizer::optimizeVertexFetch(
+		std::vector<GLushort>& indices, unsigned int numVertices
+	) const
+	{
+		const unsigned int noVertex = std::numeric_limits<unsigned int>::max();
+
+		std::vector<unsigned int> remap(numVertices, noVertex);
+		unsigned int nextVertex = 0;
+		for (GLushort& index : indices) {
+			if (remap[index] == noVertex) {
+				remap[index] = nextVertex++;
+			}
+			index = static_cast<GLushort>(remap[index]);
+		}
+
+		for (unsigned int& newIndex : remap) {
+			if (newIndex == noVertex) {
+				newIndex = nextVertex++;
+			}
+		}
+
+		return remap;
+	}
+
+
+	void MeshOptimizer::remapVertices(
+		std::vector<GLubyte>& vertices, unsigned int stride,
+		const std::vector<unsigned int>& remap
+	) {
+		std::vector<GLubyte> output(vertices.size());
+		for (unsigned int i = 0; i < remap.size(); ++i) {
+			std::memcpy(&output[remap[i] * stride], &vertices[i * stride], stride);
+		}
+
+		vertices = std::move(output);
+	}
+
+
+	MeshOptimizer::Statistics MeshOptimizer::analyzeVertexCache(
+		const std::vector<GLushort>& indices, unsigned int numVertices
+	) const
+	{
+		const unsigned int numTriangles = indices.size() / 3;
+
+		std::vector<unsigned int> timestamps(numVertices, 0);
+		unsigned int time = 0;
+		unsigned int numMisses = countCacheMisses(indices, 0, numTriangles, timestamps, time, nullptr);
+
+		std::vector<bool> usedVertices(numVertices, false);
+		unsigned int numUsedVertices = 0;
+		for (GLushort index : indices) {
+			if (!usedVertices[index]) {
+				usedVertices[index] = true;
+				++numUsedVertices;
+			}
+		}
+
+		return {
+			(numTriangles > 0)? numMisses / static_cast<float>(numTriangles) : 0.0f,
+			(numUsedVertices > 0)? numMisses / static_cast<float>(numUsedVertices) : 0.0f
+		};
+	}
+
+// Private functions
+	float MeshOptimizer::calculateVertexScore(int cachePosition, unsigned int numRemaining)
+	{
+		if (numRemaining == 0) {
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0) {
+			if (cachePosition < 3) {
+				// The vertices of the last triangle get a fixed score, so
+				// the strips aren't favoured over the fans
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else {
+				float scale = 1.0f / (SCORE_CACHE_SIZE - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scale, CACHE_DECAY_POWER);
+			}
+		}
+
+		// Boost the vertices with few triangles left, so they are removed
+		// before they become isolated
+		score += VALENCE_BOOST_SCALE * std::pow(static_cast<float>(numRemaining), -VALENCE_BOOST_POWER);
+		return score;
+	}
+
+
+	unsigned int MeshOptimizer::countCacheMisses(
+		const std::vector<GLushort>& indices,
+		unsigned int first, unsigned int last,
+		std::vector<unsigned int>& timestamps, unsigned int& time,
+		unsigned int* missesPerTriangle
+	) const
+	{
+		// Advancing the time by the cache size evicts all the vertices
+		time += mCacheSize + 1;
+
+		unsigned int numMisses = 0;
+		for (unsigned int i = first; i < last; ++i) {
+			unsigned int triangleMisses = countTriangleMisses(indices, i, timestamps, time);
+			if (missesPerTriangle) {
+				missesPerTriangle[i - first] = triangleMisses;
+			}
+			numMisses += triangleMisses;
+		}
+
+		return numMisses;
+	}
+
+
+	unsigned int MeshOptimizer::countTriangleMisses(
+		const std::vector<GLushort>& indices, unsigned int iTriangle,
+		std::vector<unsigned int>& timestamps, unsigned int& time
+	) const
+	{
+		// A vertex is in the FIFO cache if less than mCacheSize vertices
+		// have been added since it was added
+		unsigned int numMisses = 0;
+		for (unsigned int i = 0; i < 3; ++i) {
+			GLushort index = indices[3*iTriangle + i];
+			if (time - timestamps[index] > mCacheSize) {
+				timestamps[index] = time++;
+				++numMisses;
+			}
+		}
+
+		return numMisses;
+	}
+
+}
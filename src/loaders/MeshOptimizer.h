@@ -0,0 +1,169 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include <GL/glew.h>
+
+namespace graphics {
+
+	/**
+	 * Class MeshOptimizer, it reorders the triangles and vertices of the
+	 * Meshes before they are uploaded, so the GPU transforms and fetches
+	 * less vertices and shades less hidden fragments:
+	 * <br>- optimizeVertexCache: reorders the triangles with the Forsyth
+	 * algorithm, so the vertices are reused from the post-transform cache
+	 * <br>- optimizeOverdraw: splits the triangles in clusters at the
+	 * points where the cache is restarted anyway, and sorts the clusters
+	 * so the ones that face outwards are drawn first
+	 * <br>- optimizeVertexFetch: reorders the vertices in the order in
+	 * which they are used, so they are read sequentially from memory
+	 * <br>The results are measured with a simulated FIFO cache as the
+	 * ACMR (average cache miss ratio, transformed vertices per triangle)
+	 * and the ATVR (average transform to vertex ratio, transformed
+	 * vertices per vertex, 1 is the optimum)
+	 */
+	class MeshOptimizer
+	{
+	public:		// Nested types
+		/** Struct Statistics, it holds the vertex cache efficiency of
+		 * some indices */
+		struct Statistics
+		{
+			/** The average number of vertices transformed per triangle */
+			float mACMR;
+
+			/** The average number of times that each vertex is
+			 * transformed */
+			float mATVR;
+		};
+
+	private:	// Attributes
+		/** The size of the LRU cache used for scoring the vertices */
+		static const unsigned int SCORE_CACHE_SIZE = 32;
+
+		/** The parameters of the vertex scores */
+		static const float CACHE_DECAY_POWER;
+		static const float LAST_TRIANGLE_SCORE;
+		static const float VALENCE_BOOST_SCALE;
+		static const float VALENCE_BOOST_POWER;
+
+		/** The size of the simulated FIFO cache */
+		unsigned int mCacheSize;
+
+	public:		// Functions
+		/** Creates a new MeshOptimizer
+		 *
+		 * @param	cacheSize the number of vertices of the simulated
+		 *			post-transform FIFO cache */
+		MeshOptimizer(unsigned int cacheSize = 16) : mCacheSize(cacheSize) {};
+
+		/** Class destructor */
+		~MeshOptimizer() {};
+
+		/** Reorders the triangles of a Mesh for the post-transform vertex
+		 * cache
+		 *
+		 * @param	indices the indices of the triangles of the Mesh
+		 * @param	numVertices the number of vertices of the Mesh
+		 * @return	the reordered indices */
+		std::vector<GLushort> optimizeVertexCache(
+			const std::vector<GLushort>& indices, unsigned int numVertices
+		) const;
+
+		/** Reorders the clusters of triangles of a Mesh for reducing the
+		 * overdraw, it should be called after optimizeVertexCache
+		 *
+		 * @param	indices the indices of the triangles of the Mesh
+		 * @param	positions the positions of the vertices of the Mesh
+		 * @param	threshold the maximum ACMR degradation allowed when
+		 *			splitting the clusters, relative to the ACMR of the
+		 *			unsplitted ones
+		 * @return	the reordered indices */
+		std::vector<GLushort> optimizeOverdraw(
+			const std::vector<GLushort>& indices,
+			const std::vector<GLfloat>& positions,
+			float threshold = 1.05f
+		) const;
+
+		/** Reorders the vertices of a Mesh in the order in which they are
+		 * first used by its triangles, the unused vertices are moved to
+		 * the end
+		 *
+		 * @param	indices the indices of the triangles of the Mesh, they
+		 *			will be updated to the new vertex order
+		 * @param	numVertices the number of vertices of the Mesh
+		 * @return	the new index of each vertex */
+		std::vector<unsigned int> optimizeVertexFetch(
+			std::vector<GLushort>& indices, unsigned int numVertices
+		) const;
+
+		/** Moves the given vertices to the positions returned by
+		 * optimizeVertexFetch
+		 *
+		 * @param	vertices the interleaved vertices to reorder
+		 * @param	stride the size in bytes of each vertex
+		 * @param	remap the new index of each vertex */
+		static void remapVertices(
+			std::vector<GLubyte>& vertices, unsigned int stride,
+			const std::vector<unsigned int>& remap
+		);
+
+		/** Simulates the FIFO vertex cache with the given indices
+		 *
+		 * @param	indices the indices of the triangles of a Mesh
+		 * @param	numVertices the number of vertices of the Mesh
+		 * @return	the cache efficiency of the indices */
+		Statistics analyzeVertexCache(
+			const std::vector<GLushort>& indices, unsigned int numVertices
+		) const;
+	private:
+		/** Calculates the score of a vertex for the Forsyth algorithm
+		 *
+		 * @param	cachePosition the position of the vertex in the LRU
+		 *			cache, -1 if it isn't in the cache
+		 * @param	numRemaining the number of triangles of the vertex that
+		 *			haven't been added yet
+		 * @return	the score of the vertex */
+		static float calculateVertexScore(int cachePosition, unsigned int numRemaining);
+
+		/** Counts the FIFO cache misses of the given triangles, starting
+		 * with an empty cache
+		 *
+		 * @param	indices the indices of the triangles of a Mesh
+		 * @param	first the index of the first triangle
+		 * @param	last the index after the last triangle
+		 * @param	timestamps the scratch timestamps of each vertex, they
+		 *			must be smaller or equal than time
+		 * @param	time the current time of the cache, it will be
+		 *			advanced
+		 * @param	missesPerTriangle if it isn't nullptr, the number of
+		 *			misses of each triangle will be stored in it,
+		 *			starting at the first triangle
+		 * @return	the number of cache misses */
+		unsigned int countCacheMisses(
+			const std::vector<GLushort>& indices,
+			unsigned int first, unsigned int last,
+			std::vector<unsigned int>& timestamps, unsigned int& time,
+			unsigned int* missesPerTriangle
+		) const;
+
+		/** Simulates the FIFO vertex cache for a single triangle, without
+		 * restarting it
+		 *
+		 * @param	indices the indices of the triangles of a Mesh
+		 * @param	iTriangle the index of the triangle
+		 * @param	timestamps the scratch timestamps of each vertex, they
+		 *			must be smaller or equal than time
+		 * @param	time the current time of the cache, it will be
+		 *			advanced, adding mCacheSize + 1 to it restarts the
+		 *			cache
+		 * @return	the number of cache misses of the triangle */
+		unsigned int countTriangleMisses(
+			const std::vector<GLushort>& indices, unsigned int iTriangle,
+			std::vector<unsigned int>& timestamps, unsigned int& time
+		) const;
+	};
+
+}
+
+#endif		// MESH_OPTIMIZER_H
@@ -0,0 +1,242 @@
+#include "MeshSimplifier.h"
+#include <cmath>
+#include <queue>
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+
+namespace graphics {
+
+// Public functions
+	std::vector<GLushort> MeshSimplifier::simplify(
+		const std::vector<GLushort>& indices,
+		const std::vector<GLfloat>& positions,
+		unsigned int targetIndexCount, float& error
+	) const
+	{
+		const unsigned int numVertices = positions.size() / 3;
+		const unsigned int numTriangles = indices.size() / 3;
+
+		// 1. Add the quadric of the plane of each triangle to its vertices
+		std::vector<GLushort> current(indices.begin(), indices.begin() + 3 * numTriangles);
+		std::vector<Quadric> quadrics(numVertices, Quadric());
+		std::vector<std::vector<unsigned int>> vertexTriangles(numVertices);
+		for (unsigned int i = 0; i < numTriangles; ++i) {
+			glm::vec3 v0 = getPosition(positions, current[3*i]);
+			glm::vec3 v1 = getPosition(positions, current[3*i + 1]);
+			glm::vec3 v2 = getPosition(positions, current[3*i + 2]);
+
+			glm::dvec3 normal(glm::cross(v1 - v0, v2 - v0));
+			double length = glm::length(normal);
+			if (length > 0.0) {
+				normal /= length;
+				double d = -glm::dot(normal, glm::dvec3(v0));
+
+				Quadric plane = { {
+					normal.x * normal.x, normal.x * normal.y, normal.x * normal.z, normal.x * d,
+					normal.y * normal.y, normal.y * normal.z, normal.y * d,
+					normal.z * normal.z, normal.z * d,
+					d * d
+				} };
+				for (unsigned int j = 0; j < 3; ++j) {
+					quadrics[current[3*i + j]] += plane;
+				}
+			}
+
+			for (unsigned int j = 0; j < 3; ++j) {
+				vertexTriangles[current[3*i + j]].push_back(i);
+			}
+		}
+
+		// 2. Add the collapse candidates of all the edges
+		std::vector<bool> lockedVertices = findLockedVertices(current, positions);
+		std::vector<bool> removedVertices(numVertices, false);
+		std::vector<bool> aliveTriangles(numTriangles, true);
+
+		auto calculateError = [&](unsigned int from, unsigned int to) {
+			Quadric quadric = quadrics[from];
+			quadric += quadrics[to];
+			return quadric.evaluate(&positions[3 * to]);
+		};
+
+		std::priority_queue<Collapse> collapses;
+		auto addCollapses = [&](unsigned int vertex) {
+			for (unsigned int iTriangle : vertexTriangles[vertex]) {
+				if (!aliveTriangles[iTriangle]) continue;
+
+				for (unsigned int j = 0; j < 3; ++j) {
+					unsigned int other = current[3*iTriangle + j];
+					if (other == vertex) continue;
+
+					if (!lockedVertices[vertex]) {
+						collapses.push({ calculateError(vertex, other), vertex, other });
+					}
+					if (!lockedVertices[other]) {
+						collapses.push({ calculateError(other, vertex), other, vertex });
+					}
+				}
+			}
+		};
+
+		for (unsigned int i = 0; i < numVertices; ++i) {
+			if (!lockedVertices[i]) {
+				addCollapses(i);
+			}
+		}
+
+		// 3. Collapse the cheapest edges until the target is reached
+		unsigned int indexCount = 3 * numTriangles;
+		double maxError = 0.0;
+		while ((indexCount > targetIndexCount) && !collapses.empty()) {
+			Collapse collapse = collapses.top();
+			collapses.pop();
+
+			if (removedVertices[collapse.mFrom] || removedVertices[collapse.mTo]) {
+				continue;
+			}
+
+			// The quadrics only grow, so if the error has changed the
+			// candidate is reinserted with the new one
+			double collapseError = calculateError(collapse.mFrom, collapse.mTo);
+			if (collapseError > collapse.mError) {
+				collapses.push({ collapseError, collapse.mFrom, collapse.mTo });
+				continue;
+			}
+
+			const std::vector<unsigned int>& fromTriangles = vertexTriangles[collapse.mFrom];
+			bool adjacent = std::any_of(fromTriangles.begin(), fromTriangles.end(), [&](unsigned int iTriangle) {
+				return aliveTriangles[iTriangle]
+					&& ((current[3*iTriangle] == collapse.mTo) || (current[3*iTriangle + 1] == collapse.mTo) || (current[3*iTriangle + 2] == collapse.mTo));
+			});
+			if (!adjacent || !isValidCollapse(current, positions, fromTriangles, aliveTriangles, collapse.mFrom, collapse.mTo)) {
+				continue;
+			}
+
+			// Remove the triangles of the edge and move the other ones to
+			// the remaining vertex
+			for (unsigned int iTriangle : fromTriangles) {
+				if (!aliveTriangles[iTriangle]) continue;
+
+				GLushort* triangle = &current[3 * iTriangle];
+				if ((triangle[0] == collapse.mTo) || (triangle[1] == collapse.mTo) || (triangle[2] == collapse.mTo)) {
+					aliveTriangles[iTriangle] = false;
+					indexCount -= 3;
+				}
+				else {
+					std::replace(triangle, triangle + 3, static_cast<GLushort>(collapse.mFrom), static_cast<GLushort>(collapse.mTo));
+					vertexTriangles[collapse.mTo].push_back(iTriangle);
+				}
+			}
+
+			quadrics[collapse.mTo] += quadrics[collapse.mFrom];
+			removedVertices[collapse.mFrom] = true;
+			vertexTriangles[collapse.mFrom].clear();
+			maxError = std::max(maxError, collapseError);
+
+			addCollapses(collapse.mTo);
+		}
+
+		// 4. Keep the remaining triangles in their original order
+		std::vector<GLushort> output;
+		output.reserve(indexCount);
+		for (unsigned int i = 0; i < numTriangles; ++i) {
+			if (aliveTriangles[i]) {
+				output.insert(output.end(), &current[3*i], &current[3*i] + 3);
+			}
+		}
+
+		error = static_cast<float>(std::sqrt(maxError));
+		return output;
+	}
+
+// Private functions
+	std::vector<bool> MeshSimplifier::findLockedVertices(
+		const std::vector<GLushort>& indices,
+		const std::vector<GLfloat>& positions
+	) {
+		const unsigned int numVertices = positions.size() / 3;
+		std::vector<bool> lockedVertices(numVertices, false);
+
+		// Lock the vertices of the edges that don't have exactly two
+		// triangles
+		std::unordered_map<std::uint32_t, unsigned int> edgeCounts;
+		for (unsigned int i = 0; i + 2 < indices.size(); i += 3) {
+			for (unsigned int j = 0; j < 3; ++j) {
+				std::uint32_t v0 = indices[i + j], v1 = indices[i + (j + 1) % 3];
+				++edgeCounts[(std::min(v0, v1) << 16) | std::max(v0, v1)];
+			}
+		}
+
+		for (const auto& pair : edgeCounts) {
+			if (pair.second != 2) {
+				lockedVertices[pair.first >> 16] = true;
+				lockedVertices[pair.first & 0xFFFF] = true;
+			}
+		}
+
+		// Lock the vertices with the same position
+		std::vector<unsigned int> sortedVertices(numVertices);
+		for (unsigned int i = 0; i < numVertices; ++i) {
+			sortedVertices[i] = i;
+		}
+
+		auto less = [&](unsigned int v0, unsigned int v1) {
+			return std::lexicographical_compare(
+				&positions[3*v0], &positions[3*v0] + 3,
+				&positions[3*v1], &positions[3*v1] + 3
+			);
+		};
+		std::sort(sortedVertices.begin(), sortedVertices.end(), less);
+
+		for (unsigned int i = 1; i < numVertices; ++i) {
+			unsigned int v0 = sortedVertices[i - 1], v1 = sortedVertices[i];
+			if (!less(v0, v1)) {
+				lockedVertices[v0] = true;
+				lockedVertices[v1] = true;
+			}
+		}
+
+		return lockedVertices;
+	}
+
+
+	glm::vec3 MeshSimplifier::getPosition(const std::vector<GLfloat>& positions, unsigned int vertex)
+	{
+		return glm::vec3(positions[3*vertex], positions[3*vertex + 1], positions[3*vertex + 2]);
+	}
+
+
+	bool MeshSimplifier::isValidCollapse(
+		const std::vector<GLushort>& indices,
+		const std::vector<GLfloat>& positions,
+		const std::vector<unsigned int>& triangles,
+		const std::vector<bool>& aliveTriangles,
+		unsigned int from, unsigned int to
+	) {
+		glm::vec3 destination = getPosition(positions, to);
+
+		for (unsigned int iTriangle : triangles) {
+			if (!aliveTriangles[iTriangle]) continue;
+
+			const GLushort* triangle = &indices[3 * iTriangle];
+			if ((triangle[0] == to) || (triangle[1] == to) || (triangle[2] == to)) {
+				continue;
+			}
+
+			glm::vec3 v[3], moved[3];
+			for (unsigned int j = 0; j < 3; ++j) {
+				v[j] = getPosition(positions, triangle[j]);
+				moved[j] = (triangle[j] == from)? destination : v[j];
+			}
+
+			glm::vec3 normal = glm::cross(v[1] - v[0], v[2] - v[0]);
+			glm::vec3 movedNormal = glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+			if (glm::dot(normal, movedNormal) <= 0.0f) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+}
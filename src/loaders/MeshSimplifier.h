@@ -0,0 +1,135 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+namespace graphics {
+
+	/**
+	 * Class MeshSimplifier, it reduces the number of triangles of a Mesh
+	 * with the quadric error metric. Each vertex accumulates the
+	 * quadrics of the planes of its triangles, and the edges are
+	 * collapsed from the cheapest to the most expensive one.
+	 * <br>The edges are collapsed to one of their vertices instead of to a
+	 * new position, so the simplified triangles reference the same
+	 * vertices as the original ones and can share their vertex data. The
+	 * vertices of the borders of the Mesh and the ones that share their
+	 * position with other vertices (UV or normal seams) are never removed,
+	 * so the simplification doesn't open cracks
+	 */
+	class MeshSimplifier
+	{
+	private:	// Nested types
+		/** Struct Quadric, it holds the symmetric 4x4 matrix of the sum of
+		 * the squared distances to some planes */
+		struct Quadric
+		{
+			/** The upper triangle of the matrix */
+			double m[10];
+
+			/** Adds the given Quadric to the current one */
+			Quadric& operator+=(const Quadric& other)
+			{
+				for (unsigned int i = 0; i < 10; ++i) {
+					m[i] += other.m[i];
+				}
+				return *this;
+			};
+
+			/** Returns the sum of the squared distances from the given
+			 * point to the planes of the Quadric */
+			double evaluate(const GLfloat* point) const
+			{
+				double x = point[0], y = point[1], z = point[2];
+				return m[0]*x*x + 2.0*m[1]*x*y + 2.0*m[2]*x*z + 2.0*m[3]*x
+					+ m[4]*y*y + 2.0*m[5]*y*z + 2.0*m[6]*y
+					+ m[7]*z*z + 2.0*m[8]*z
+					+ m[9];
+			};
+		};
+
+		/** Struct Collapse, it holds an edge collapse candidate */
+		struct Collapse
+		{
+			/** The error of collapsing the edge */
+			double mError;
+
+			/** The vertex that will be removed */
+			unsigned int mFrom;
+
+			/** The vertex where the removed one will be moved */
+			unsigned int mTo;
+
+			/** Sorts the Collapses so the cheapest one is at the top of
+			 * the heap */
+			bool operator<(const Collapse& other) const
+			{ return mError > other.mError; };
+		};
+
+	public:		// Functions
+		/** Creates a new MeshSimplifier */
+		MeshSimplifier() {};
+
+		/** Class destructor */
+		~MeshSimplifier() {};
+
+		/** Simplifies the given triangles until they have the target number
+		 * of indices or there are no more edges that can be collapsed
+		 *
+		 * @param	indices the indices of the triangles of the Mesh
+		 * @param	positions the positions of the vertices of the Mesh
+		 * @param	targetIndexCount the number of indices to reach
+		 * @param	error where the geometric error of the simplified
+		 *			triangles will be stored, in the same units than the
+		 *			positions
+		 * @return	the indices of the simplified triangles, they reference
+		 *			the same vertices than the original ones */
+		std::vector<GLushort> simplify(
+			const std::vector<GLushort>& indices,
+			const std::vector<GLfloat>& positions,
+			unsigned int targetIndexCount, float& error
+		) const;
+	private:
+		/** Returns the vertices that can't be removed, the ones of the
+		 * border and non manifold edges and the ones that share their
+		 * position with other vertices
+		 *
+		 * @param	indices the indices of the triangles of the Mesh
+		 * @param	positions the positions of the vertices of the Mesh
+		 * @return	true for each vertex that can't be removed */
+		static std::vector<bool> findLockedVertices(
+			const std::vector<GLushort>& indices,
+			const std::vector<GLfloat>& positions
+		);
+
+		/** Returns the position of the given vertex
+		 *
+		 * @param	positions the positions of the vertices of the Mesh
+		 * @param	vertex the index of the vertex
+		 * @return	the position of the vertex */
+		static glm::vec3 getPosition(const std::vector<GLfloat>& positions, unsigned int vertex);
+
+		/** Checks if collapsing the given edge flips or degenerates any of
+		 * the triangles of the removed vertex
+		 *
+		 * @param	indices the current indices of the triangles
+		 * @param	positions the positions of the vertices
+		 * @param	triangles the triangles of the removed vertex
+		 * @param	aliveTriangles if each triangle hasn't been removed yet
+		 * @param	from the vertex to remove
+		 * @param	to the vertex where the removed one will be moved
+		 * @return	true if the collapse is valid, false otherwise */
+		static bool isValidCollapse(
+			const std::vector<GLushort>& indices,
+			const std::vector<GLfloat>& positions,
+			const std::vector<unsigned int>& triangles,
+			const std::vector<bool>& aliveTriangles,
+			unsigned int from, unsigned int to
+		);
+	};
+
+}
+
+#endif		// MESH_SIMPLIFIER_H
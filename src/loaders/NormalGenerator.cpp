@@ -0,0 +1,223 @@
+#include "NormalGenerator.h"
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "../utils/JobSystem.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+	#define NORMAL_GENERATOR_USE_SSE
+	#include <xmmintrin.h>
+#endif
+
+namespace graphics {
+
+// Public functions
+	std::vector<GLfloat> NormalGenerator::calculateNormals(
+		const std::vector<GLfloat>& positions,
+		const std::vector<GLushort>& faceIndices,
+		NormalWeight weight
+	) const
+	{
+		const unsigned int numVertices = positions.size() / 3;
+		const unsigned int numTriangles = faceIndices.size() / 3;
+		const unsigned int numChunks = getNumChunks(numTriangles);
+
+		// 1. Add the normal of each face to its vertices, each Job
+		// accumulates a range of faces in its own buffer so there are no
+		// write conflicts. The length of the cross product is
+		// proportional to the area of the face
+		std::vector<GLfloat> normals(3 * numVertices, 0.0f);
+		std::vector<std::vector<GLfloat>> chunkNormals(numChunks - 1, std::vector<GLfloat>(3 * numVertices, 0.0f));
+		mJobSystem.parallelFor(0, numChunks, 1, [&](unsigned int first, unsigned int last) {
+			for (unsigned int iChunk = first; iChunk < last; ++iChunk) {
+				GLfloat* sums = (iChunk == 0)? normals.data() : chunkNormals[iChunk - 1].data();
+				unsigned int chunkEnd = getChunkBegin(iChunk + 1, numChunks, numTriangles);
+
+				// The vertices are kept in locals instead of arrays so
+				// the compiler can keep them in registers
+				for (unsigned int i = getChunkBegin(iChunk, numChunks, numTriangles); i < chunkEnd; ++i) {
+					const GLushort i0 = faceIndices[3*i], i1 = faceIndices[3*i + 1], i2 = faceIndices[3*i + 2];
+					const glm::vec3 v0 = getVector(positions.data(), i0);
+					const glm::vec3 v1 = getVector(positions.data(), i1);
+					const glm::vec3 v2 = getVector(positions.data(), i2);
+
+					glm::vec3 normal = glm::cross(v1 - v0, v2 - v0);
+					if (weight == AREA_WEIGHT) {
+						addVector(sums, i0, normal);
+						addVector(sums, i1, normal);
+						addVector(sums, i2, normal);
+					}
+					else {
+						float length = glm::length(normal);
+						normal = (length > 0.0f)? normal / length : glm::vec3(0.0f);
+
+						addVector(sums, i0, getAngle(v1 - v0, v2 - v0) * normal);
+						addVector(sums, i1, getAngle(v2 - v1, v0 - v1) * normal);
+						addVector(sums, i2, getAngle(v0 - v2, v1 - v2) * normal);
+					}
+				}
+			}
+		});
+
+		// 2. Merge the buffers and normalize the normals, each Job
+		// processes a range of vertices
+		mJobSystem.parallelFor(0, numVertices, VERTICES_PER_JOB, [&](unsigned int first, unsigned int last) {
+			const unsigned int count = last - first;
+			std::vector<GLfloat> x(count), y(count), z(count);
+
+			for (unsigned int i = 0; i < count; ++i) {
+				glm::vec3 normal(normals[3 * (first + i)], normals[3 * (first + i) + 1], normals[3 * (first + i) + 2]);
+				for (const std::vector<GLfloat>& sums : chunkNormals) {
+					normal += glm::vec3(sums[3 * (first + i)], sums[3 * (first + i) + 1], sums[3 * (first + i) + 2]);
+				}
+				x[i] = normal.x;	y[i] = normal.y;	z[i] = normal.z;
+			}
+
+			normalize(x.data(), y.data(), z.data(), count);
+
+			for (unsigned int i = 0; i < count; ++i) {
+				normals[3 * (first + i)]		= x[i];
+				normals[3 * (first + i) + 1]	= y[i];
+				normals[3 * (first + i) + 2]	= z[i];
+			}
+		});
+
+		return normals;
+	}
+
+
+	std::vector<GLfloat> NormalGenerator::calculateTangents(
+		const std::vector<GLfloat>& positions,
+		const std::vector<GLfloat>& normals,
+		const std::vector<GLfloat>& uvs,
+		const std::vector<GLushort>& faceIndices
+	) const
+	{
+		const unsigned int numVertices = positions.size() / 3;
+		const unsigned int numTriangles = faceIndices.size() / 3;
+		const unsigned int numChunks = getNumChunks(numTriangles);
+
+		// 1. Add the directions in which the texture coordinates of each
+		// face increase to its vertices, with a buffer per Job. Each
+		// vertex has the sum of its tangents and bitangents
+		std::vector<std::vector<GLfloat>> chunkSums(numChunks, std::vector<GLfloat>(6 * numVertices, 0.0f));
+		mJobSystem.parallelFor(0, numChunks, 1, [&](unsigned int first, unsigned int last) {
+			for (unsigned int iChunk = first; iChunk < last; ++iChunk) {
+				GLfloat* sums = chunkSums[iChunk].data();
+				unsigned int chunkEnd = getChunkBegin(iChunk + 1, numChunks, numTriangles);
+
+				for (unsigned int i = getChunkBegin(iChunk, numChunks, numTriangles); i < chunkEnd; ++i) {
+					const GLushort i0 = faceIndices[3*i], i1 = faceIndices[3*i + 1], i2 = faceIndices[3*i + 2];
+					const glm::vec3 v0 = getVector(positions.data(), i0);
+					const glm::vec2 uv0(uvs[2*i0], uvs[2*i0 + 1]);
+
+					glm::vec3 e1 = getVector(positions.data(), i1) - v0, e2 = getVector(positions.data(), i2) - v0;
+					glm::vec2 d1 = glm::vec2(uvs[2*i1], uvs[2*i1 + 1]) - uv0, d2 = glm::vec2(uvs[2*i2], uvs[2*i2 + 1]) - uv0;
+					float determinant = d1.x * d2.y - d2.x * d1.y;
+					if (determinant == 0.0f) continue;
+
+					float invDeterminant = 1.0f / determinant;
+					glm::vec3 tangent	= (e1 * d2.y - e2 * d1.y) * invDeterminant;
+					glm::vec3 bitangent	= (e2 * d1.x - e1 * d2.x) * invDeterminant;
+					for (GLushort index : { i0, i1, i2 }) {
+						addVector(sums, 2 * index, tangent);
+						addVector(sums, 2 * index + 1, bitangent);
+					}
+				}
+			}
+		});
+
+		// 2. Merge the buffers, orthogonalize the tangents against the
+		// normals and normalize them, each Job processes a range of
+		// vertices
+		std::vector<GLfloat> tangents(4 * numVertices);
+		mJobSystem.parallelFor(0, numVertices, VERTICES_PER_JOB, [&](unsigned int first, unsigned int last) {
+			const unsigned int count = last - first;
+			std::vector<GLfloat> x(count), y(count), z(count);
+
+			for (unsigned int i = 0; i < count; ++i) {
+				glm::vec3 tangent(0.0f), bitangent(0.0f);
+				for (const std::vector<GLfloat>& sums : chunkSums) {
+					const GLfloat* vertexSums = &sums[6 * (first + i)];
+					tangent += glm::vec3(vertexSums[0], vertexSums[1], vertexSums[2]);
+					bitangent += glm::vec3(vertexSums[3], vertexSums[4], vertexSums[5]);
+				}
+
+				const GLfloat* n = &normals[3 * (first + i)];
+				glm::vec3 normal(n[0], n[1], n[2]);
+				tangent -= glm::dot(normal, tangent) * normal;
+				x[i] = tangent.x;	y[i] = tangent.y;	z[i] = tangent.z;
+				tangents[4 * (first + i) + 3] = (glm::dot(glm::cross(normal, tangent), bitangent) < 0.0f)? -1.0f : 1.0f;
+			}
+
+			normalize(x.data(), y.data(), z.data(), count);
+
+			for (unsigned int i = 0; i < count; ++i) {
+				tangents[4 * (first + i)]		= x[i];
+				tangents[4 * (first + i) + 1]	= y[i];
+				tangents[4 * (first + i) + 2]	= z[i];
+			}
+		});
+
+		return tangents;
+	}
+
+// Private functions
+	unsigned int NormalGenerator::getNumChunks(unsigned int numTriangles) const
+	{
+		// There is a chunk for each thread that can run the Jobs, the
+		// workers and the calling one
+		unsigned int numChunks = (numTriangles + TRIANGLES_PER_JOB - 1) / TRIANGLES_PER_JOB;
+		return std::max(1u, std::min(numChunks, mJobSystem.getNumWorkers() + 1));
+	}
+
+
+	unsigned int NormalGenerator::getChunkBegin(
+		unsigned int iChunk, unsigned int numChunks,
+		unsigned int numTriangles
+	) {
+		return static_cast<unsigned int>(static_cast<unsigned long long>(iChunk) * numTriangles / numChunks);
+	}
+
+
+	float NormalGenerator::getAngle(const glm::vec3& e1, const glm::vec3& e2)
+	{
+		float lengths = glm::length(e1) * glm::length(e2);
+		return (lengths > 0.0f)?
+			std::acos(glm::clamp(glm::dot(e1, e2) / lengths, -1.0f, 1.0f)) :
+			0.0f;
+	}
+
+
+	void NormalGenerator::normalize(GLfloat* x, GLfloat* y, GLfloat* z, unsigned int count)
+	{
+		unsigned int i = 0;
+
+#ifdef NORMAL_GENERATOR_USE_SSE
+		const __m128 zero	= _mm_setzero_ps();
+		const __m128 one	= _mm_set1_ps(1.0f);
+		for (; i + 4 <= count; i += 4) {
+			__m128 vx = _mm_loadu_ps(x + i), vy = _mm_loadu_ps(y + i), vz = _mm_loadu_ps(z + i);
+			__m128 length = _mm_sqrt_ps(_mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)),
+				_mm_mul_ps(vz, vz)
+			));
+
+			// The inverse of the zero lengths is masked to zero
+			__m128 invLength = _mm_and_ps(_mm_div_ps(one, length), _mm_cmpgt_ps(length, zero));
+			_mm_storeu_ps(x + i, _mm_mul_ps(vx, invLength));
+			_mm_storeu_ps(y + i, _mm_mul_ps(vy, invLength));
+			_mm_storeu_ps(z + i, _mm_mul_ps(vz, invLength));
+		}
+#endif
+
+		for (; i < count; ++i) {
+			float length = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+			float invLength = (length > 0.0f)? 1.0f / length : 0.0f;
+			x[i] *= invLength;
+			y[i] *= invLength;
+			z[i] *= invLength;
+		}
+	}
+
+}
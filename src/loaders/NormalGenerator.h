@@ -0,0 +1,146 @@
+#ifndef NORMAL_GENERATOR_H
+#define NORMAL_GENERATOR_H
+
+#include <vector>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+class JobSystem;
+
+namespace graphics {
+
+	/**
+	 * Class NormalGenerator, it calculates the normals and tangents of the
+	 * vertices of the Meshes from their faces. It doesn't need a GL
+	 * context, so it can be used from any thread
+	 * <br>The work is done in parallel with the JobSystem: the faces are
+	 * split in a chunk per thread, each one accumulated in its own
+	 * buffers so there are no write conflicts, and then the buffers are
+	 * merged and normalized with SIMD by ranges of vertices
+	 */
+	class NormalGenerator
+	{
+	public:		// Nested types
+		/** The weights of the face normals when they are added to the
+		 * normals of their vertices */
+		enum NormalWeight
+		{
+			AREA_WEIGHT,
+			ANGLE_WEIGHT
+		};
+
+	private:	// Attributes
+		/** The minimum number of triangles and the number of vertices
+		 * processed by each Job */
+		static const unsigned int TRIANGLES_PER_JOB = 8192;
+		static const unsigned int VERTICES_PER_JOB = 4096;
+
+		/** The JobSystem used for calculating the normals and tangents */
+		JobSystem& mJobSystem;
+
+	public:		// Functions
+		/** Creates a new NormalGenerator
+		 *
+		 * @param	jobSystem the JobSystem used for calculating the normals
+		 *			and tangents */
+		NormalGenerator(JobSystem& jobSystem) : mJobSystem(jobSystem) {};
+
+		/** Class destructor */
+		~NormalGenerator() {};
+
+		/** Calculates the Normals of the given vertices
+		 *
+		 * @param	positions a vector with the positions of the vertices
+		 * @param	faceIndices a vector with indices of the vertices that
+		 *			compose the faces of a Mesh
+		 * @param	weight how the normals of the faces are weighted, by
+		 *			their area or by the angle of the face at each vertex
+		 * @return	a vector with the normals of the vertices, the ones of
+		 *			the vertices without faces are zero */
+		std::vector<GLfloat> calculateNormals(
+			const std::vector<GLfloat>& positions,
+			const std::vector<GLushort>& faceIndices,
+			NormalWeight weight = AREA_WEIGHT
+		) const;
+
+		/** Calculates the Tangents of the given vertices from the
+		 * directions in which their texture coordinates increase
+		 *
+		 * @param	positions a vector with the positions of the vertices
+		 * @param	normals a vector with the normals of the vertices
+		 * @param	uvs a vector with the texture coordinates of the
+		 *			vertices
+		 * @param	faceIndices a vector with indices of the vertices that
+		 *			compose the faces of a Mesh
+		 * @return	a vector with the tangents of the vertices, 4 floats
+		 *			per vertex: the tangent orthogonalized against the
+		 *			normal, and the handedness of the bitangent (1 or -1) */
+		std::vector<GLfloat> calculateTangents(
+			const std::vector<GLfloat>& positions,
+			const std::vector<GLfloat>& normals,
+			const std::vector<GLfloat>& uvs,
+			const std::vector<GLushort>& faceIndices
+		) const;
+	private:
+		/** Returns the number of chunks in which the faces are split,
+		 * each one with its own accumulation buffers
+		 *
+		 * @param	numTriangles the number of faces of the Mesh
+		 * @return	the number of chunks */
+		unsigned int getNumChunks(unsigned int numTriangles) const;
+
+		/** Returns the first face of a chunk
+		 *
+		 * @param	iChunk the index of the chunk
+		 * @param	numChunks the number of chunks
+		 * @param	numTriangles the number of faces of the Mesh
+		 * @return	the index of the first face of the chunk */
+		static unsigned int getChunkBegin(
+			unsigned int iChunk, unsigned int numChunks,
+			unsigned int numTriangles
+		);
+
+		/** Returns a vector from an array of 3D vectors
+		 *
+		 * @param	vectors the components of the vectors
+		 * @param	index the index of the vector
+		 * @return	the vector */
+		static inline glm::vec3 getVector(const GLfloat* vectors, unsigned int index)
+		{
+			const GLfloat* vector = vectors + 3 * index;
+			return glm::vec3(vector[0], vector[1], vector[2]);
+		};
+
+		/** Adds a vector to one of the vectors of an array of 3D vectors
+		 *
+		 * @param	vectors the components of the vectors
+		 * @param	index the index of the vector to add to
+		 * @param	vector the vector to add */
+		static inline void addVector(GLfloat* vectors, unsigned int index, const glm::vec3& vector)
+		{
+			vectors[3 * index]		+= vector.x;
+			vectors[3 * index + 1]	+= vector.y;
+			vectors[3 * index + 2]	+= vector.z;
+		};
+
+		/** Returns the angle between two edges of a face
+		 *
+		 * @param	e1 the first edge
+		 * @param	e2 the second edge
+		 * @return	the angle in radians, 0 if any of the edges has zero
+		 *			length */
+		static float getAngle(const glm::vec3& e1, const glm::vec3& e2);
+
+		/** Normalizes the given vectors, stored as separated components.
+		 * The zero vectors are left as zero
+		 *
+		 * @param	x the x components of the vectors
+		 * @param	y the y components of the vectors
+		 * @param	z the z components of the vectors
+		 * @param	count the number of vectors */
+		static void normalize(GLfloat* x, GLfloat* y, GLfloat* z, unsigned int count);
+	};
+
+}
+
+#endif		// NORMAL_GENERATOR_H
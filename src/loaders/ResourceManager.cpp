@@ -0,0 +1,61 @@
+#include "ResourceManager.h"
+#include "MeshLoader.h"
+#include "AsyncTextureLoader.h"
+
+namespace graphics {
+
+	ResourceManager::ResourceManager(
+		AsyncTextureLoader& textureLoader, MeshLoader& meshLoader,
+		std::size_t textureBudget, std::size_t meshBudget,
+		std::size_t materialBudget
+	) : mTextureLoader(textureLoader), mMeshLoader(meshLoader),
+		// The sizes are estimates: they don't include the allocator
+		// overhead nor the memory that the objects own indirectly
+		mTextures(
+			[](const Texture& texture) {
+				return ResourceSize{
+					sizeof(Texture) + texture.getTexturePath().capacity(),
+					texture.getGPUSize()
+				};
+			},
+			textureBudget
+		),
+		mMeshes(
+			[](const Mesh& mesh) {
+				return ResourceSize{
+					sizeof(Mesh) + mesh.getName().capacity(),
+					mesh.getGPUSize()
+				};
+			},
+			meshBudget
+		),
+		mMaterials(
+			[](const Material&) { return ResourceSize{ sizeof(Material), 0 }; },
+			materialBudget
+		) {}
+
+
+	std::shared_ptr<Texture> ResourceManager::getTexture(const std::string& path)
+	{
+		return mTextures.getOrLoad(path, [&]() {
+			return mTextureLoader.loadTexture(path);
+		});
+	}
+
+
+	std::shared_ptr<Mesh> ResourceManager::getMesh(const std::string& path)
+	{
+		return mMeshes.getOrLoad(path, [&]() {
+			return std::shared_ptr<Mesh>(mMeshLoader.loadMesh(path));
+		});
+	}
+
+
+	void ResourceManager::update()
+	{
+		mTextures.update();
+		mMeshes.update();
+		mMaterials.update();
+	}
+
+}
@@ -0,0 +1,116 @@
+#ifndef RESOURCE_MANAGER_H
+#define RESOURCE_MANAGER_H
+
+#include <memory>
+#include <string>
+#include <cstddef>
+#include "../utils/ResourceCache.h"
+#include "../graphics/Texture.h"
+#include "../graphics/3D/Mesh.h"
+#include "../graphics/3D/Material.h"
+
+namespace graphics {
+
+	class MeshLoader;
+	class AsyncTextureLoader;
+
+
+	/**
+	 * Class ResourceManager, it holds the Textures, Meshes and Materials
+	 * of the application in a ResourceCache per type.
+	 * <br>The Textures and Meshes are indexed by the path of their files,
+	 * so each file is loaded only once while it stays in the cache, and
+	 * the Materials by their name. The memory used by each type is
+	 * estimated in every update from the size of its objects, their names
+	 * and their GPU data, without the allocator overhead, and the least
+	 * recently used resources that aren't referenced anymore are evicted
+	 * when it exceeds the budget of their ResourceCache
+	 */
+	class ResourceManager
+	{
+	private:	// Attributes
+		/** The loader used for loading the Textures */
+		AsyncTextureLoader& mTextureLoader;
+
+		/** The loader used for loading the Meshes from mesh files */
+		MeshLoader& mMeshLoader;
+
+		/** The cache of the Textures */
+		ResourceCache<Texture> mTextures;
+
+		/** The cache of the Meshes */
+		ResourceCache<Mesh> mMeshes;
+
+		/** The cache of the Materials */
+		ResourceCache<Material> mMaterials;
+
+	public:		// Functions
+		/** Creates a new ResourceManager
+		 *
+		 * @param	textureLoader the loader used for loading the Textures
+		 * @param	meshLoader the loader used for loading the Meshes
+		 * @param	textureBudget the maximum number of bytes of the
+		 *			Textures
+		 * @param	meshBudget the maximum number of bytes of the Meshes
+		 * @param	materialBudget the maximum number of bytes of the
+		 *			Materials
+		 * @note	the loaders must outlive the ResourceManager */
+		ResourceManager(
+			AsyncTextureLoader& textureLoader, MeshLoader& meshLoader,
+			std::size_t textureBudget = 256 * 1024 * 1024,
+			std::size_t meshBudget = 128 * 1024 * 1024,
+			std::size_t materialBudget = 1024 * 1024
+		);
+
+		/** Class destructor */
+		~ResourceManager() {};
+
+		/** @return	the cache of the Textures */
+		inline ResourceCache<Texture>& getTextures() { return mTextures; };
+
+		/** @return	the cache of the Meshes */
+		inline ResourceCache<Mesh>& getMeshes() { return mMeshes; };
+
+		/** @return	the cache of the Materials */
+		inline ResourceCache<Material>& getMaterials()
+		{ return mMaterials; };
+
+		/** Returns the Texture of the given image file, starting to load
+		 * it if it isn't in the cache
+		 *
+		 * @param	path the path of the image
+		 * @return	the Texture, it will use a placeholder until it's
+		 *			loaded */
+		std::shared_ptr<Texture> getTexture(const std::string& path);
+
+		/** Returns the Mesh of the given mesh file, loading it if it isn't
+		 * in the cache
+		 *
+		 * @param	path the path of the mesh file
+		 * @return	the Mesh, nullptr if it couldn't be loaded */
+		std::shared_ptr<Mesh> getMesh(const std::string& path);
+
+		/** Returns the Material with the given name
+		 *
+		 * @param	name the name of the Material
+		 * @return	the Material, nullptr if it isn't in the cache */
+		inline std::shared_ptr<Material> getMaterial(const std::string& name)
+		{ return mMaterials.get(name); };
+
+		/** Adds the given Material to the cache
+		 *
+		 * @param	name the name of the Material
+		 * @param	material the Material to add */
+		inline void addMaterial(
+			const std::string& name, std::shared_ptr<Material> material
+		) { mMaterials.add(name, std::move(material)); };
+
+		/** Updates the memory used by the resources and evicts the
+		 * unreferenced ones of the types that exceed their budget. It
+		 * must be called from the GL thread */
+		void update();
+	};
+
+}
+
+#endif		// RESOURCE_MANAGER_H
@@ -0,0 +1,115 @@
+#include "TextureAtlasLoader.h"
+#include <string>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+#include "../utils/Logger.h"
+#include "../utils/JobSystem.h"
+#include "../graphics/Texture.h"
+#include "../graphics/2D/TextureAtlas.h"
+#include "../graphics/2D/SkylinePacker.h"
+
+namespace graphics {
+
+// Public Functions
+	TextureAtlasLoader::TextureAtlasUPtr TextureAtlasLoader::createTextureAtlas(
+		const std::string& name,
+		const std::vector<std::string>& imagePaths
+	) const {
+		const unsigned int numImages = imagePaths.size();
+		const unsigned int noPage = std::numeric_limits<unsigned int>::max();
+
+		// 1. Decode the images in parallel
+		std::vector<Image> images(numImages);
+		mJobSystem.parallelFor(0, numImages, 1, [&](unsigned int first, unsigned int last) {
+			for (unsigned int i = first; i < last; ++i) {
+				images[i].mPage = noPage;
+				if (!ImageDecoder::decode(imagePaths[i], images[i])) {
+					Logger::writeLog(LogType::WARNING, "Failed to load the image " + imagePaths[i]);
+				}
+			}
+		});
+
+		// 2. Pack the images from the highest to the lowest one
+		std::vector<unsigned int> order;
+		for (unsigned int i = 0; i < numImages; ++i) {
+			if (!images[i].mPixels.empty()) {
+				order.push_back(i);
+			}
+		}
+		std::sort(order.begin(), order.end(), [&](unsigned int i1, unsigned int i2) {
+			return (images[i1].mHeight != images[i2].mHeight)?
+				(images[i1].mHeight > images[i2].mHeight) :
+				(images[i1].mWidth > images[i2].mWidth);
+		});
+
+		std::vector<SkylinePacker> packers;
+		for (unsigned int iImage : order) {
+			Image& image = images[iImage];
+			unsigned int paddedWidth = image.mWidth + 2 * mPadding;
+			unsigned int paddedHeight = image.mHeight + 2 * mPadding;
+			if ((paddedWidth > mPageSize) || (paddedHeight > mPageSize)) {
+				Logger::writeLog(LogType::WARNING, "The image " + imagePaths[iImage] + " doesn't fit in the atlas pages");
+				continue;
+			}
+
+			unsigned int x, y;
+			for (unsigned int iPage = 0; (image.mPage == noPage) && (iPage <= packers.size()); ++iPage) {
+				if (iPage == packers.size()) {
+					packers.emplace_back(mPageSize, mPageSize);
+				}
+				if (packers[iPage].insert(paddedWidth, paddedHeight, x, y)) {
+					image.mPage = iPage;
+					image.mX = x + mPadding;
+					image.mY = y + mPadding;
+				}
+			}
+		}
+
+		// 3. Copy the images to their pages in parallel
+		const unsigned int numPages = packers.size();
+		std::vector<std::vector<GLubyte>> pagePixels(numPages, std::vector<GLubyte>(4 * mPageSize * mPageSize, 0));
+		mJobSystem.parallelFor(0, numImages, 16, [&](unsigned int first, unsigned int last) {
+			for (unsigned int i = first; i < last; ++i) {
+				const Image& image = images[i];
+				if (image.mPage == noPage) continue;
+
+				GLubyte* page = pagePixels[image.mPage].data();
+				for (unsigned int row = 0; row < image.mHeight; ++row) {
+					std::memcpy(
+						page + 4 * ((image.mY + row) * mPageSize + image.mX),
+						image.mPixels.data() + 4 * row * image.mWidth,
+						4 * image.mWidth
+					);
+				}
+			}
+		});
+
+		// 4. Create the Textures of the pages and the regions of the images
+		auto textureAtlas = std::make_unique<TextureAtlas>();
+
+		std::vector<std::shared_ptr<Texture>> pages;
+		for (unsigned int i = 0; i < numPages; ++i) {
+			pages.push_back(std::make_shared<Texture>(
+				name + std::to_string(i), GL_TEXTURE_2D,
+				pagePixels[i].data(), mPageSize, mPageSize
+			));
+			textureAtlas->addPage(pages.back());
+		}
+
+		const float invPageSize = 1.0f / mPageSize;
+		for (unsigned int i = 0; i < numImages; ++i) {
+			const Image& image = images[i];
+			if (image.mPage == noPage) continue;
+
+			textureAtlas->addRegion(imagePaths[i], {
+				pages[image.mPage],
+				glm::vec2(image.mX, image.mY) * invPageSize,
+				glm::vec2(image.mWidth, image.mHeight) * invPageSize
+			});
+		}
+
+		return textureAtlas;
+	}
+
+}
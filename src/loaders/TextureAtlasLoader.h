@@ -0,0 +1,82 @@
+#ifndef TEXTURE_ATLAS_LOADER_H
+#define TEXTURE_ATLAS_LOADER_H
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <GL/glew.h>
+#include "ImageDecoder.h"
+
+class JobSystem;
+
+namespace graphics {
+
+	class TextureAtlas;
+
+
+	/**
+	 * Class TextureAtlasLoader, it's used for creating TextureAtlases from
+	 * image files.
+	 * <br>The images are decoded in parallel, sorted by decreasing height
+	 * and packed with a SkylinePacker in the first page where they fit,
+	 * creating new pages when needed. Each image is surrounded by a
+	 * padding of transparent pixels, so the sampling doesn't bleed the
+	 * color of its neighbours
+	 */
+	class TextureAtlasLoader
+	{
+	private:	// Nested types
+		typedef std::unique_ptr<TextureAtlas> TextureAtlasUPtr;
+
+		/** Struct Image, it holds the data of a decoded image and its
+		 * location in the atlas */
+		struct Image : DecodedImage
+		{
+			/** The page of the image and the position of its bottom-left
+			 * corner inside of it */
+			unsigned int mPage, mX, mY;
+		};
+
+	private:	// Attributes
+		/** The JobSystem used for decoding and copying the images */
+		JobSystem& mJobSystem;
+
+		/** The width and height of the pages in pixels */
+		unsigned int mPageSize;
+
+		/** The number of pixels between the images */
+		unsigned int mPadding;
+
+	public:		// Functions
+		/** Creates a new TextureAtlasLoader
+		 *
+		 * @param	jobSystem the JobSystem used for creating the
+		 *			TextureAtlases in parallel
+		 * @param	pageSize the width and height of the pages in pixels
+		 * @param	padding the number of pixels between the images */
+		TextureAtlasLoader(
+			JobSystem& jobSystem,
+			unsigned int pageSize = 2048, unsigned int padding = 1
+		) : mJobSystem(jobSystem), mPageSize(pageSize), mPadding(padding) {};
+
+		/** Class destructor */
+		~TextureAtlasLoader() {};
+
+		/** Creates a TextureAtlas with the given images
+		 *
+		 * @param	name the name of the TextureAtlas, its pages will be
+		 *			named with it and their index
+		 * @param	imagePaths the paths of the images to pack, they are
+		 *			also used as the names of their regions
+		 * @return	a pointer to the new TextureAtlas
+		 * @note	the images that can't be loaded or that are bigger than
+		 *			a page are skipped */
+		TextureAtlasUPtr createTextureAtlas(
+			const std::string& name,
+			const std::vector<std::string>& imagePaths
+		) const;
+	};
+
+}
+
+#endif		// TEXTURE_ATLAS_LOADER_H
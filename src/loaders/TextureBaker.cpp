@@ -0,0 +1,407 @@
+#include "TextureBaker.h"
+#include <limits>
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "../utils/Logger.h"
+
+namespace graphics {
+
+	GLenum BakedTexture::getGLFormat() const
+	{
+		switch (mFormat) {
+			case BC1_FORMAT:	return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			case BC3_FORMAT:	return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			default:			return GL_RGBA;
+		}
+	}
+
+
+	unsigned int BakedTexture::getBlockSize() const
+	{
+		return (mFormat == BGRA8_FORMAT)? 1 : 4;
+	}
+
+
+	unsigned int BakedTexture::getBlockBytes() const
+	{
+		switch (mFormat) {
+			case BC1_FORMAT:	return 8;
+			case BC3_FORMAT:	return 16;
+			default:			return 4;
+		}
+	}
+
+// Public functions
+	void TextureBaker::bake(const DecodedImage& image, BakedTexture& baked)
+	{
+		bool hasAlpha = false;
+		for (std::size_t i = 3; (i < image.mPixels.size()) && !hasAlpha; i += 4) {
+			hasAlpha = (image.mPixels[i] < 255);
+		}
+
+		baked.mFormat = hasAlpha? BakedTexture::BC3_FORMAT : BakedTexture::BC1_FORMAT;
+		baked.mLevels.clear();
+		baked.mBuffer.clear();
+		baked.mFile.reset();
+
+		// Compress each level, the pointers are set after all of them
+		// have been appended to the buffer
+		std::vector<std::size_t> offsets;
+		std::vector<GLubyte> pixels = image.mPixels;
+		unsigned int width = image.mWidth, height = image.mHeight;
+		while (true) {
+			offsets.push_back(baked.mBuffer.size());
+			compress(pixels, width, height, hasAlpha, baked.mBuffer);
+			baked.mLevels.push_back({ width, height, nullptr, baked.mBuffer.size() - offsets.back() });
+
+			if ((width == 1) && (height == 1)) {
+				break;
+			}
+
+			pixels = downsample(pixels, width, height);
+			width = std::max(1u, width / 2);
+			height = std::max(1u, height / 2);
+		}
+
+		for (std::size_t i = 0; i < baked.mLevels.size(); ++i) {
+			baked.mLevels[i].mData = baked.mBuffer.data() + offsets[i];
+		}
+	}
+
+
+	void TextureBaker::wrap(DecodedImage& image, BakedTexture& baked)
+	{
+		baked.mFormat = BakedTexture::BGRA8_FORMAT;
+		baked.mBuffer = std::move(image.mPixels);
+		baked.mFile.reset();
+		baked.mLevels = { { image.mWidth, image.mHeight, baked.mBuffer.data(), baked.mBuffer.size() } };
+	}
+
+
+	bool TextureBaker::save(
+		const std::string& path, const std::string& sourcePath,
+		const BakedTexture& baked
+	) {
+		// Locate the data after the header and the level table
+		TextureFileHeader header = {};
+		header.mMagic		= TEXTURE_FILE_MAGIC;
+		header.mVersion		= TEXTURE_FILE_VERSION;
+		header.mFormat		= baked.mFormat;
+		header.mNumLevels	= baked.mLevels.size();
+		getFileStamp(sourcePath, header.mSourceSize, header.mSourceTime);
+
+		std::uint64_t offset = alignFileOffset(sizeof(TextureFileHeader) + baked.mLevels.size() * sizeof(TextureFileLevel));
+		std::vector<TextureFileLevel> levelTable;
+		for (const BakedTexture::Level& level : baked.mLevels) {
+			levelTable.push_back({ offset, level.mSize, level.mWidth, level.mHeight });
+			offset = alignFileOffset(offset + level.mSize);
+		}
+
+		// Write the data with zero padding up to each offset
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		const char padding[TEXTURE_FILE_ALIGNMENT] = {};
+		auto pad = [&]() {
+			std::uint64_t position = file.tellp();
+			file.write(padding, alignFileOffset(position) - position);
+		};
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(TextureFileHeader));
+		file.write(reinterpret_cast<const char*>(levelTable.data()), levelTable.size() * sizeof(TextureFileLevel));
+		for (const BakedTexture::Level& level : baked.mLevels) {
+			pad();
+			file.write(reinterpret_cast<const char*>(level.mData), level.mSize);
+		}
+
+		if (!file.good()) {
+			Logger::writeLog(LogType::ERROR, "Error writing the baked texture file " + path);
+			return false;
+		}
+
+		return true;
+	}
+
+
+	bool TextureBaker::load(
+		const std::string& path, const std::string& sourcePath,
+		BakedTexture& baked
+	) {
+		auto file = std::make_unique<MappedFile>(path);
+		if (!file->isOpen()) {
+			return false;
+		}
+
+		const unsigned char* data = file->getData();
+		const std::uint64_t size = file->getSize();
+		const TextureFileHeader* header = reinterpret_cast<const TextureFileHeader*>(data);
+		const TextureFileLevel* levelTable = reinterpret_cast<const TextureFileLevel*>(data + sizeof(TextureFileHeader));
+
+		// Validate the header before reading any data through it
+		const char* error = nullptr;
+		if (size < sizeof(TextureFileHeader)) {
+			error = "truncated header";
+		}
+		else if (header->mMagic != TEXTURE_FILE_MAGIC) {
+			error = "it isn't a baked texture file";
+		}
+		else if (header->mVersion != TEXTURE_FILE_VERSION) {
+			error = "unsupported version";
+		}
+		else if (header->mFormat > BakedTexture::BC3_FORMAT) {
+			error = "unknown format";
+		}
+		else if ((header->mNumLevels == 0) || (header->mNumLevels > MAX_LEVELS)) {
+			error = "invalid number of levels";
+		}
+		else if (size < sizeof(TextureFileHeader) + header->mNumLevels * sizeof(TextureFileLevel)) {
+			error = "truncated level table";
+		}
+
+		BakedTexture result;
+		result.mFormat = error? BakedTexture::BGRA8_FORMAT : static_cast<BakedTexture::Format>(header->mFormat);
+		const unsigned int blockSize = result.getBlockSize(), blockBytes = result.getBlockBytes();
+		for (unsigned int i = 0; !error && (i < header->mNumLevels); ++i) {
+			const TextureFileLevel& level = levelTable[i];
+
+			// Each level must halve the size of the previous one
+			bool validSize = (i == 0)?
+				(level.mWidth > 0) && (level.mHeight > 0) :
+				(level.mWidth == std::max(1u, levelTable[i - 1].mWidth / 2))
+					&& (level.mHeight == std::max(1u, levelTable[i - 1].mHeight / 2));
+			std::uint64_t numBlocksX = (level.mWidth + blockSize - 1) / blockSize;
+			std::uint64_t numBlocksY = (level.mHeight + blockSize - 1) / blockSize;
+
+			if (!validSize) {
+				error = "invalid level size";
+			}
+			else if ((level.mSize != numBlocksX * numBlocksY * blockBytes)
+				|| (level.mOffset % TEXTURE_FILE_ALIGNMENT != 0)
+				|| (level.mOffset > size) || (size - level.mOffset < level.mSize)
+			) {
+				error = "truncated level";
+			}
+			else {
+				result.mLevels.push_back({
+					level.mWidth, level.mHeight,
+					data + level.mOffset, static_cast<std::size_t>(level.mSize)
+				});
+			}
+		}
+
+		if (error) {
+			Logger::writeLog(LogType::WARNING, "Error loading the baked texture file " + path + ": " + error);
+			return false;
+		}
+
+		// Reject the outdated files
+		std::uint64_t sourceSize, sourceTime;
+		if (getFileStamp(sourcePath, sourceSize, sourceTime)
+			&& ((sourceSize != header->mSourceSize) || (sourceTime != header->mSourceTime))
+		) {
+			return false;
+		}
+
+		result.mFile = std::move(file);
+		baked = std::move(result);
+		return true;
+	}
+
+// Private functions
+	std::vector<GLubyte> TextureBaker::downsample(
+		const std::vector<GLubyte>& pixels,
+		unsigned int width, unsigned int height
+	) {
+		const unsigned int nextWidth = std::max(1u, width / 2);
+		const unsigned int nextHeight = std::max(1u, height / 2);
+
+		std::vector<GLubyte> nextPixels(4 * nextWidth * nextHeight);
+		for (unsigned int y = 0; y < nextHeight; ++y) {
+			const unsigned int y0 = std::min(2 * y, height - 1), y1 = std::min(2 * y + 1, height - 1);
+			for (unsigned int x = 0; x < nextWidth; ++x) {
+				const unsigned int x0 = std::min(2 * x, width - 1), x1 = std::min(2 * x + 1, width - 1);
+				for (unsigned int c = 0; c < 4; ++c) {
+					unsigned int sum = pixels[4 * (y0 * width + x0) + c] + pixels[4 * (y0 * width + x1) + c]
+						+ pixels[4 * (y1 * width + x0) + c] + pixels[4 * (y1 * width + x1) + c];
+					nextPixels[4 * (y * nextWidth + x) + c] = static_cast<GLubyte>((sum + 2) / 4);
+				}
+			}
+		}
+
+		return nextPixels;
+	}
+
+
+	void TextureBaker::compress(
+		const std::vector<GLubyte>& pixels,
+		unsigned int width, unsigned int height, bool hasAlpha,
+		std::vector<GLubyte>& output
+	) {
+		const unsigned int blockBytes = hasAlpha? 16 : 8;
+		const unsigned int numBlocksX = (width + 3) / 4, numBlocksY = (height + 3) / 4;
+
+		std::size_t offset = output.size();
+		output.resize(offset + numBlocksX * numBlocksY * blockBytes);
+
+		GLubyte block[64];
+		for (unsigned int by = 0; by < numBlocksY; ++by) {
+			for (unsigned int bx = 0; bx < numBlocksX; ++bx) {
+				// Gather the pixels of the block, repeating the last row and
+				// column at the borders of the level
+				for (unsigned int y = 0; y < 4; ++y) {
+					const unsigned int py = std::min(4 * by + y, height - 1);
+					for (unsigned int x = 0; x < 4; ++x) {
+						const unsigned int px = std::min(4 * bx + x, width - 1);
+						std::copy_n(&pixels[4 * (py * width + px)], 4, &block[4 * (4 * y + x)]);
+					}
+				}
+
+				GLubyte* blockOutput = &output[offset];
+				if (hasAlpha) {
+					encodeAlphaBlock(block, blockOutput);
+					blockOutput += 8;
+				}
+				encodeColorBlock(block, blockOutput);
+				offset += blockBytes;
+			}
+		}
+	}
+
+
+	void TextureBaker::encodeColorBlock(const GLubyte* block, GLubyte* output)
+	{
+		// The endpoints are the corners of the bounding box of the colors,
+		// inset by 1/16 of its size
+		int minColor[3] = { 255, 255, 255 }, maxColor[3] = { 0, 0, 0 };
+		for (unsigned int i = 0; i < 16; ++i) {
+			for (unsigned int c = 0; c < 3; ++c) {
+				minColor[c] = std::min(minColor[c], static_cast<int>(block[4 * i + c]));
+				maxColor[c] = std::max(maxColor[c], static_cast<int>(block[4 * i + c]));
+			}
+		}
+		for (unsigned int c = 0; c < 3; ++c) {
+			int inset = (maxColor[c] - minColor[c]) / 16;
+			minColor[c] += inset;
+			maxColor[c] -= inset;
+		}
+
+		GLushort color0 = packColor(maxColor), color1 = packColor(minColor);
+		if (color0 < color1) {
+			std::swap(color0, color1);
+		}
+
+		// The palette of the four colors mode
+		int palette[4][3];
+		unpackColor(color0, palette[0]);
+		unpackColor(color1, palette[1]);
+		for (unsigned int c = 0; c < 3; ++c) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+
+		std::uint32_t indices = 0;
+		if (color0 != color1) {
+			for (unsigned int i = 0; i < 16; ++i) {
+				unsigned int bestIndex = 0;
+				int bestDistance = std::numeric_limits<int>::max();
+				for (unsigned int j = 0; j < 4; ++j) {
+					int distance = 0;
+					for (unsigned int c = 0; c < 3; ++c) {
+						int difference = block[4 * i + c] - palette[j][c];
+						distance += difference * difference;
+					}
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						bestIndex = j;
+					}
+				}
+				indices |= bestIndex << (2 * i);
+			}
+		}
+
+		output[0] = color0 & 0xFF;
+		output[1] = color0 >> 8;
+		output[2] = color1 & 0xFF;
+		output[3] = color1 >> 8;
+		for (unsigned int i = 0; i < 4; ++i) {
+			output[4 + i] = (indices >> (8 * i)) & 0xFF;
+		}
+	}
+
+
+	void TextureBaker::encodeAlphaBlock(const GLubyte* block, GLubyte* output)
+	{
+		int minAlpha = 255, maxAlpha = 0;
+		for (unsigned int i = 0; i < 16; ++i) {
+			minAlpha = std::min(minAlpha, static_cast<int>(block[4 * i + 3]));
+			maxAlpha = std::max(maxAlpha, static_cast<int>(block[4 * i + 3]));
+		}
+
+		// The palette of the eight alphas mode
+		int palette[8] = { maxAlpha, minAlpha };
+		for (int j = 1; j < 7; ++j) {
+			palette[j + 1] = ((7 - j) * maxAlpha + j * minAlpha) / 7;
+		}
+
+		std::uint64_t indices = 0;
+		if (maxAlpha != minAlpha) {
+			for (unsigned int i = 0; i < 16; ++i) {
+				unsigned int bestIndex = 0;
+				int bestDistance = std::numeric_limits<int>::max();
+				for (unsigned int j = 0; j < 8; ++j) {
+					int distance = std::abs(block[4 * i + 3] - palette[j]);
+					if (distance < bestDistance) {
+						bestDistance = distance;
+						bestIndex = j;
+					}
+				}
+				indices |= static_cast<std::uint64_t>(bestIndex) << (3 * i);
+			}
+		}
+
+		output[0] = static_cast<GLubyte>(maxAlpha);
+		output[1] = static_cast<GLubyte>(minAlpha);
+		for (unsigned int i = 0; i < 6; ++i) {
+			output[2 + i] = (indices >> (8 * i)) & 0xFF;
+		}
+	}
+
+
+	GLushort TextureBaker::packColor(const int color[3])
+	{
+		return static_cast<GLushort>(((color[2] >> 3) << 11) | ((color[1] >> 2) << 5) | (color[0] >> 3));
+	}
+
+
+	void TextureBaker::unpackColor(GLushort packed, int color[3])
+	{
+		int r = (packed >> 11) & 0x1F, g = (packed >> 5) & 0x3F, b = packed & 0x1F;
+		color[0] = (b << 3) | (b >> 2);
+		color[1] = (g << 2) | (g >> 4);
+		color[2] = (r << 3) | (r >> 2);
+	}
+
+
+	bool TextureBaker::getFileStamp(
+		const std::string& path,
+		std::uint64_t& size, std::uint64_t& time
+	) {
+		struct stat status;
+		if (stat(path.c_str(), &status) != 0) {
+			size = time = 0;
+			return false;
+		}
+
+		size = status.st_size;
+		time = status.st_mtime;
+		return true;
+	}
+
+
+	std::uint64_t TextureBaker::alignFileOffset(std::uint64_t offset)
+	{
+		return (offset + TEXTURE_FILE_ALIGNMENT - 1) / TEXTURE_FILE_ALIGNMENT * TEXTURE_FILE_ALIGNMENT;
+	}
+
+}
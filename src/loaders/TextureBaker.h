@@ -0,0 +1,254 @@
+#ifndef TEXTURE_BAKER_H
+#define TEXTURE_BAKER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <GL/glew.h>
+#include "../utils/MappedFile.h"
+#include "ImageDecoder.h"
+
+namespace graphics {
+
+	/**
+	 * Struct BakedTexture, it holds the mip levels of a Texture in a
+	 * format that can be uploaded to the GPU without any processing
+	 */
+	struct BakedTexture
+	{
+		/** The formats of the levels: uncompressed BGRA with 8 bits per
+		 * channel, BC1 (DXT1) blocks without alpha and BC3 (DXT5) blocks
+		 * with alpha */
+		enum Format
+		{
+			BGRA8_FORMAT,
+			BC1_FORMAT,
+			BC3_FORMAT
+		};
+
+		/** Struct Level, it points to the data of a mip level */
+		struct Level
+		{
+			/** The size of the level in pixels */
+			unsigned int mWidth, mHeight;
+
+			/** A pointer to the data of the level */
+			const GLubyte* mData;
+
+			/** The size in bytes of the data of the level */
+			std::size_t mSize;
+		};
+
+		/** The Format of the levels */
+		Format mFormat;
+
+		/** The mip levels, from the biggest one to the 1x1 one */
+		std::vector<Level> mLevels;
+
+		/** The data of the levels when they have been baked in memory */
+		std::vector<GLubyte> mBuffer;
+
+		/** The mapped file of the levels when they have been loaded from
+		 * a baked texture file */
+		std::unique_ptr<MappedFile> mFile;
+
+		/** @return	the internal format of the levels in OpenGL */
+		GLenum getGLFormat() const;
+
+		/** @return	the width and height in pixels of the blocks of the
+		 *			Format, the rows of the levels are stored by blocks */
+		unsigned int getBlockSize() const;
+
+		/** @return	the size in bytes of each block of the Format */
+		unsigned int getBlockBytes() const;
+	};
+
+
+	/**
+	 * Class TextureBaker, it converts the decoded images to BakedTextures
+	 * and stores them in baked texture files, so they can be loaded later
+	 * without decoding nor processing them.
+	 * <br>The full mip chain is generated with a box filter, and each
+	 * level is compressed to BC1 if the image is opaque or to BC3 if it
+	 * has alpha. The blocks are encoded with the bounding box of their
+	 * colors, inset to reduce the error of the extremes.
+	 * <br>The files start with a TextureFileHeader followed by a
+	 * TextureFileLevel per level, and the data of the levels is aligned to
+	 * TEXTURE_FILE_ALIGNMENT bytes. The header stores the size and
+	 * modification time of the source image, so the files are baked again
+	 * when it changes
+	 */
+	class TextureBaker
+	{
+	private:	// Nested types
+		/** Struct TextureFileHeader, it's stored at the start of the
+		 * baked texture files */
+		struct TextureFileHeader
+		{
+			/** The TEXTURE_FILE_MAGIC number */
+			std::uint32_t mMagic;
+
+			/** The TEXTURE_FILE_VERSION of the file */
+			std::uint32_t mVersion;
+
+			/** The BakedTexture::Format of the levels */
+			std::uint32_t mFormat;
+
+			/** The number of levels */
+			std::uint32_t mNumLevels;
+
+			/** The size in bytes and the modification time of the source
+			 * image */
+			std::uint64_t mSourceSize, mSourceTime;
+		};
+
+		/** Struct TextureFileLevel, it holds the location of a level
+		 * inside the baked texture files */
+		struct TextureFileLevel
+		{
+			/** The offset in bytes of the data from the start of the
+			 * file */
+			std::uint64_t mOffset;
+
+			/** The size in bytes of the data */
+			std::uint64_t mSize;
+
+			/** The size of the level in pixels */
+			std::uint32_t mWidth, mHeight;
+		};
+
+	private:	// Attributes
+		/** The identifier of the baked texture files, "FZTX" in little
+		 * endian */
+		static const std::uint32_t TEXTURE_FILE_MAGIC = 0x58545A46;
+
+		/** The version of the format of the baked texture files */
+		static const std::uint32_t TEXTURE_FILE_VERSION = 1;
+
+		/** The alignment in bytes of the data of the baked texture
+		 * files */
+		static const std::uint32_t TEXTURE_FILE_ALIGNMENT = 16;
+
+		/** The maximum number of levels of the baked texture files, enough
+		 * for any size that fits in 32 bits */
+		static const std::uint32_t MAX_LEVELS = 32;
+
+	public:		// Functions
+		/** Generates the mip levels of the given image and compresses
+		 * them
+		 *
+		 * @param	image the decoded image
+		 * @param	baked where the levels will be stored */
+		static void bake(const DecodedImage& image, BakedTexture& baked);
+
+		/** Stores the given image in a BakedTexture without mip levels
+		 * nor compression
+		 *
+		 * @param	image the decoded image, its pixels will be moved
+		 * @param	baked where the level will be stored */
+		static void wrap(DecodedImage& image, BakedTexture& baked);
+
+		/** Saves the given BakedTexture to a baked texture file
+		 *
+		 * @param	path the path of the file
+		 * @param	sourcePath the path of the source image of the
+		 *			BakedTexture
+		 * @param	baked the BakedTexture to save
+		 * @return	true if the file was saved, false otherwise */
+		static bool save(
+			const std::string& path, const std::string& sourcePath,
+			const BakedTexture& baked
+		);
+
+		/** Loads a BakedTexture from a baked texture file. The file is
+		 * memory mapped and the levels point to its data
+		 *
+		 * @param	path the path of the file
+		 * @param	sourcePath the path of the source image, the file is
+		 *			rejected if it was baked from a different version of
+		 *			it. If the source image doesn't exist the file is
+		 *			always accepted
+		 * @param	baked where the levels will be stored
+		 * @return	true if the file was loaded, false if it doesn't exist,
+		 *			it's outdated or it isn't a valid baked texture file */
+		static bool load(
+			const std::string& path, const std::string& sourcePath,
+			BakedTexture& baked
+		);
+	private:
+		/** Halves the size of the given level with a box filter
+		 *
+		 * @param	pixels the BGRA pixels of the level
+		 * @param	width the width of the level
+		 * @param	height the height of the level
+		 * @return	the BGRA pixels of the next level */
+		static std::vector<GLubyte> downsample(
+			const std::vector<GLubyte>& pixels,
+			unsigned int width, unsigned int height
+		);
+
+		/** Compresses the given level
+		 *
+		 * @param	pixels the BGRA pixels of the level
+		 * @param	width the width of the level
+		 * @param	height the height of the level
+		 * @param	hasAlpha if the level must be compressed to BC3 or
+		 *			to BC1
+		 * @param	output where the blocks will be appended */
+		static void compress(
+			const std::vector<GLubyte>& pixels,
+			unsigned int width, unsigned int height, bool hasAlpha,
+			std::vector<GLubyte>& output
+		);
+
+		/** Encodes the colors of a block of 4x4 pixels to a BC1 block
+		 *
+		 * @param	block the 16 BGRA pixels of the block, row by row
+		 * @param	output where the 8 bytes of the block will be
+		 *			stored */
+		static void encodeColorBlock(const GLubyte* block, GLubyte* output);
+
+		/** Encodes the alpha of a block of 4x4 pixels to a BC3 alpha
+		 * block
+		 *
+		 * @param	block the 16 BGRA pixels of the block, row by row
+		 * @param	output where the 8 bytes of the block will be
+		 *			stored */
+		static void encodeAlphaBlock(const GLubyte* block, GLubyte* output);
+
+		/** Packs the given color to the 5:6:5 format of the BC1 blocks
+		 *
+		 * @param	color the BGR color
+		 * @return	the packed color */
+		static GLushort packColor(const int color[3]);
+
+		/** Unpacks the given 5:6:5 color of a BC1 block
+		 *
+		 * @param	packed the packed color
+		 * @param	color where the BGR color will be stored */
+		static void unpackColor(GLushort packed, int color[3]);
+
+		/** Returns the size and modification time of the given file
+		 *
+		 * @param	path the path of the file
+		 * @param	size where the size in bytes will be stored
+		 * @param	time where the modification time will be stored
+		 * @return	true if the file exists, false otherwise */
+		static bool getFileStamp(
+			const std::string& path,
+			std::uint64_t& size, std::uint64_t& time
+		);
+
+		/** Rounds up the given offset of a baked texture file to
+		 * TEXTURE_FILE_ALIGNMENT
+		 *
+		 * @param	offset the offset in bytes
+		 * @return	the aligned offset */
+		static std::uint64_t alignFileOffset(std::uint64_t offset);
+	};
+
+}
+
+#endif		// TEXTURE_BAKER_H
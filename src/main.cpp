@@ -6,6 +6,7 @@
 
 #include "utils/Logger.h"
 #include "utils/FileReader.h"
+#include "utils/JobSystem.h"
 
 #include "window/WindowSystem.h"
 
@@ -20,6 +21,8 @@
 #include "graphics/GraphicsSystem.h"
 
 #include "loaders/MeshLoader.h"
+#include "loaders/AsyncTextureLoader.h"
+#include "loaders/ResourceManager.h"
 
 
 #define WIDTH	1280
@@ -40,9 +43,12 @@ int main(int argc, char** argv)
 	windowSystem->setMousePosition(WIDTH / (float)2, HEIGHT / (float)2);
 	windowSystem->printGLInfo();
 
+	// Jobs
+	JobSystem jobSystem;
+
 	// Graphics
 	graphics::GraphicsSystem* graphicsSystem;
-	if (!(graphicsSystem = new graphics::GraphicsSystem())) {
+	if (!(graphicsSystem = new graphics::GraphicsSystem(WIDTH, HEIGHT, jobSystem))) {
 		Logger::writeLog(LogType::ERROR, "Error initializing the graphics system");
 		return -1;
 	}
@@ -51,7 +57,7 @@ int main(int argc, char** argv)
 	 * GRAPHICS DATA
 	 *********************************************************************/
 	// Graphics Primitives
-	graphics::MeshLoader meshLoader;
+	graphics::MeshLoader meshLoader(jobSystem);
 	std::vector<GLfloat> positions = {
 		-0.5f,	-0.5f,	-0.5f,
 		-0.5f,	-0.5f,	0.5f,
@@ -111,7 +117,9 @@ int main(int argc, char** argv)
 		0.1f
 	);
 
-	auto texture1 = std::make_shared<graphics::Texture>("res/images/test.png", GL_TEXTURE_2D);
+	graphics::AsyncTextureLoader textureLoader(jobSystem);
+	graphics::ResourceManager resourceManager(textureLoader, meshLoader);
+	auto texture1 = resourceManager.getTexture("res/images/test.png");
 
 	graphics::BaseLight baseLight1(4.0f, 24.0f);
 	graphics::Attenuation attenuation1{ 0.5f, 0.25f, 0.2f };
@@ -126,6 +134,10 @@ int main(int argc, char** argv)
 	pointLights.push_back(&pointLight1);
 	pointLights.push_back(&pointLight2);
 
+	std::vector<const graphics::SpotLight*> spotLights;
+	graphics::SpotLight spotLight1(graphics::PointLight(baseLight1, attenuation1, glm::vec3(0, 5, -10)), glm::vec3(0, -1, 0), glm::radians(30.0f));
+	spotLights.push_back(&spotLight1);
+
 	// Renderable2Ds
 	std::vector<const graphics::Renderable2D*> renderable2Ds;
 	graphics::Renderable2D renderable2D1(glm::vec2(0.8f, 0.75f), glm::vec2(0.125f, 0.2f), texture1);
@@ -163,7 +175,7 @@ int main(int argc, char** argv)
 	/*********************************************************************
 	 * MAIN LOOP
 	 *********************************************************************/
-	bool end = false;
+	bool end = false, tabPressed = false;
 
 	float lastTime = windowSystem->getTime(), elapsed = lastTime;
 	int fps = 0;
@@ -177,14 +189,31 @@ int main(int argc, char** argv)
 		fps++;
 		if (lastTime - elapsed >= 1.0f) {
 			elapsed = lastTime;
-			std::cout << "FPS: " << fps << '\r' << std::flush;
+			graphics::SceneBatcher::Statistics stats = graphicsSystem->getSceneStatistics();
+			graphics::GLStateCache::Statistics glStats = graphicsSystem->getGLStatistics();
+			std::cout	<< "FPS: " << fps
+						<< "\tDrawn: " << stats.mNumDrawn
+						<< "\tCulled: " << stats.mNumCulled
+						<< "\tDraw calls: " << stats.mNumDrawCalls
+						<< "\tGL calls elided: " << glStats.mNumElidedCalls << "/" << glStats.mNumCalls << '\r' << std::flush;
 			fps = 0;
 		}
 
 		windowSystem->update();
 		window::InputData inputData = windowSystem->getInputData();
 		if (inputData.mKeys[GLFW_KEY_ESCAPE] || windowSystem->isClosed()) { end = true; }
-		graphicsSystem->render(&camera1, renderable3Ds, renderable2Ds, pointLights);
+		if (inputData.mKeys[GLFW_KEY_TAB] && !tabPressed) {
+			// Switch between the forward and the deferred renderers
+			graphicsSystem->setRenderingMode(
+				(graphicsSystem->getRenderingMode() == graphics::GraphicsSystem::FORWARD_RENDERING)?
+				graphics::GraphicsSystem::DEFERRED_RENDERING :
+				graphics::GraphicsSystem::FORWARD_RENDERING
+			);
+		}
+		tabPressed = inputData.mKeys[GLFW_KEY_TAB];
+		textureLoader.update();
+		resourceManager.update();
+		graphicsSystem->render(&camera1, renderable3Ds, renderable2Ds, pointLights, spotLights);
 		windowSystem->swapBuffers();
 	}
 
@@ -0,0 +1,220 @@
+#include "FileReader.h"
+#include <locale>
+#include <sstream>
+
+namespace {
+
+	/** The exact powers of 10 that can be stored in a double */
+	const double POWERS_OF_10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	/** The maximum number of significant digits accumulated in the fast
+	 * path of the floating point parser */
+	const int MAX_DIGITS = 19;
+
+	/** The maximum mantissa that can be stored exactly in a double */
+	const unsigned long long MAX_EXACT_MANTISSA = 1ull << 53;
+
+	/** @return	true if the given character is a whitespace */
+	inline bool isSpace(char c)
+	{
+		return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r')
+			|| (c == '\v') || (c == '\f');
+	}
+
+}
+
+// Public functions
+FileReader::FileReader(const std::string& path) :
+	mFile(path), mCurrent(nullptr), mEnd(nullptr), mNumLines(0),
+	mLineStart(true), mParseFailed(false)
+{
+	if (mFile.isOpen()) {
+		mCurrent = reinterpret_cast<const char*>(mFile.getData());
+		mEnd = mCurrent + mFile.getSize();
+	}
+}
+
+// Private functions
+bool FileReader::nextToken(const char*& begin, const char*& end)
+{
+	for (; mCurrent != mEnd; ++mCurrent) {
+		if (mLineStart) {
+			++mNumLines;
+			mLineStart = false;
+		}
+
+		if (*mCurrent == '\n') {
+			mLineStart = true;
+		}
+		else if (!isSpace(*mCurrent)) {
+			break;
+		}
+	}
+
+	if (mCurrent == mEnd) {
+		return false;
+	}
+
+	begin = mCurrent;
+	while ((mCurrent != mEnd) && !isSpace(*mCurrent)) {
+		++mCurrent;
+	}
+	end = mCurrent;
+
+	return true;
+}
+
+
+bool FileReader::parseToken(const char* begin, const char* end, std::string& value)
+{
+	value.assign(begin, end);
+	return true;
+}
+
+
+bool FileReader::parseToken(const char* begin, const char* end, char& value)
+{
+	if (end - begin != 1) {
+		return false;
+	}
+
+	value = *begin;
+	return true;
+}
+
+
+bool FileReader::parseToken(const char* begin, const char* end, signed char& value)
+{
+	char result;
+	if (!parseToken(begin, end, result)) {
+		return false;
+	}
+
+	value = static_cast<signed char>(result);
+	return true;
+}
+
+
+bool FileReader::parseToken(const char* begin, const char* end, unsigned char& value)
+{
+	char result;
+	if (!parseToken(begin, end, result)) {
+		return false;
+	}
+
+	value = static_cast<unsigned char>(result);
+	return true;
+}
+
+
+bool FileReader::parseToken(const char* begin, const char* end, bool& value)
+{
+	// Like the streams without std::boolalpha, only 0 and 1 are valid
+	if ((end - begin != 1) || ((*begin != '0') && (*begin != '1'))) {
+		return false;
+	}
+
+	value = (*begin == '1');
+	return true;
+}
+
+
+bool FileReader::parseToken(const char* begin, const char* end, double& value)
+{
+	const char* it = begin;
+	bool negative = false;
+	if ((*it == '+') || (*it == '-')) {
+		negative = (*it == '-');
+		++it;
+	}
+
+	// Accumulate the significant digits of the mantissa
+	unsigned long long mantissa = 0;
+	int numDigits = 0, exponent = 0;
+	bool hasDigits = false, exact = true;
+	for (; (it != end) && (*it >= '0') && (*it <= '9'); ++it) {
+		hasDigits = true;
+		if (numDigits < MAX_DIGITS) {
+			mantissa = mantissa * 10 + (*it - '0');
+			numDigits += (mantissa > 0)? 1 : 0;
+		}
+		else {
+			exact = false;
+		}
+	}
+	if ((it != end) && (*it == '.')) {
+		for (++it; (it != end) && (*it >= '0') && (*it <= '9'); ++it) {
+			hasDigits = true;
+			if (numDigits < MAX_DIGITS) {
+				mantissa = mantissa * 10 + (*it - '0');
+				numDigits += (mantissa > 0)? 1 : 0;
+				--exponent;
+			}
+			else {
+				exact = false;
+			}
+		}
+	}
+
+	if (hasDigits && (it != end) && ((*it == 'e') || (*it == 'E'))) {
+		++it;
+		bool negativeExponent = false;
+		if ((it != end) && ((*it == '+') || (*it == '-'))) {
+			negativeExponent = (*it == '-');
+			++it;
+		}
+
+		int explicitExponent = 0;
+		bool hasExponentDigits = false;
+		for (; (it != end) && (*it >= '0') && (*it <= '9'); ++it) {
+			hasExponentDigits = true;
+			if (explicitExponent < 10000) {
+				explicitExponent = explicitExponent * 10 + (*it - '0');
+			}
+		}
+		if (!hasExponentDigits) {
+			return false;
+		}
+
+		exponent += negativeExponent? -explicitExponent : explicitExponent;
+	}
+
+	if (hasDigits && (it == end) && exact && (mantissa <= MAX_EXACT_MANTISSA)
+		&& (exponent >= -22) && (exponent <= 22)
+	) {
+		// Both the mantissa and the power of 10 are exact, so a single
+		// operation gives the correctly rounded result
+		double result = static_cast<double>(mantissa);
+		result = (exponent < 0)? result / POWERS_OF_10[-exponent] : result * POWERS_OF_10[exponent];
+		value = negative? -result : result;
+		return true;
+	}
+
+	// Slow path for the inexact values. The stream uses the classic
+	// locale, so the decimal separator is always '.' whatever the global
+	// locale is
+	std::istringstream stream(std::string(begin, end));
+	stream.imbue(std::locale::classic());
+	double result;
+	if (!(stream >> result) || (stream.get() != std::char_traits<char>::eof())) {
+		return false;
+	}
+
+	value = result;
+	return true;
+}
+
+
+bool FileReader::parseToken(const char* begin, const char* end, float& value)
+{
+	double result;
+	if (!parseToken(begin, end, result)) {
+		return false;
+	}
+
+	value = static_cast<float>(result);
+	return true;
+}
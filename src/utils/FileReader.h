@@ -2,48 +2,69 @@
 #define FILE_READER_H
 
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <limits>
+#include <type_traits>
+#include "MappedFile.h"
 
 /**
- * Class FileReader reads a file line by line
+ * Class FileReader reads a file token by token
+ * <br>The file is memory mapped and its tokens are located and parsed in
+ * place, without copying the lines to intermediate streams. The tokens are
+ * separated by whitespaces, and the numbers are parsed with a locale
+ * independent parser. The floating point numbers that can't be converted
+ * exactly with double arithmetic fall back to a stream with the classic
+ * locale
  */
 class FileReader
 {
-private:	// Attributes
-	/** The path of the file that we are currently reading */
-	std::string mPath;
+private:	// Nested types
+	/** The return type of the parseToken function of the integer types,
+	 * bool and the character types have their own overloads */
+	template<typename T>
+	using IntegerResult = typename std::enable_if<
+		std::is_integral<T>::value && !std::is_same<T, bool>::value
+			&& !std::is_same<T, char>::value && !std::is_same<T, signed char>::value
+			&& !std::is_same<T, unsigned char>::value,
+		bool
+	>::type;
 
+private:	// Attributes
 	/** The file that we are currently reading */
-	std::ifstream mInputFStream;
+	MappedFile mFile;
+
+	/** A pointer to the next character to read */
+	const char* mCurrent;
 
-	/** The current stream line */
-	std::stringstream mCurLineStream;
+	/** A pointer past the last character of the file */
+	const char* mEnd;
 
 	/** The number of lines readed in the current file */
 	unsigned int mNumLines;
 
-public:
-	/** Creates a new FileLineReader */
-	FileReader() {};
+	/** If the next character to read is the first one of a line */
+	bool mLineStart;
+
+	/** If a token couldn't be parsed */
+	bool mParseFailed;
 
-	/** Creates a new FileLineReader
+public:
+	/** Creates a new FileReader
 	 *
 	 * @param	path the path of the file that we are going to read */
-	FileReader(const std::string& path) :
-		mPath(path), mInputFStream(path), mNumLines(0) {};
+	FileReader(const std::string& path);
 
 	/** Class destructor */
-	~FileReader() { mInputFStream.close(); };
+	~FileReader() {};
 
 	/** @return	the path of the file that the Reader is currently reading */
-	inline std::string getCurrentFilePath() const { return mPath; };
+	inline std::string getCurrentFilePath() const
+	{ return mFile.getPath(); };
 
 	/** @return	the number of readed lines in the current file */
 	inline unsigned int getNumLines() const { return mNumLines; };
 
 	/** Reads the next value and stores it in the given parameter
-	 * 
+	 *
 	 * @param	token the variables where we are going to store the readed
 	 *			value
 	 * @return	true if the value was readed and loaded succesfully, false
@@ -51,41 +72,95 @@ public:
 	template<typename T> bool getParam(T& token);
 
 	/** @return	true if we reached the end of file */
-	inline bool eof() const { return mInputFStream.eof(); };
+	inline bool eof() const { return mCurrent == mEnd; };
 
-	/** @return	true if there was an error reading the file */
-	inline bool fail() const { return mInputFStream.fail(); };
+	/** @return	true if there was an error reading the file or parsing
+	 *			one of its tokens */
+	inline bool fail() const { return !mFile.isOpen() || mParseFailed; };
+private:
+	/** Skips the whitespaces until the next token, counting the lines
+	 *
+	 * @param	begin where the pointer to the first character of the
+	 *			token will be stored
+	 * @param	end where the pointer past the last character of the token
+	 *			will be stored
+	 * @return	true if a token was found, false if we reached the end
+	 *			of the file */
+	bool nextToken(const char*& begin, const char*& end);
+
+	/** Parses the given token
+	 *
+	 * @param	begin a pointer to the first character of the token
+	 * @param	end a pointer past the last character of the token
+	 * @param	value where the parsed value will be stored
+	 * @return	true if the whole token was parsed, false otherwise */
+	static bool parseToken(const char* begin, const char* end, std::string& value);
+	static bool parseToken(const char* begin, const char* end, char& value);
+	static bool parseToken(const char* begin, const char* end, signed char& value);
+	static bool parseToken(const char* begin, const char* end, unsigned char& value);
+	static bool parseToken(const char* begin, const char* end, bool& value);
+	static bool parseToken(const char* begin, const char* end, double& value);
+	static bool parseToken(const char* begin, const char* end, float& value);
+	template<typename T>
+	static IntegerResult<T> parseToken(const char* begin, const char* end, T& value);
 };
 
 
 // Template function definitions
 template<typename T> bool FileReader::getParam(T& token)
 {
-	bool ret = true;
+	const char *begin, *end;
+	if (!nextToken(begin, end)) {
+		return false;
+	}
 
-	if (mCurLineStream.rdbuf()->in_avail() > 0) {
-		// If the current line isn't empty we parse the token
-		try {
-			mCurLineStream >> token;
-		}
-		catch (std::exception&) {
-			ret = false;
-		}
+	if (!parseToken(begin, end, token)) {
+		mParseFailed = true;
+		return false;
 	}
-	else if (!mInputFStream.eof()) {
-		// Read the next lines recursively until we find a not empty line
-		std::string stringLine;
-		std::getline(mInputFStream, stringLine);
-		mCurLineStream = std::stringstream(stringLine);
-		++mNumLines;
-
-		ret = getParam(token);
+
+	return true;
+};
+
+
+template<typename T>
+FileReader::IntegerResult<T> FileReader::parseToken(const char* begin, const char* end, T& value)
+{
+	bool negative = false;
+	if ((*begin == '+') || (std::is_signed<T>::value && (*begin == '-'))) {
+		negative = (*begin == '-');
+		++begin;
+	}
+	if (begin == end) {
+		return false;
 	}
-	else {
-		ret = false;
+
+	// Accumulate the digits as negative numbers, so the minimum value of
+	// the signed types doesn't overflow
+	const T limit = negative? std::numeric_limits<T>::min() : std::numeric_limits<T>::max();
+	T result = 0;
+	for (; begin != end; ++begin) {
+		unsigned int digit = static_cast<unsigned char>(*begin) - '0';
+		if (digit > 9) {
+			return false;
+		}
+
+		if (negative) {
+			if (result < (limit + static_cast<T>(digit)) / 10) {
+				return false;
+			}
+			result = result * 10 - static_cast<T>(digit);
+		}
+		else {
+			if (result > (limit - static_cast<T>(digit)) / 10) {
+				return false;
+			}
+			result = result * 10 + static_cast<T>(digit);
+		}
 	}
 
-	return ret;
+	value = result;
+	return true;
 };
 
 #endif		// FILE_READER_H
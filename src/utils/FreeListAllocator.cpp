@@ -0,0 +1,99 @@
+#include "FreeListAllocator.h"
+#include <iterator>
+
+// Public functions
+FreeListAllocator::FreeListAllocator(unsigned int size) :
+	mSize(0), mUsedSize(0)
+{
+	grow(size);
+}
+
+
+bool FreeListAllocator::allocate(unsigned int size, unsigned int& offset)
+{
+	if (size == 0) {
+		offset = 0;
+		return true;
+	}
+
+	for (auto itRange = mFreeRanges.begin(); itRange != mFreeRanges.end(); ++itRange) {
+		if (itRange->second >= size) {
+			offset = itRange->first;
+
+			// Keep the remaining part of the range as free
+			unsigned int remainingSize = itRange->second - size;
+			mFreeRanges.erase(itRange);
+			if (remainingSize > 0) {
+				mFreeRanges.emplace(offset + size, remainingSize);
+			}
+
+			mUsedSize += size;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void FreeListAllocator::release(unsigned int offset, unsigned int size)
+{
+	if (size == 0) return;
+
+	mUsedSize -= size;
+
+	// Merge the range with the next free range
+	auto itNext = mFreeRanges.lower_bound(offset);
+	if ((itNext != mFreeRanges.end()) && (offset + size == itNext->first)) {
+		size += itNext->second;
+		itNext = mFreeRanges.erase(itNext);
+	}
+
+	// Merge the range with the previous free range
+	if (itNext != mFreeRanges.begin()) {
+		auto itPrevious = std::prev(itNext);
+		if (itPrevious->first + itPrevious->second == offset) {
+			itPrevious->second += size;
+			return;
+		}
+	}
+
+	mFreeRanges.emplace_hint(itNext, offset, size);
+}
+
+
+void FreeListAllocator::grow(unsigned int size)
+{
+	if (size <= mSize) return;
+
+	unsigned int oldSize = mSize;
+	mSize = size;
+
+	// The new elements are released as a range, so they are merged with
+	// the last free range
+	mUsedSize += size - oldSize;
+	release(oldSize, size - oldSize);
+}
+
+
+void FreeListAllocator::reset(unsigned int usedSize)
+{
+	mFreeRanges.clear();
+	mUsedSize = usedSize;
+	if (usedSize < mSize) {
+		mFreeRanges.emplace(usedSize, mSize - usedSize);
+	}
+}
+
+
+unsigned int FreeListAllocator::getLargestFreeRange() const
+{
+	unsigned int largestSize = 0;
+	for (const auto& pair : mFreeRanges) {
+		if (pair.second > largestSize) {
+			largestSize = pair.second;
+		}
+	}
+
+	return largestSize;
+}
@@ -0,0 +1,77 @@
+#ifndef FREE_LIST_ALLOCATOR_H
+#define FREE_LIST_ALLOCATOR_H
+
+#include <map>
+
+/**
+ * Class FreeListAllocator, it manages the allocation of ranges of an
+ * abstract space of elements (bytes, vertices, indices...) without
+ * touching its memory.
+ * <br>The free ranges are kept sorted by their offset, the allocations
+ * use the first free range where they fit, and the released ranges are
+ * merged with their free neighbours
+ */
+class FreeListAllocator
+{
+private:	// Attributes
+	/** Maps the offset of each free range with its size */
+	std::map<unsigned int, unsigned int> mFreeRanges;
+
+	/** The number of elements of the space */
+	unsigned int mSize;
+
+	/** The number of allocated elements */
+	unsigned int mUsedSize;
+
+public:		// Functions
+	/** Creates a new FreeListAllocator
+	 *
+	 * @param	size the initial number of elements of the space */
+	FreeListAllocator(unsigned int size);
+
+	/** Class destructor */
+	~FreeListAllocator() {};
+
+	/** Allocates a range of the given size
+	 *
+	 * @param	size the number of elements of the range
+	 * @param	offset where the offset of the range will be stored
+	 * @return	true if the range was allocated, false if there isn't a
+	 *			free range big enough */
+	bool allocate(unsigned int size, unsigned int& offset);
+
+	/** Releases the given range
+	 *
+	 * @param	offset the offset of the range
+	 * @param	size the number of elements of the range
+	 * @note	the range must have been returned by allocate */
+	void release(unsigned int offset, unsigned int size);
+
+	/** Adds elements to the end of the space
+	 *
+	 * @param	size the new number of elements of the space, it must be
+	 *			bigger than the current one */
+	void grow(unsigned int size);
+
+	/** Marks all the space as free except for its first elements, so
+	 * it can be used after compacting the allocated ranges
+	 *
+	 * @param	usedSize the number of elements at the start of the space
+	 *			that remain allocated */
+	void reset(unsigned int usedSize);
+
+	/** @return	the number of elements of the space */
+	inline unsigned int getSize() const { return mSize; };
+
+	/** @return	the number of allocated elements */
+	inline unsigned int getUsedSize() const { return mUsedSize; };
+
+	/** @return	the number of free ranges */
+	inline unsigned int getNumFreeRanges() const
+	{ return mFreeRanges.size(); };
+
+	/** @return	the size of the biggest free range */
+	unsigned int getLargestFreeRange() const;
+};
+
+#endif		// FREE_LIST_ALLOCATOR_H
@@ -0,0 +1,23 @@
+#ifndef ID_GENERATOR_H
+#define ID_GENERATOR_H
+
+#include <atomic>
+
+/**
+ * Class IDGenerator, it's used for creating unique identifiers for the
+ * instances of the type T. It's thread safe
+ */
+template <typename T>
+class IDGenerator
+{
+public:		// Functions
+	/** @return	a new identifier that hasn't been returned before for the
+	 *			type T */
+	static unsigned int nextID()
+	{
+		static std::atomic<unsigned int> sNextID(0);
+		return sNextID++;
+	};
+};
+
+#endif		// ID_GENERATOR_H
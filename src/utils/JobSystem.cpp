@@ -0,0 +1,211 @@
+#include "JobSystem.h"
+#include <stdexcept>
+#include "Logger.h"
+
+// Static attributes
+thread_local JobSystem* JobSystem::mCurrentJobSystem = nullptr;
+thread_local unsigned int JobSystem::mCurrentQueueIndex = 0;
+
+// Public functions
+JobSystem::JobSystem(unsigned int numWorkers) :
+	mNumQueuedTasks(0), mNumSteals(0), mStop(false)
+{
+	if (numWorkers == 0) {
+		unsigned int numThreads = std::thread::hardware_concurrency();
+		numWorkers = (numThreads > 1)? numThreads - 1 : 1;
+	}
+
+	for (unsigned int i = 0; i < numWorkers + 1; ++i) {
+		mQueues.emplace_back(new TaskQueue());
+	}
+
+	for (unsigned int i = 0; i < numWorkers; ++i) {
+		mWorkers.emplace_back(&JobSystem::workerLoop, this, i);
+	}
+}
+
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+		mStop = true;
+	}
+	mWakeCondition.notify_all();
+
+	for (std::thread& worker : mWorkers) {
+		worker.join();
+	}
+}
+
+
+void JobSystem::run(const Job& job, Counter* counter)
+{
+	if (counter) {
+		++counter->mCount;
+	}
+
+	push({ job, counter });
+}
+
+
+void JobSystem::runAfter(Counter& dependency, const Job& job, Counter* counter)
+{
+	if (counter) {
+		++counter->mCount;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(dependency.mMutex);
+		if (dependency.mCount > 0) {
+			dependency.mContinuations.emplace_back(job, counter);
+			return;
+		}
+	}
+
+	push({ job, counter });
+}
+
+
+void JobSystem::wait(Counter& counter)
+{
+	Task task;
+	while (!counter.isDone()) {
+		if (pop(task)) {
+			execute(task);
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+	// Wait until the thread that finished the last Job releases the
+	// Counter
+	std::lock_guard<std::mutex> lock(counter.mMutex);
+}
+
+
+void JobSystem::parallelFor(
+	unsigned int begin, unsigned int end, unsigned int grainSize,
+	const std::function<void(unsigned int, unsigned int)>& function
+) {
+	if (grainSize == 0) {
+		grainSize = 1;
+	}
+
+	Counter counter;
+	for (unsigned int first = begin; first < end; first += grainSize) {
+		unsigned int last = (end - first > grainSize)? first + grainSize : end;
+		run([&function, first, last]() { function(first, last); }, &counter);
+	}
+
+	wait(counter);
+}
+
+// Private functions
+void JobSystem::workerLoop(unsigned int queueIndex)
+{
+	mCurrentJobSystem = this;
+	mCurrentQueueIndex = queueIndex;
+
+	Task task;
+	while (true) {
+		if (pop(task)) {
+			execute(task);
+			continue;
+		}
+
+		// Sleep until there are new Tasks or the JobSystem is destroyed
+		std::unique_lock<std::mutex> lock(mWakeMutex);
+		mWakeCondition.wait(lock, [this]() { return mStop || (mNumQueuedTasks > 0); });
+		if (mStop && (mNumQueuedTasks == 0)) {
+			break;
+		}
+	}
+}
+
+
+void JobSystem::push(Task task)
+{
+	TaskQueue& queue = *mQueues[getQueueIndex()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mMutex);
+		queue.mTasks.push_back(std::move(task));
+	}
+	++mNumQueuedTasks;
+
+	// Lock the mutex so the notification can't be lost between the check
+	// of the predicate and the wait of a worker
+	{
+		std::lock_guard<std::mutex> lock(mWakeMutex);
+	}
+	mWakeCondition.notify_one();
+}
+
+
+bool JobSystem::pop(Task& task)
+{
+	unsigned int queueIndex = getQueueIndex();
+
+	// Pop the newest Task of the own queue
+	{
+		TaskQueue& queue = *mQueues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mMutex);
+		if (!queue.mTasks.empty()) {
+			task = std::move(queue.mTasks.back());
+			queue.mTasks.pop_back();
+			--mNumQueuedTasks;
+			return true;
+		}
+	}
+
+	// Steal the oldest Task of the other queues
+	for (unsigned int i = 1; i < mQueues.size(); ++i) {
+		TaskQueue& queue = *mQueues[(queueIndex + i) % mQueues.size()];
+		std::lock_guard<std::mutex> lock(queue.mMutex);
+		if (!queue.mTasks.empty()) {
+			task = std::move(queue.mTasks.front());
+			queue.mTasks.pop_front();
+			--mNumQueuedTasks;
+			mNumSteals.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+void JobSystem::execute(Task& task)
+{
+	try {
+		task.mJob();
+	}
+	catch (std::exception& e) {
+		Logger::writeLog(LogType::ERROR, std::string("Uncaught exception in a Job: ") + e.what());
+	}
+
+	Counter* counter = task.mCounter;
+	if (counter) {
+		// The Counter is decremented with its mutex locked, so the waiting
+		// threads can't destroy it until we have finished with it
+		std::vector<std::pair<Job, Counter*>> continuations;
+		{
+			std::lock_guard<std::mutex> lock(counter->mMutex);
+			if (--counter->mCount == 0) {
+				continuations.swap(counter->mContinuations);
+			}
+		}
+
+		// Submit the Jobs that were waiting for the Counter
+		for (auto& continuation : continuations) {
+			push({ std::move(continuation.first), continuation.second });
+		}
+	}
+}
+
+
+unsigned int JobSystem::getQueueIndex() const
+{
+	return (mCurrentJobSystem == this)? mCurrentQueueIndex : mWorkers.size();
+}
@@ -0,0 +1,186 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <condition_variable>
+
+/**
+ * Class JobSystem, it executes Jobs in a pool of worker threads.
+ * <br>Each worker has its own queue of Jobs, where it pushes and pops the
+ * Jobs that it submits from the back. When a worker runs out of Jobs it
+ * steals them from the front of the queues of the other workers. The
+ * threads that aren't workers submit their Jobs to a shared queue, and
+ * they also execute Jobs while they wait for a Counter.
+ * <br>The completion of the Jobs is tracked with Counters, that can also
+ * be used for running a Job after other Jobs have finished.
+ */
+class JobSystem
+{
+public:		// Nested types
+	typedef std::function<void()> Job;
+
+	/**
+	 * Class Counter, it holds the number of pending Jobs of a group of
+	 * Jobs and the Jobs that must run after all of them have finished
+	 */
+	class Counter
+	{
+	private:	// Attributes
+		friend class JobSystem;
+
+		/** The number of submitted Jobs that haven't finished yet */
+		std::atomic<unsigned int> mCount;
+
+		/** The mutex of mContinuations */
+		std::mutex mMutex;
+
+		/** The Jobs (and their Counters) that are waiting for the
+		 * Counter to reach zero */
+		std::vector<std::pair<Job, Counter*>> mContinuations;
+
+	public:		// Functions
+		/** Creates a new Counter */
+		Counter() : mCount(0) {};
+
+		/** Class destructor */
+		~Counter() {};
+
+		/** @return	true if all the Jobs of the Counter have finished,
+		 *			false otherwise
+		 * @note	JobSystem::wait must be used before destroying the
+		 *			Counter */
+		inline bool isDone() const { return mCount == 0; };
+	};
+
+private:	// Nested types
+	/** Struct Task, it holds a Job and the Counter that must be
+	 * decremented when it finishes */
+	struct Task
+	{
+		Job mJob;
+		Counter* mCounter;
+	};
+
+	/** Struct TaskQueue, it holds the Tasks of a thread */
+	struct TaskQueue
+	{
+		std::mutex mMutex;
+		std::deque<Task> mTasks;
+	};
+
+private:	// Attributes
+	/** The JobSystem and the index of the TaskQueue of the current
+	 * thread, if it's a worker */
+	static thread_local JobSystem* mCurrentJobSystem;
+	static thread_local unsigned int mCurrentQueueIndex;
+
+	/** The worker threads */
+	std::vector<std::thread> mWorkers;
+
+	/** The TaskQueues of each worker, the last one is shared by all the
+	 * threads that aren't workers */
+	std::vector<std::unique_ptr<TaskQueue>> mQueues;
+
+	/** The number of Tasks in all the TaskQueues */
+	std::atomic<unsigned int> mNumQueuedTasks;
+
+	/** The number of Tasks stolen from the TaskQueues of other threads */
+	std::atomic<unsigned int> mNumSteals;
+
+	/** If the workers must stop or not */
+	bool mStop;
+
+	/** The mutex and the condition variable used for waking up the idle
+	 * workers */
+	std::mutex mWakeMutex;
+	std::condition_variable mWakeCondition;
+
+public:		// Functions
+	/** Creates a new JobSystem and launches its worker threads
+	 *
+	 * @param	numWorkers the number of worker threads, if it's 0 there
+	 *			will be one worker for each hardware thread except for the
+	 *			current one */
+	JobSystem(unsigned int numWorkers = 0);
+
+	/** Class destructor, it waits until all the queued Jobs have
+	 * finished */
+	~JobSystem();
+
+	/** @return	the number of worker threads */
+	inline unsigned int getNumWorkers() const { return mWorkers.size(); };
+
+	/** @return	the number of Jobs that have been stolen from the queue
+	 *			of other thread since the JobSystem was created */
+	inline unsigned int getNumSteals() const { return mNumSteals; };
+
+	/** Submits the given Job for its execution
+	 *
+	 * @param	job the Job to execute
+	 * @param	counter a pointer to the Counter that will track the
+	 *			completion of the Job, it can be nullptr */
+	void run(const Job& job, Counter* counter = nullptr);
+
+	/** Submits the given Job for its execution after all the Jobs of the
+	 * dependency Counter have finished
+	 *
+	 * @param	dependency the Counter of the Jobs that must finish first
+	 * @param	job the Job to execute
+	 * @param	counter a pointer to the Counter that will track the
+	 *			completion of the Job, it can be nullptr */
+	void runAfter(Counter& dependency, const Job& job, Counter* counter = nullptr);
+
+	/** Waits until all the Jobs of the given Counter have finished. The
+	 * current thread executes other Jobs meanwhile
+	 *
+	 * @param	counter the Counter to wait for */
+	void wait(Counter& counter);
+
+	/** Calls the given function for all the ranges of grainSize indices
+	 * in [begin, end) in parallel, and waits until all of them have
+	 * finished
+	 *
+	 * @param	begin the first index
+	 * @param	end the index after the last one
+	 * @param	grainSize the maximum number of indices of each range
+	 * @param	function the function to call with the first index and the
+	 *			index after the last one of each range */
+	void parallelFor(
+		unsigned int begin, unsigned int end, unsigned int grainSize,
+		const std::function<void(unsigned int, unsigned int)>& function
+	);
+private:
+	/** The main loop of the worker threads
+	 *
+	 * @param	queueIndex the index of the TaskQueue of the worker */
+	void workerLoop(unsigned int queueIndex);
+
+	/** Pushes the given Task to the TaskQueue of the current thread and
+	 * wakes up an idle worker
+	 *
+	 * @param	task the Task to push */
+	void push(Task task);
+
+	/** Pops a Task from the TaskQueue of the current thread, or steals it
+	 * from other TaskQueue if it's empty
+	 *
+	 * @param	task where the Task will be stored
+	 * @return	true if a Task was found, false otherwise */
+	bool pop(Task& task);
+
+	/** Executes the given Task and updates its Counter
+	 *
+	 * @param	task the Task to execute */
+	void execute(Task& task);
+
+	/** @return	the index of the TaskQueue of the current thread */
+	unsigned int getQueueIndex() const;
+};
+
+#endif		// JOB_SYSTEM_H
@@ -0,0 +1,91 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+	#define NOMINMAX
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+// Public functions
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) :
+	mPath(path), mData(nullptr), mSize(0),
+	mFileHandle(INVALID_HANDLE_VALUE), mMappingHandle(nullptr)
+{
+	mFileHandle = CreateFileA(
+		path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr
+	);
+	if (mFileHandle == INVALID_HANDLE_VALUE) {
+		return;
+	}
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(mFileHandle, &size) || (size.QuadPart == 0)) {
+		return;
+	}
+
+	mMappingHandle = CreateFileMappingA(mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!mMappingHandle) {
+		return;
+	}
+
+	void* data = MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (data) {
+		mData = static_cast<const unsigned char*>(data);
+		mSize = static_cast<std::size_t>(size.QuadPart);
+	}
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (mData) {
+		UnmapViewOfFile(mData);
+	}
+	if (mMappingHandle) {
+		CloseHandle(mMappingHandle);
+	}
+	if (mFileHandle != INVALID_HANDLE_VALUE) {
+		CloseHandle(mFileHandle);
+	}
+}
+#else
+MappedFile::MappedFile(const std::string& path) :
+	mPath(path), mData(nullptr), mSize(0)
+{
+	int fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0) {
+		return;
+	}
+
+	struct stat status;
+	if ((fstat(fileDescriptor, &status) == 0) && (status.st_size > 0)) {
+		void* data = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+		if (data != MAP_FAILED) {
+			// The file is read once from start to end, so the OS can start
+			// reading it ahead of the accesses
+			madvise(data, status.st_size, MADV_SEQUENTIAL);
+			madvise(data, status.st_size, MADV_WILLNEED);
+
+			mData = static_cast<const unsigned char*>(data);
+			mSize = static_cast<std::size_t>(status.st_size);
+		}
+	}
+
+	// The mapping keeps its own reference to the file
+	close(fileDescriptor);
+}
+
+
+MappedFile::~MappedFile()
+{
+	if (mData) {
+		munmap(const_cast<unsigned char*>(mData), mSize);
+	}
+}
+#endif
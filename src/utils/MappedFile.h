@@ -0,0 +1,64 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+/**
+ * Class MappedFile, it maps the whole content of a file in read only mode
+ * to the address space of the process, so it can be read without copying
+ * it to intermediate buffers. The pages are loaded by the OS when they are
+ * accessed, and the file is unmapped when the MappedFile is destroyed
+ */
+class MappedFile
+{
+private:	// Attributes
+	/** The path of the mapped file */
+	std::string mPath;
+
+	/** A pointer to the first byte of the mapped file, nullptr if the
+	 * file couldn't be mapped */
+	const unsigned char* mData;
+
+	/** The size in bytes of the mapped file */
+	std::size_t mSize;
+
+#ifdef _WIN32
+	/** The handles of the file and of its mapping */
+	void* mFileHandle;
+	void* mMappingHandle;
+#endif
+
+public:		// Functions
+	/** Creates a new MappedFile
+	 *
+	 * @param	path the path of the file to map, isOpen will return
+	 *			false if it can't be mapped */
+	MappedFile(const std::string& path);
+
+	/** Class destructor, it unmaps the file */
+	~MappedFile();
+
+	/** @return	the path of the mapped file */
+	inline std::string getPath() const { return mPath; };
+
+	/** @return	true if the file was mapped succesfully, false
+	 *			otherwise */
+	inline bool isOpen() const { return mData != nullptr; };
+
+	/** @return	a pointer to the content of the file */
+	inline const unsigned char* getData() const { return mData; };
+
+	/** @return	the size in bytes of the file */
+	inline std::size_t getSize() const { return mSize; };
+private:
+	/** Constructor-Copy object, it's private for preventing mapping the
+	 * file twice */
+	MappedFile(const MappedFile&);
+
+	/** Assignment operator, it's private for preventing mapping the file
+	 * twice */
+	MappedFile& operator=(const MappedFile&);
+};
+
+#endif		// MAPPED_FILE_H
@@ -0,0 +1,253 @@
+#ifndef RESOURCE_CACHE_H
+#define RESOURCE_CACHE_H
+
+#include <list>
+#include <memory>
+#include <string>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+
+/**
+ * Struct ResourceSize, it holds the memory used by one or more resources
+ */
+struct ResourceSize
+{
+	/** The number of bytes used in the CPU memory */
+	std::size_t mCPUBytes;
+
+	/** The number of bytes used in the GPU memory */
+	std::size_t mGPUBytes;
+
+	/** @return	the number of bytes used in both memories */
+	inline std::size_t getTotalBytes() const
+	{ return mCPUBytes + mGPUBytes; };
+};
+
+
+/**
+ * Class ResourceCache, it holds the resources of type T indexed by a key,
+ * like the path of their file or a hash of their content, so the same
+ * resource isn't loaded twice.
+ * <br>The resources are kept in least recently used order. When the
+ * memory used by the resources exceeds the budget of the cache, the least
+ * recently used ones that aren't referenced outside of the cache are
+ * evicted. The resources that are still referenced are never evicted, so
+ * the budget can be exceeded while they are in use.
+ * <br>It isn't thread safe, it must be used from a single thread
+ */
+template <typename T>
+class ResourceCache
+{
+public:		// Nested types
+	typedef std::shared_ptr<T> TSPtr;
+
+	/** The function used for calculating the memory used by a
+	 * resource */
+	typedef std::function<ResourceSize(const T&)> SizeFunction;
+
+private:	// Nested types
+	/** Struct Entry, it holds a resource of the cache */
+	struct Entry
+	{
+		/** The resource */
+		TSPtr mResource;
+
+		/** The memory used by the resource the last time it was
+		 * measured */
+		ResourceSize mSize;
+
+		/** The position of the key of the Entry in mLRUKeys */
+		std::list<std::string>::iterator mLRUPosition;
+	};
+
+private:	// Attributes
+	/** The function used for calculating the memory used by the
+	 * resources */
+	SizeFunction mSizeFunction;
+
+	/** The maximum number of bytes of the resources */
+	std::size_t mBudget;
+
+	/** The Entries of the resources indexed by their keys */
+	std::unordered_map<std::string, Entry> mEntries;
+
+	/** The keys of the resources from the most recently used to the least
+	 * recently used one */
+	std::list<std::string> mLRUKeys;
+
+	/** The memory used by all the resources */
+	ResourceSize mSize;
+
+	/** The number of evicted resources */
+	unsigned int mNumEvicted;
+
+public:		// Functions
+	/** Creates a new ResourceCache
+	 *
+	 * @param	sizeFunction the function used for calculating the memory
+	 *			used by each resource
+	 * @param	budget the maximum number of bytes of the resources */
+	ResourceCache(SizeFunction sizeFunction, std::size_t budget) :
+		mSizeFunction(std::move(sizeFunction)), mBudget(budget),
+		mSize{ 0, 0 }, mNumEvicted(0) {};
+
+	/** Class destructor */
+	~ResourceCache() {};
+
+	/** @return	the maximum number of bytes of the resources */
+	inline std::size_t getBudget() const { return mBudget; };
+
+	/** Sets the maximum number of bytes of the resources, it's applied
+	 * in the next update
+	 *
+	 * @param	budget the new budget */
+	inline void setBudget(std::size_t budget) { mBudget = budget; };
+
+	/** @return	the memory used by all the resources, measured in the
+	 *			last update or add */
+	inline ResourceSize getSize() const { return mSize; };
+
+	/** @return	the number of resources in the cache */
+	inline unsigned int getNumResources() const { return mEntries.size(); };
+
+	/** @return	the number of resources evicted since the cache was
+	 *			created */
+	inline unsigned int getNumEvicted() const { return mNumEvicted; };
+
+	/** Returns the resource with the given key and marks it as the most
+	 * recently used one
+	 *
+	 * @param	key the key of the resource
+	 * @return	the resource, nullptr if it isn't in the cache */
+	TSPtr get(const std::string& key);
+
+	/** Returns the resource with the given key, loading it with the given
+	 * function if it isn't in the cache yet
+	 *
+	 * @param	key the key of the resource
+	 * @param	load the function used for loading the resource, it
+	 *			must return a TSPtr, or nullptr if it can't be loaded
+	 * @return	the resource, nullptr if it couldn't be loaded */
+	template <typename F>
+	TSPtr getOrLoad(const std::string& key, F load);
+
+	/** Adds the given resource to the cache as the most recently used
+	 * one, replacing the one with the same key
+	 *
+	 * @param	key the key of the resource
+	 * @param	resource the resource to add */
+	void add(const std::string& key, TSPtr resource);
+
+	/** Measures again the memory used by the resources, and evicts the
+	 * least recently used unreferenced ones while the budget is
+	 * exceeded */
+	void update();
+
+	/** Removes all the unreferenced resources */
+	void clear();
+};
+
+
+// Template function definitions
+template <typename T>
+typename ResourceCache<T>::TSPtr ResourceCache<T>::get(const std::string& key)
+{
+	auto itEntry = mEntries.find(key);
+	if (itEntry == mEntries.end()) {
+		return nullptr;
+	}
+
+	mLRUKeys.splice(mLRUKeys.begin(), mLRUKeys, itEntry->second.mLRUPosition);
+	return itEntry->second.mResource;
+}
+
+
+template <typename T>
+template <typename F>
+typename ResourceCache<T>::TSPtr ResourceCache<T>::getOrLoad(const std::string& key, F load)
+{
+	TSPtr resource = get(key);
+	if (!resource) {
+		resource = load();
+		if (resource) {
+			add(key, resource);
+		}
+	}
+
+	return resource;
+}
+
+
+template <typename T>
+void ResourceCache<T>::add(const std::string& key, TSPtr resource)
+{
+	auto itEntry = mEntries.find(key);
+	if (itEntry == mEntries.end()) {
+		mLRUKeys.push_front(key);
+		itEntry = mEntries.emplace(key, Entry{ nullptr, { 0, 0 }, mLRUKeys.begin() }).first;
+	}
+	else {
+		mLRUKeys.splice(mLRUKeys.begin(), mLRUKeys, itEntry->second.mLRUPosition);
+	}
+
+	Entry& entry = itEntry->second;
+	mSize.mCPUBytes -= entry.mSize.mCPUBytes;
+	mSize.mGPUBytes -= entry.mSize.mGPUBytes;
+
+	entry.mResource = std::move(resource);
+	entry.mSize = mSizeFunction(*entry.mResource);
+	mSize.mCPUBytes += entry.mSize.mCPUBytes;
+	mSize.mGPUBytes += entry.mSize.mGPUBytes;
+}
+
+
+template <typename T>
+void ResourceCache<T>::update()
+{
+	// The resources can change their size, like the Textures that are
+	// still loading
+	mSize = { 0, 0 };
+	for (auto& pair : mEntries) {
+		Entry& entry = pair.second;
+		entry.mSize = mSizeFunction(*entry.mResource);
+		mSize.mCPUBytes += entry.mSize.mCPUBytes;
+		mSize.mGPUBytes += entry.mSize.mGPUBytes;
+	}
+
+	// Evict from the least recently used resource
+	auto itKey = mLRUKeys.end();
+	while ((mSize.getTotalBytes() > mBudget) && (itKey != mLRUKeys.begin())) {
+		--itKey;
+
+		auto itEntry = mEntries.find(*itKey);
+		if (itEntry->second.mResource.use_count() == 1) {
+			mSize.mCPUBytes -= itEntry->second.mSize.mCPUBytes;
+			mSize.mGPUBytes -= itEntry->second.mSize.mGPUBytes;
+			mEntries.erase(itEntry);
+			itKey = mLRUKeys.erase(itKey);
+			++mNumEvicted;
+		}
+	}
+}
+
+
+template <typename T>
+void ResourceCache<T>::clear()
+{
+	for (auto itKey = mLRUKeys.begin(); itKey != mLRUKeys.end();) {
+		auto itEntry = mEntries.find(*itKey);
+		if (itEntry->second.mResource.use_count() == 1) {
+			mSize.mCPUBytes -= itEntry->second.mSize.mCPUBytes;
+			mSize.mGPUBytes -= itEntry->second.mSize.mGPUBytes;
+			mEntries.erase(itEntry);
+			itKey = mLRUKeys.erase(itKey);
+			++mNumEvicted;
+		}
+		else {
+			++itKey;
+		}
+	}
+}
+
+#endif		// RESOURCE_CACHE_H
@@ -0,0 +1,209 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include "../src/loaders/MeshOptimizer.h"
+
+using namespace graphics;
+
+/**
+ * Tests of the MeshOptimizer, they don't need a GL context. The Mesh is
+ * a wavy grid of GRID_SIZE x GRID_SIZE vertices whose triangles are
+ * shuffled, so the vertex cache has something to improve.
+ * The process returns the number of failed checks.
+ */
+namespace {
+
+	/** The number of vertices of each side of the grid */
+	const unsigned int GRID_SIZE = 64;
+
+	/** A triangle rotated so its smallest index is the first one, so the
+	 * triangles can be compared without changing their winding */
+	typedef std::vector<unsigned int> Triangle;
+
+	/** The number of failed checks */
+	unsigned int gNumFailures = 0;
+
+
+	/** Prints the result of a check and counts it if it failed */
+	void check(bool passed, const char* name)
+	{
+		std::printf("%s %s\n", passed? "[PASS]" : "[FAIL]", name);
+		if (!passed) {
+			++gNumFailures;
+		}
+	}
+
+
+	/** Creates the positions of the vertices of the grid */
+	std::vector<GLfloat> createPositions()
+	{
+		std::vector<GLfloat> positions;
+		for (unsigned int z = 0; z < GRID_SIZE; ++z) {
+			for (unsigned int x = 0; x < GRID_SIZE; ++x) {
+				positions.push_back(static_cast<float>(x));
+				positions.push_back(std::sin(0.3f * x) * std::cos(0.2f * z));
+				positions.push_back(static_cast<float>(z));
+			}
+		}
+
+		return positions;
+	}
+
+
+	/** Creates the indices of the grid with its triangles in a fixed
+	 * pseudo random order */
+	std::vector<GLushort> createIndices()
+	{
+		std::vector<GLushort> indices;
+		for (unsigned int z = 0; z + 1 < GRID_SIZE; ++z) {
+			for (unsigned int x = 0; x + 1 < GRID_SIZE; ++x) {
+				GLushort i0 = z * GRID_SIZE + x, i1 = i0 + 1, i2 = i0 + GRID_SIZE, i3 = i2 + 1;
+				indices.insert(indices.end(), { i0, i2, i1, i1, i2, i3 });
+			}
+		}
+
+		// Fisher-Yates shuffle of the triangles with a LCG
+		unsigned int seed = 12345;
+		for (unsigned int i = indices.size() / 3 - 1; i > 0; --i) {
+			seed = seed * 1664525u + 1013904223u;
+			unsigned int j = (seed >> 8) % (i + 1);
+			for (unsigned int k = 0; k < 3; ++k) {
+				std::swap(indices[3*i + k], indices[3*j + k]);
+			}
+		}
+
+		return indices;
+	}
+
+
+	/** Returns the sorted triangles of the given indices, with the
+	 * indices translated with the given vertex ids */
+	std::vector<Triangle> getTriangles(
+		const std::vector<GLushort>& indices,
+		const std::vector<unsigned int>& vertexIds
+	) {
+		std::vector<Triangle> triangles;
+		for (unsigned int i = 0; i + 2 < indices.size(); i += 3) {
+			Triangle triangle = { vertexIds[indices[i]], vertexIds[indices[i+1]], vertexIds[indices[i+2]] };
+			std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+			triangles.push_back(triangle);
+		}
+		std::sort(triangles.begin(), triangles.end());
+
+		return triangles;
+	}
+
+
+	/** @return	the identity vertex ids of the grid */
+	std::vector<unsigned int> getIdentityIds()
+	{
+		std::vector<unsigned int> vertexIds(GRID_SIZE * GRID_SIZE);
+		for (unsigned int i = 0; i < vertexIds.size(); ++i) {
+			vertexIds[i] = i;
+		}
+
+		return vertexIds;
+	}
+
+
+	/** Checks that optimizeVertexCache lowers the ACMR of the grid */
+	void testVertexCache()
+	{
+		const MeshOptimizer optimizer;
+		const unsigned int numVertices = GRID_SIZE * GRID_SIZE;
+		std::vector<GLushort> indices = createIndices();
+
+		MeshOptimizer::Statistics before = optimizer.analyzeVertexCache(indices, numVertices);
+		std::vector<GLushort> optimized = optimizer.optimizeVertexCache(indices, numVertices);
+		MeshOptimizer::Statistics after = optimizer.analyzeVertexCache(optimized, numVertices);
+		std::printf("ACMR %f -> %f, ATVR %f -> %f\n", before.mACMR, after.mACMR, before.mATVR, after.mATVR);
+
+		check(optimized.size() == indices.size(), "optimizeVertexCache keeps the number of indices");
+		check(after.mACMR < 0.8f * before.mACMR, "optimizeVertexCache lowers the ACMR");
+		check(
+			getTriangles(optimized, getIdentityIds()) == getTriangles(indices, getIdentityIds()),
+			"optimizeVertexCache keeps the triangles"
+		);
+	}
+
+
+	/** Checks that optimizeVertexFetch and remapVertices keep the same
+	 * triangles, comparing them by the ids stored in the vertices */
+	void testVertexFetch()
+	{
+		const MeshOptimizer optimizer;
+		const unsigned int numVertices = GRID_SIZE * GRID_SIZE;
+		std::vector<GLushort> original = createIndices();
+		std::vector<GLushort> indices = optimizer.optimizeVertexCache(original, numVertices);
+		std::vector<GLushort> optimized = indices;
+
+		// Each vertex stores its original index followed by some padding
+		const unsigned int stride = 12;
+		std::vector<GLubyte> vertices(stride * numVertices, 0);
+		for (unsigned int i = 0; i < numVertices; ++i) {
+			std::memcpy(&vertices[stride * i], &i, sizeof(unsigned int));
+		}
+
+		std::vector<unsigned int> remap = optimizer.optimizeVertexFetch(optimized, numVertices);
+		MeshOptimizer::remapVertices(vertices, stride, remap);
+
+		std::vector<unsigned int> vertexIds(numVertices);
+		for (unsigned int i = 0; i < numVertices; ++i) {
+			std::memcpy(&vertexIds[i], &vertices[stride * i], sizeof(unsigned int));
+		}
+
+		bool sequential = true;
+		for (unsigned int i = 0, next = 0; i < optimized.size(); ++i) {
+			if (optimized[i] > next) {
+				sequential = false;
+			}
+			else if (optimized[i] == next) {
+				++next;
+			}
+		}
+
+		check(vertices.size() == stride * numVertices, "remapVertices keeps the number of vertices");
+		check(sequential, "optimizeVertexFetch orders the vertices by their first use");
+		check(
+			getTriangles(optimized, vertexIds) == getTriangles(indices, getIdentityIds()),
+			"optimizeVertexFetch and remapVertices keep the triangles"
+		);
+	}
+
+
+	/** Checks that optimizeOverdraw keeps every triangle exactly once */
+	void testOverdraw()
+	{
+		const MeshOptimizer optimizer;
+		const unsigned int numVertices = GRID_SIZE * GRID_SIZE;
+		std::vector<GLfloat> positions = createPositions();
+		std::vector<GLushort> indices = optimizer.optimizeVertexCache(createIndices(), numVertices);
+
+		std::vector<GLushort> optimized = optimizer.optimizeOverdraw(indices, positions);
+		std::vector<Triangle> triangles = getTriangles(optimized, getIdentityIds());
+
+		check(optimized.size() == indices.size(), "optimizeOverdraw keeps the number of indices");
+		check(
+			std::adjacent_find(triangles.begin(), triangles.end()) == triangles.end(),
+			"optimizeOverdraw doesn't repeat any triangle"
+		);
+		check(
+			triangles == getTriangles(indices, getIdentityIds()),
+			"optimizeOverdraw keeps the triangles"
+		);
+	}
+
+}
+
+
+int main()
+{
+	testVertexCache();
+	testVertexFetch();
+	testOverdraw();
+
+	std::printf("\n%u checks failed\n", gNumFailures);
+	return gNumFailures;
+}